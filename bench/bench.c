@@ -0,0 +1,212 @@
+/**
+ * @file bench.c
+ * @brief Headless micro benchmarks for the FreeRTOS POSIX port
+ *
+ * Runs the selected benchmark suites, or all of them when none are named on
+ * the command line, and prints one CSV line per result, or one JSON object per
+ * line after BENCH_JSON_ARG.
+ *
+ * @verbatim
+ ----------------------------------------------------------------------
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ----------------------------------------------------------------------
+ @endverbatim
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "task.h"
+
+#include "bench.h"
+
+static const bench_suite_t bench_suites[] = {
+    { "switch", benchSwitch },
+    { "tick", benchTick },
+    { "idle", benchIdle },
+    { "timebase", benchTimebase },
+    { "runtime", benchRuntime },
+    { "startup", benchStartup },
+    { "lifecycle", benchLifecycle },
+    { "stack", benchStack },
+    { "smp", benchSmp },
+    { "irq", benchIrq },
+    { "sync", benchSync },
+    { "qstats", benchQstats },
+    { "queue", benchQueue },
+    { "stream", benchStream },
+    { "timer", benchTimer },
+    { "delay", benchDelay },
+    { "heap", benchHeap },
+};
+
+#define BENCH_SUITE_COUNT (sizeof(bench_suites) / sizeof(bench_suites[0]))
+#define BENCH_MAX_WORKERS 4096
+
+static int bench_argc;
+static char **bench_argv;
+static int bench_json = 0;
+static SemaphoreHandle_t bench_done = NULL;
+
+uint64_t benchNow(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+void benchReport(const char *suite, const char *metric, double value,
+                 const char *unit)
+{
+    if (bench_json) {
+        printf("{\"suite\":\"%s\",\"metric\":\"%s\",\"value\":%.3f,"
+               "\"unit\":\"%s\"}\n", suite, metric, value, unit);
+    }
+    else {
+        printf("%s,%s,%.3f,%s\n", suite, metric, value, unit);
+    }
+    fflush(stdout);
+}
+
+static int benchCompareSamples(const void *a, const void *b)
+{
+    uint64_t la = *(const uint64_t *)a, lb = *(const uint64_t *)b;
+
+    return (la > lb) - (la < lb);
+}
+
+void benchReportDistribution(const char *suite, const char *metric,
+                             uint64_t *samples, unsigned int count,
+                             const char *unit)
+{
+    uint64_t total = 0;
+    unsigned int i;
+    char name[64];
+
+    if (!count) {
+        return;
+    }
+
+    for (i = 0; i < count; i++) {
+        total += samples[i];
+    }
+    qsort(samples, count, sizeof(samples[0]), benchCompareSamples);
+
+    snprintf(name, sizeof(name), "%s_min", metric);
+    benchReport(suite, name, samples[0], unit);
+    snprintf(name, sizeof(name), "%s_avg", metric);
+    benchReport(suite, name, (double)total / count, unit);
+    snprintf(name, sizeof(name), "%s_p50", metric);
+    benchReport(suite, name, samples[count / 2], unit);
+    snprintf(name, sizeof(name), "%s_p99", metric);
+    benchReport(suite, name, samples[count * 99 / 100], unit);
+    snprintf(name, sizeof(name), "%s_max", metric);
+    benchReport(suite, name, samples[count - 1], unit);
+}
+
+void benchSignalDone(void)
+{
+    xSemaphoreGive(bench_done);
+}
+
+void benchWaitDone(unsigned int count)
+{
+    while (count--) {
+        xSemaphoreTake(bench_done, portMAX_DELAY);
+    }
+}
+
+static int benchSelected(const char *name)
+{
+    int i;
+
+    if (bench_argc < 2) {
+        return 1;
+    }
+
+    for (i = 1; i < bench_argc; i++)
+        if (!strcmp(bench_argv[i], name)) {
+            return 1;
+        }
+
+    return 0;
+}
+
+static void vBenchController(void *pvParameters)
+{
+    unsigned int i;
+
+    if (!bench_json) {
+        printf("suite,metric,value,unit\n");
+    }
+
+    for (i = 0; i < BENCH_SUITE_COUNT; i++)
+        if (benchSelected(bench_suites[i].name)) {
+            bench_suites[i].run();
+        }
+
+    fflush(stdout);
+    exit(EXIT_SUCCESS);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && !strcmp(argv[1], BENCH_STARTUP_ARG)) {
+        return benchStartupMain(argc, argv);
+    }
+
+    /* The remaining arguments name the suites, argv[0] is skipped */
+    if (argc > 1 && !strcmp(argv[1], BENCH_JSON_ARG)) {
+        bench_json = 1;
+        argc--;
+        argv++;
+    }
+
+    bench_argc = argc;
+    bench_argv = argv;
+
+    bench_done = xSemaphoreCreateCounting(BENCH_MAX_WORKERS, 0);
+    if (!bench_done) {
+        fprintf(stderr, "[ERROR] Could not create done semaphore\n");
+        return EXIT_FAILURE;
+    }
+    vQueueAddToRegistry(bench_done, "BenchDone");
+
+    if (xTaskCreate(vBenchController, "BenchCtrl", BENCH_STACK_SIZE, NULL,
+                    BENCH_CONTROLLER_PRIORITY, NULL) != pdPASS) {
+        fprintf(stderr, "[ERROR] Could not create controller task\n");
+        return EXIT_FAILURE;
+    }
+
+    vTaskStartScheduler();
+
+    return EXIT_FAILURE;
+}
+
+// cppcheck-suppress unusedFunction
+__attribute__((unused)) void vApplicationIdleHook(void)
+{
+}
+
+// cppcheck-suppress unusedFunction
+__attribute__((unused)) void vApplicationStackOverflowHook(TaskHandle_t xTask,
+        char *pcTaskName)
+{
+    fprintf(stderr, "[ERROR] Task %s overflowed its stack\n", pcTaskName);
+    exit(EXIT_FAILURE);
+}
@@ -0,0 +1,138 @@
+/**
+ * @file bench_delay.c
+ * @brief CPU time periodic tasks calling vTaskDelayUntil() take per period,
+ * with 10, 100 and 1000 of them delayed at once
+ *
+ * @verbatim
+ ----------------------------------------------------------------------
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ----------------------------------------------------------------------
+ @endverbatim
+ */
+
+#include <stdio.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "bench.h"
+
+/* Every task has the same period, so each new wake time is the latest of all
+ * and a sorted delayed list is walked to its end on every block */
+#define DELAY_PERIOD_TICKS 100
+#define DELAY_PERIODS 20
+#define DELAY_PRIORITY (tskIDLE_PRIORITY + 1)
+
+static const unsigned int delay_task_counts[] = { 10, 100, 1000 };
+#define DELAY_STEPS (sizeof(delay_task_counts) / sizeof(delay_task_counts[0]))
+
+static TickType_t delay_start;
+static uint64_t delay_cpu;
+static TickType_t delay_max_lateness;
+static unsigned int delay_early_wakes;
+
+/* CPU time the calling task has taken up to its last switch in */
+static uint64_t benchDelayTaskTime(void)
+{
+    TaskStatus_t status;
+
+    vTaskGetInfo(NULL, &status, pdFALSE, eRunning);
+    return status.ulRunTimeCounter;
+}
+
+/* Tasks start on DELAY_PERIOD_TICKS different phases, so about as many wake
+ * up on every tick */
+static void vDelayWorker(void *pvParameters)
+{
+    TickType_t last_wake = delay_start + (TickType_t)(uintptr_t)pvParameters -
+                           DELAY_PERIOD_TICKS;
+    TickType_t late, max_lateness = 0;
+    unsigned int period, early_wakes = 0;
+    uint64_t cpu_start;
+
+    /* The first period only brings the task to its phase */
+    vTaskDelayUntil(&last_wake, DELAY_PERIOD_TICKS);
+    cpu_start = benchDelayTaskTime();
+
+    for (period = 0; period < DELAY_PERIODS; period++) {
+        vTaskDelayUntil(&last_wake, DELAY_PERIOD_TICKS);
+
+        /* A task more than a period late does not block, one woken before
+         * its wake time wraps the difference */
+        late = xTaskGetTickCount() - last_wake;
+        if (late > portMAX_DELAY / 2) {
+            early_wakes++;
+        }
+        else if (late > max_lateness) {
+            max_lateness = late;
+        }
+    }
+
+    taskENTER_CRITICAL();
+    delay_cpu += benchDelayTaskTime() - cpu_start;
+    delay_early_wakes += early_wakes;
+    if (max_lateness > delay_max_lateness) {
+        delay_max_lateness = max_lateness;
+    }
+    taskEXIT_CRITICAL();
+
+    benchSignalDone();
+    vTaskDelete(NULL);
+}
+
+static void benchDelayTasks(unsigned int count)
+{
+    unsigned int created;
+    char metric[64];
+
+    delay_cpu = 0;
+    delay_max_lateness = 0;
+    delay_early_wakes = 0;
+
+    vTaskSuspendAll();
+    delay_start = xTaskGetTickCount() + 1;
+    for (created = 0; created < count; created++) {
+        if (xTaskCreate(vDelayWorker, "Delay", configMINIMAL_STACK_SIZE,
+                        (void *)(uintptr_t)(created % DELAY_PERIOD_TICKS),
+                        DELAY_PRIORITY, NULL) != pdPASS) {
+            break;
+        }
+    }
+    xTaskResumeAll();
+
+    benchWaitDone(created);
+
+    if (created < count) {
+        fprintf(stderr, "[ERROR] only %u of %u delay tasks created\n",
+                created, count);
+        return;
+    }
+    if (delay_early_wakes) {
+        fprintf(stderr, "[ERROR] %u delayed tasks woke up early\n",
+                delay_early_wakes);
+    }
+
+    snprintf(metric, sizeof(metric), "cpu_ns_per_period_%u_tasks", count);
+    benchReport("delay", metric,
+                (double)delay_cpu / (count * DELAY_PERIODS), "ns");
+    snprintf(metric, sizeof(metric), "max_lateness_%u_tasks", count);
+    benchReport("delay", metric, delay_max_lateness, "ticks");
+}
+
+void benchDelay(void)
+{
+    unsigned int step;
+
+    for (step = 0; step < DELAY_STEPS; step++) {
+        benchDelayTasks(delay_task_counts[step]);
+    }
+}
@@ -0,0 +1,203 @@
+/**
+ * @file bench_heap.c
+ * @brief Cost of pvPortMalloc() and vPortFree(), within one task and when
+ * blocks are freed by another task than the one that allocated them, and how
+ * fragmented the heap is left by blocks freed out of order
+ *
+ * @verbatim
+ ----------------------------------------------------------------------
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ----------------------------------------------------------------------
+ @endverbatim
+ */
+
+#include <stdio.h>
+
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "task.h"
+
+#include "bench.h"
+
+#define HEAP_PAIR_ITERATIONS 100000
+/* Fits configTOTAL_HEAP_SIZE, for the heaps that enforce it */
+#define HEAP_BURST_BLOCKS 100
+#define HEAP_BURST_SIZE 128
+#define HEAP_HANDOFF_ITEMS 20000
+#define HEAP_HANDOFF_SIZE 64
+#define HEAP_HANDOFF_LENGTH 16
+#define HEAP_FRAGMENT_BLOCKS 60
+
+#define HEAP_WORKER_PRIORITY (tskIDLE_PRIORITY + 1)
+
+/* Not every heap implementation provides these */
+extern size_t xPortGetFreeHeapSize(void) __attribute__((weak));
+extern size_t xPortGetMinimumEverFreeHeapSize(void) __attribute__((weak));
+extern size_t xPortGetHeapReservedSize(void) __attribute__((weak));
+extern void vPortGetHeapStats(HeapStats_t *pxHeapStats) __attribute__((weak));
+
+static const size_t heap_pair_sizes[] = { 32, 200, 4096 };
+#define HEAP_PAIR_STEPS (sizeof(heap_pair_sizes) / sizeof(heap_pair_sizes[0]))
+
+/* Mix of list items, queue storage and TCB sized blocks */
+static const size_t heap_fragment_sizes[] = { 24, 100, 300 };
+#define HEAP_FRAGMENT_STEPS \
+    (sizeof(heap_fragment_sizes) / sizeof(heap_fragment_sizes[0]))
+
+static void *heap_burst[HEAP_BURST_BLOCKS];
+static void *heap_fragment[HEAP_FRAGMENT_BLOCKS];
+static QueueHandle_t heap_handoff = NULL;
+
+/* Allocate and immediately free, the block is reused every time */
+static void benchHeapPairs(size_t size)
+{
+    uint64_t start, elapsed;
+    char metric[48];
+    void *block;
+    int i;
+
+    start = benchNow();
+    for (i = 0; i < HEAP_PAIR_ITERATIONS; i++) {
+        block = pvPortMalloc(size);
+        vPortFree(block);
+    }
+    elapsed = benchNow() - start;
+
+    snprintf(metric, sizeof(metric), "malloc_free_ns_%ub", (unsigned)size);
+    benchReport("heap", metric, (double)elapsed / HEAP_PAIR_ITERATIONS, "ns");
+}
+
+/* Many blocks live at once, as when a set of objects is created at start */
+static void benchHeapBurst(void)
+{
+    uint64_t start, elapsed;
+    int i;
+
+    start = benchNow();
+    for (i = 0; i < HEAP_BURST_BLOCKS; i++) {
+        heap_burst[i] = pvPortMalloc(HEAP_BURST_SIZE);
+    }
+    for (i = 0; i < HEAP_BURST_BLOCKS; i++) {
+        vPortFree(heap_burst[i]);
+    }
+    elapsed = benchNow() - start;
+
+    benchReport("heap", "burst_ns_per_block",
+                (double)elapsed / HEAP_BURST_BLOCKS, "ns");
+}
+
+static void vHeapProducer(void *pvParameters)
+{
+    void *block;
+    int i;
+
+    for (i = 0; i < HEAP_HANDOFF_ITEMS; i++) {
+        block = pvPortMalloc(HEAP_HANDOFF_SIZE);
+        xQueueSend(heap_handoff, &block, portMAX_DELAY);
+    }
+
+    benchSignalDone();
+    vTaskDelete(NULL);
+}
+
+static void vHeapConsumer(void *pvParameters)
+{
+    void *block;
+    int i;
+
+    for (i = 0; i < HEAP_HANDOFF_ITEMS; i++) {
+        xQueueReceive(heap_handoff, &block, portMAX_DELAY);
+        vPortFree(block);
+    }
+
+    benchSignalDone();
+    vTaskDelete(NULL);
+}
+
+/* Every block is freed by another task, as with messages passed by pointer */
+static void benchHeapHandoff(void)
+{
+    uint64_t start, elapsed;
+
+    heap_handoff = xQueueCreate(HEAP_HANDOFF_LENGTH, sizeof(void *));
+    if (heap_handoff == NULL) {
+        return;
+    }
+
+    vTaskSuspendAll();
+    xTaskCreate(vHeapConsumer, "HeapFree", BENCH_STACK_SIZE, NULL,
+                HEAP_WORKER_PRIORITY, NULL);
+    xTaskCreate(vHeapProducer, "HeapAlloc", BENCH_STACK_SIZE, NULL,
+                HEAP_WORKER_PRIORITY, NULL);
+    start = benchNow();
+    xTaskResumeAll();
+
+    benchWaitDone(2);
+    elapsed = benchNow() - start;
+
+    benchReport("heap", "handoff_blocks_per_s",
+                HEAP_HANDOFF_ITEMS * 1e9 / elapsed, "1/s");
+
+    vQueueDelete(heap_handoff);
+}
+
+/* Every other block of a mixed set is freed, as when objects with different
+ * lifetimes were created together, and the heap is asked for its free blocks */
+static void benchHeapFragmentation(void)
+{
+    HeapStats_t stats;
+    int i;
+
+    for (i = 0; i < HEAP_FRAGMENT_BLOCKS; i++) {
+        heap_fragment[i] =
+            pvPortMalloc(heap_fragment_sizes[i % HEAP_FRAGMENT_STEPS]);
+    }
+    for (i = 0; i < HEAP_FRAGMENT_BLOCKS; i += 2) {
+        vPortFree(heap_fragment[i]);
+    }
+
+    /* heap_6.c has no free list and reports no free blocks */
+    vPortGetHeapStats(&stats);
+    if (stats.xNumberOfFreeBlocks) {
+        benchReport("heap", "fragmented_free_blocks",
+                    stats.xNumberOfFreeBlocks, "count");
+        benchReport("heap", "fragmented_largest_free_bytes",
+                    stats.xSizeOfLargestFreeBlockInBytes, "B");
+    }
+
+    for (i = 1; i < HEAP_FRAGMENT_BLOCKS; i += 2) {
+        vPortFree(heap_fragment[i]);
+    }
+}
+
+void benchHeap(void)
+{
+    unsigned int step;
+
+    for (step = 0; step < HEAP_PAIR_STEPS; step++) {
+        benchHeapPairs(heap_pair_sizes[step]);
+    }
+    benchHeapBurst();
+    benchHeapHandoff();
+    if (vPortGetHeapStats) {
+        benchHeapFragmentation();
+    }
+
+    if (xPortGetFreeHeapSize && xPortGetMinimumEverFreeHeapSize) {
+        benchReport("heap", "free_bytes", xPortGetFreeHeapSize(), "B");
+        benchReport("heap", "minimum_ever_free_bytes",
+                    xPortGetMinimumEverFreeHeapSize(), "B");
+    }
+    if (xPortGetHeapReservedSize) {
+        benchReport("heap", "reserved_bytes", xPortGetHeapReservedSize(), "B");
+    }
+}
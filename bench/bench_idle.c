@@ -0,0 +1,93 @@
+/**
+ * @file bench_idle.c
+ * @brief Host CPU used while every task is blocked and the wake up latency
+ *
+ * @verbatim
+ ----------------------------------------------------------------------
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ----------------------------------------------------------------------
+ @endverbatim
+ */
+
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "bench.h"
+
+#define IDLE_MEASURE_MS 2000
+#define IDLE_WAKE_ITERATIONS 50
+#define IDLE_WAKE_DELAY_MS 20
+
+static uint64_t benchCpuTime(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+static void benchIdleCpu(void)
+{
+    uint64_t start, cpu_start, elapsed, cpu;
+
+    start = benchNow();
+    cpu_start = benchCpuTime();
+
+    vTaskDelay(pdMS_TO_TICKS(IDLE_MEASURE_MS));
+
+    cpu = benchCpuTime() - cpu_start;
+    elapsed = benchNow() - start;
+
+    benchReport("idle", "cpu_load", 100.0 * cpu / elapsed, "%");
+}
+
+/* Time from a delay's nominal expiry until the delayed task runs again */
+static void benchIdleWake(void)
+{
+    uint64_t start, late, late_min = UINT64_MAX, late_max = 0, late_total = 0;
+    const uint64_t nominal = (uint64_t)pdMS_TO_TICKS(IDLE_WAKE_DELAY_MS) *
+                             (1000000000ULL / configTICK_RATE_HZ);
+    int i;
+
+    for (i = 0; i < IDLE_WAKE_ITERATIONS; i++) {
+        /* Start right after a tick, so the delay ends on a tick boundary */
+        vTaskDelay(1);
+        start = benchNow();
+
+        vTaskDelay(pdMS_TO_TICKS(IDLE_WAKE_DELAY_MS));
+
+        late = benchNow() - start;
+        late = late > nominal ? late - nominal : 0;
+
+        late_total += late;
+        if (late < late_min) {
+            late_min = late;
+        }
+        if (late > late_max) {
+            late_max = late;
+        }
+    }
+
+    benchReport("idle", "wake_latency_min", late_min, "ns");
+    benchReport("idle", "wake_latency_avg",
+                (double)late_total / IDLE_WAKE_ITERATIONS, "ns");
+    benchReport("idle", "wake_latency_max", late_max, "ns");
+}
+
+void benchIdle(void)
+{
+    benchIdleCpu();
+    benchIdleWake();
+}
@@ -0,0 +1,165 @@
+/**
+ * @file bench_irq.c
+ * @brief Latency of the emulated interrupt lines, from a host thread raising
+ * one to the ISR and to the task it wakes
+ *
+ * @verbatim
+ ----------------------------------------------------------------------
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ----------------------------------------------------------------------
+ @endverbatim
+ */
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "bench.h"
+
+#define IRQ_ITERATIONS 2000
+#define IRQ_NESTED_ITERATIONS 200
+
+/* A device line that may use the FromISR API and a more urgent one that may
+ * not, which preempts it */
+#define IRQ_LINE_DEVICE 4
+#define IRQ_LINE_URGENT 5
+#define IRQ_PRIORITY_DEVICE (configMAX_SYSCALL_INTERRUPT_PRIORITY + 4)
+#define IRQ_PRIORITY_URGENT 0
+
+#define IRQ_WAITER_PRIORITY (tskIDLE_PRIORITY + 2)
+
+static TaskHandle_t irq_waiter = NULL;
+static volatile uint64_t irq_raised_at = 0;
+static volatile uint64_t irq_isr_at = 0;
+static volatile int irq_acked = 0;
+static volatile int irq_nest = 0;
+static volatile int irq_urgent_ran = 0;
+static volatile unsigned int irq_preempted = 0;
+static uint64_t isr_latencies[IRQ_ITERATIONS];
+static uint64_t task_latencies[IRQ_ITERATIONS];
+
+static void vUrgentIsr(void *pvParameter)
+{
+    (void)pvParameter;
+
+    irq_urgent_ran = 1;
+}
+
+static void vDeviceIsr(void *pvParameter)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    (void)pvParameter;
+
+    irq_isr_at = benchNow();
+
+    if (irq_nest) {
+        /* The urgent line runs before the raise returns */
+        irq_urgent_ran = 0;
+        xPortRaiseIrq(IRQ_LINE_URGENT);
+        if (irq_urgent_ran) {
+            irq_preempted++;
+        }
+    }
+
+    vTaskNotifyGiveFromISR(irq_waiter, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+static void vIrqWaiter(void *pvParameters)
+{
+    unsigned int iterations = (unsigned int)(uintptr_t)pvParameters;
+    unsigned int i;
+
+    for (i = 0; i < iterations; i++) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        task_latencies[i] = benchNow() - irq_raised_at;
+        isr_latencies[i] = irq_isr_at - irq_raised_at;
+        irq_acked = 1;
+    }
+
+    benchSignalDone();
+    vTaskDelete(NULL);
+}
+
+/* Stands in for a device, raises the next interrupt once the last is handled */
+static void *pvIrqRaiser(void *pvParameters)
+{
+    unsigned int iterations = (unsigned int)(uintptr_t)pvParameters;
+    unsigned int i;
+    sigset_t signals;
+
+    /* Leave the tick and the interrupts to the task threads */
+    sigfillset(&signals);
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+    for (i = 0; i < iterations; i++) {
+        while (!irq_acked) {
+            usleep(20);
+        }
+        irq_acked = 0;
+        irq_raised_at = benchNow();
+        xPortRaiseIrq(IRQ_LINE_DEVICE);
+    }
+
+    return NULL;
+}
+
+static int benchIrqRun(unsigned int iterations)
+{
+    pthread_t raiser;
+
+    irq_acked = 1;
+    xTaskCreate(vIrqWaiter, "IrqWait", BENCH_STACK_SIZE,
+                (void *)(uintptr_t)iterations, IRQ_WAITER_PRIORITY,
+                &irq_waiter);
+    if (pthread_create(&raiser, NULL, pvIrqRaiser,
+                       (void *)(uintptr_t)iterations)) {
+        return -1;
+    }
+
+    benchWaitDone(1);
+    pthread_join(raiser, NULL);
+    return 0;
+}
+
+void benchIrq(void)
+{
+    if (xPortInstallIrqHandler(IRQ_LINE_DEVICE, vDeviceIsr, NULL,
+                               IRQ_PRIORITY_DEVICE) != pdPASS ||
+        xPortInstallIrqHandler(IRQ_LINE_URGENT, vUrgentIsr, NULL,
+                               IRQ_PRIORITY_URGENT) != pdPASS) {
+        fprintf(stderr, "[ERROR] Could not install interrupt handlers\n");
+        return;
+    }
+
+    irq_nest = 0;
+    if (benchIrqRun(IRQ_ITERATIONS)) {
+        return;
+    }
+    benchReportDistribution("irq", "isr_latency", isr_latencies,
+                            IRQ_ITERATIONS, "ns");
+    benchReportDistribution("irq", "task_latency", task_latencies,
+                            IRQ_ITERATIONS, "ns");
+
+    irq_nest = 1;
+    irq_preempted = 0;
+    if (benchIrqRun(IRQ_NESTED_ITERATIONS)) {
+        return;
+    }
+    benchReport("irq", "nested_preemptions", irq_preempted, "count");
+    benchReport("irq", "nested_raised", IRQ_NESTED_ITERATIONS, "count");
+}
@@ -0,0 +1,89 @@
+/**
+ * @file bench_lifecycle.c
+ * @brief Cost of creating and deleting short lived tasks
+ *
+ * @verbatim
+ ----------------------------------------------------------------------
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ----------------------------------------------------------------------
+ @endverbatim
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "bench.h"
+
+#define LIFECYCLE_ITERATIONS 2000
+
+#define LIFECYCLE_WORKER_PRIORITY (tskIDLE_PRIORITY + 1)
+
+static void vIdleWorker(void *pvParameters)
+{
+    /* Deleted before it ever gets to run */
+    for (;;) {
+        vTaskSuspend(NULL);
+    }
+}
+
+static void vShortWorker(void *pvParameters)
+{
+    benchSignalDone();
+    vTaskSuspend(NULL);
+}
+
+/* Created and deleted again by the controller without ever running */
+static void benchLifecycleCreateDelete(void)
+{
+    TaskHandle_t worker;
+    uint64_t start;
+    int i;
+
+    start = benchNow();
+    for (i = 0; i < LIFECYCLE_ITERATIONS; i++) {
+        if (xTaskCreate(vIdleWorker, "Worker", configMINIMAL_STACK_SIZE,
+                        NULL, LIFECYCLE_WORKER_PRIORITY, &worker) != pdPASS) {
+            return;
+        }
+        vTaskDelete(worker);
+    }
+
+    benchReport("lifecycle", "create_delete_ns",
+                (double)(benchNow() - start) / LIFECYCLE_ITERATIONS, "ns");
+}
+
+/* Runs once before the controller deletes it */
+static void benchLifecycleCreateRunDelete(void)
+{
+    TaskHandle_t worker;
+    uint64_t start;
+    int i;
+
+    start = benchNow();
+    for (i = 0; i < LIFECYCLE_ITERATIONS; i++) {
+        if (xTaskCreate(vShortWorker, "Worker", configMINIMAL_STACK_SIZE,
+                        NULL, LIFECYCLE_WORKER_PRIORITY, &worker) != pdPASS) {
+            return;
+        }
+        benchWaitDone(1);
+        vTaskDelete(worker);
+    }
+
+    benchReport("lifecycle", "create_run_delete_ns",
+                (double)(benchNow() - start) / LIFECYCLE_ITERATIONS, "ns");
+}
+
+void benchLifecycle(void)
+{
+    benchLifecycleCreateDelete();
+    benchLifecycleCreateRunDelete();
+}
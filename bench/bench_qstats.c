@@ -0,0 +1,154 @@
+/**
+ * @file bench_qstats.c
+ * @brief Statistics collected for a mutex a higher priority task keeps
+ * waiting on, and what formatting them costs
+ *
+ * @verbatim
+ ----------------------------------------------------------------------
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ----------------------------------------------------------------------
+ @endverbatim
+ */
+
+#include <stdio.h>
+
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "semphr.h"
+#include "task.h"
+
+#include "bench.h"
+
+#define QSTATS_ROUNDS 50
+#define QSTATS_HOLD_TICKS 2
+#define QSTATS_LIST_ITERATIONS 1000
+
+#define QSTATS_HOLDER_PRIORITY (tskIDLE_PRIORITY + 1)
+#define QSTATS_WAITER_PRIORITY (tskIDLE_PRIORITY + 2)
+
+static SemaphoreHandle_t qstats_mutex = NULL;
+static SemaphoreHandle_t qstats_held = NULL;
+
+/* Holds the mutex for a few ticks every round, long enough for the waiter to
+ * block on it and lend its priority */
+static void vQstatsHolder(void *pvParameters)
+{
+    int i;
+
+    for (i = 0; i < QSTATS_ROUNDS; i++) {
+        xSemaphoreTake(qstats_mutex, portMAX_DELAY);
+        xSemaphoreGive(qstats_held);
+        vTaskDelay(QSTATS_HOLD_TICKS);
+        xSemaphoreGive(qstats_mutex);
+    }
+
+    benchSignalDone();
+    vTaskDelete(NULL);
+}
+
+static void vQstatsWaiter(void *pvParameters)
+{
+    int i;
+
+    for (i = 0; i < QSTATS_ROUNDS; i++) {
+        xSemaphoreTake(qstats_held, portMAX_DELAY);
+        xSemaphoreTake(qstats_mutex, portMAX_DELAY);
+        xSemaphoreGive(qstats_mutex);
+    }
+
+    benchSignalDone();
+    vTaskDelete(NULL);
+}
+
+#if (configUSE_QUEUE_STATS == 1)
+static void benchQstatsReport(void)
+{
+    static char list[4096];
+    QueueStats_t stats;
+    uint64_t start, elapsed;
+    unsigned int bucket, ended = 0, median = 0, seen = 0;
+    int i;
+
+    if (xQueueGetStats(qstats_mutex, &stats) != pdPASS) {
+        fprintf(stderr, "[ERROR] no statistics for the contended mutex\n");
+        return;
+    }
+
+    for (bucket = 0; bucket < queueSTATS_HISTOGRAM_BUCKETS; bucket++) {
+        ended += stats.ulBlockedHistogram[bucket];
+    }
+    for (bucket = 0; bucket < queueSTATS_HISTOGRAM_BUCKETS; bucket++) {
+        seen += stats.ulBlockedHistogram[bucket];
+        if (seen * 2 >= ended) {
+            median = bucket;
+            break;
+        }
+    }
+
+    benchReport("qstats", "mutex_waits", stats.ulWaits, "waits");
+    benchReport("qstats", "mutex_inherits", stats.ulPriorityInherits,
+                "waits");
+    benchReport("qstats", "mutex_disinherits", stats.ulPriorityDisinherits,
+                "gives");
+    benchReport("qstats", "mutex_wait_avg",
+                ended ? (double)stats.ullBlockedTime / ended / 1000 : 0,
+                "us");
+    benchReport("qstats", "mutex_wait_max",
+                (double)stats.ullMaxBlockedTime / 1000, "us");
+    /* The histogram only bounds the median by a power of two */
+    benchReport("qstats", "mutex_wait_p50_bound", 1U << (median + 1),
+                "us");
+
+    start = benchNow();
+    for (i = 0; i < QSTATS_LIST_ITERATIONS; i++) {
+        vQueueGetStatsList(list, sizeof(list));
+    }
+    elapsed = benchNow() - start;
+
+    benchReport("qstats", "list_ns", (double)elapsed / QSTATS_LIST_ITERATIONS,
+                "ns");
+}
+#endif
+
+void benchQstats(void)
+{
+    uint64_t start, elapsed;
+
+    qstats_mutex = xSemaphoreCreateMutex();
+    qstats_held = xSemaphoreCreateBinary();
+    if (qstats_mutex == NULL || qstats_held == NULL) {
+        return;
+    }
+    vQueueAddToRegistry(qstats_mutex, "QstatsMutex");
+    vQueueAddToRegistry(qstats_held, "QstatsHeld");
+
+    vTaskSuspendAll();
+    xTaskCreate(vQstatsWaiter, "QstatsWaiter", BENCH_STACK_SIZE, NULL,
+                QSTATS_WAITER_PRIORITY, NULL);
+    xTaskCreate(vQstatsHolder, "QstatsHolder", BENCH_STACK_SIZE, NULL,
+                QSTATS_HOLDER_PRIORITY, NULL);
+    start = benchNow();
+    xTaskResumeAll();
+
+    benchWaitDone(2);
+    elapsed = benchNow() - start;
+
+    benchReport("qstats", "round_ns", (double)elapsed / QSTATS_ROUNDS, "ns");
+
+#if (configUSE_QUEUE_STATS == 1)
+    benchQstatsReport();
+#endif
+
+    /* Deleting takes them out of the registry as well */
+    vSemaphoreDelete(qstats_mutex);
+    vSemaphoreDelete(qstats_held);
+}
@@ -0,0 +1,195 @@
+/**
+ * @file bench_queue.c
+ * @brief Queue throughput between two tasks for a range of item sizes, with
+ * items copied in and out and with items filled and read in place
+ *
+ * @verbatim
+ ----------------------------------------------------------------------
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ----------------------------------------------------------------------
+ @endverbatim
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "task.h"
+
+#include "bench.h"
+
+#define QUEUE_ITEMS 20000
+#define QUEUE_LENGTH 16
+#define QUEUE_MAX_ITEM_SIZE 4096
+
+#define QUEUE_WORKER_PRIORITY (tskIDLE_PRIORITY + 1)
+
+static const unsigned int queue_item_sizes[] = { 4, 32, 128, 512, 4096 };
+#define QUEUE_SIZE_STEPS \
+    (sizeof(queue_item_sizes) / sizeof(queue_item_sizes[0]))
+
+static QueueHandle_t bench_queue = NULL;
+
+static void vQueueProducer(void *pvParameters)
+{
+    unsigned char item[QUEUE_MAX_ITEM_SIZE];
+    int i;
+
+    memset(item, 0xa5, sizeof(item));
+
+    for (i = 0; i < QUEUE_ITEMS; i++) {
+        xQueueSend(bench_queue, item, portMAX_DELAY);
+    }
+
+    benchSignalDone();
+    vTaskDelete(NULL);
+}
+
+static void vQueueConsumer(void *pvParameters)
+{
+    unsigned char item[QUEUE_MAX_ITEM_SIZE];
+    int i;
+
+    for (i = 0; i < QUEUE_ITEMS; i++) {
+        xQueueReceive(bench_queue, item, portMAX_DELAY);
+    }
+
+    benchSignalDone();
+    vTaskDelete(NULL);
+}
+
+/* Writes only a sequence number into the reserved slot, the rest of the item
+ * would be produced in place */
+static void vZeroCopyProducer(void *pvParameters)
+{
+    uint32_t *slot;
+    int i;
+
+    for (i = 0; i < QUEUE_ITEMS; i++) {
+        xQueueReserve(bench_queue, (void **)&slot, portMAX_DELAY);
+        *slot = i;
+        xQueueCommit(bench_queue);
+    }
+
+    benchSignalDone();
+    vTaskDelete(NULL);
+}
+
+static void vZeroCopyConsumer(void *pvParameters)
+{
+    uint32_t *slot;
+    int i, out_of_order = 0;
+
+    for (i = 0; i < QUEUE_ITEMS; i++) {
+        xQueueBorrow(bench_queue, (void **)&slot, portMAX_DELAY);
+        if (*slot != i) {
+            out_of_order++;
+        }
+        xQueueRelease(bench_queue);
+    }
+
+    if (out_of_order) {
+        fprintf(stderr, "[ERROR] %d zero copy items out of order\n",
+                out_of_order);
+    }
+
+    benchSignalDone();
+    vTaskDelete(NULL);
+}
+
+/* Producer and consumer at the same priority, each runs until the queue is
+ * full or empty */
+static void benchQueueThroughput(unsigned int item_size, int zero_copy)
+{
+    const char *prefix = zero_copy ? "zero_copy_" : "";
+    uint64_t start, elapsed;
+    char metric[48];
+
+    bench_queue = xQueueCreate(QUEUE_LENGTH, item_size);
+    if (bench_queue == NULL) {
+        return;
+    }
+
+    vTaskSuspendAll();
+    xTaskCreate(zero_copy ? vZeroCopyConsumer : vQueueConsumer, "QueueRecv",
+                BENCH_STACK_SIZE, NULL, QUEUE_WORKER_PRIORITY, NULL);
+    xTaskCreate(zero_copy ? vZeroCopyProducer : vQueueProducer, "QueueSend",
+                BENCH_STACK_SIZE, NULL, QUEUE_WORKER_PRIORITY, NULL);
+    start = benchNow();
+    xTaskResumeAll();
+
+    benchWaitDone(2);
+    elapsed = benchNow() - start;
+
+    snprintf(metric, sizeof(metric), "%sitems_per_s_%ub", prefix, item_size);
+    benchReport("queue", metric, QUEUE_ITEMS * 1e9 / elapsed, "1/s");
+    snprintf(metric, sizeof(metric), "%sbandwidth_%ub", prefix, item_size);
+    benchReport("queue", metric,
+                (double)QUEUE_ITEMS * item_size * 1e3 / elapsed, "MB/s");
+
+    vQueueDelete(bench_queue);
+}
+
+/* Send and receive from the same task, the copy without any task switch, then
+ * the same without the copy */
+static void benchQueueCopy(unsigned int item_size)
+{
+    unsigned char item[QUEUE_MAX_ITEM_SIZE];
+    uint64_t start, elapsed;
+    char metric[48];
+    void *slot;
+    int i;
+
+    bench_queue = xQueueCreate(1, item_size);
+    if (bench_queue == NULL) {
+        return;
+    }
+
+    memset(item, 0x5a, sizeof(item));
+
+    start = benchNow();
+    for (i = 0; i < QUEUE_ITEMS; i++) {
+        xQueueSend(bench_queue, item, 0);
+        xQueueReceive(bench_queue, item, 0);
+    }
+    elapsed = benchNow() - start;
+
+    snprintf(metric, sizeof(metric), "send_receive_ns_%ub", item_size);
+    benchReport("queue", metric, (double)elapsed / QUEUE_ITEMS, "ns");
+
+    start = benchNow();
+    for (i = 0; i < QUEUE_ITEMS; i++) {
+        xQueueReserve(bench_queue, &slot, 0);
+        xQueueCommit(bench_queue);
+        xQueueBorrow(bench_queue, &slot, 0);
+        xQueueRelease(bench_queue);
+    }
+    elapsed = benchNow() - start;
+
+    snprintf(metric, sizeof(metric), "zero_copy_send_receive_ns_%ub",
+             item_size);
+    benchReport("queue", metric, (double)elapsed / QUEUE_ITEMS, "ns");
+
+    vQueueDelete(bench_queue);
+}
+
+void benchQueue(void)
+{
+    unsigned int step;
+
+    for (step = 0; step < QUEUE_SIZE_STEPS; step++) {
+        benchQueueCopy(queue_item_sizes[step]);
+        benchQueueThroughput(queue_item_sizes[step], 0);
+        benchQueueThroughput(queue_item_sizes[step], 1);
+    }
+}
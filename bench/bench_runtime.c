@@ -0,0 +1,100 @@
+/**
+ * @file bench_runtime.c
+ * @brief Accuracy and cost of the run-time statistics counter
+ *
+ * @verbatim
+ ----------------------------------------------------------------------
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ----------------------------------------------------------------------
+ @endverbatim
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "bench.h"
+
+#define RUNTIME_LONG_NS 20000000ULL
+#define RUNTIME_SHORT_NS 50000ULL
+#define RUNTIME_READ_ITERATIONS 100000
+
+#define RUNTIME_WORKER_PRIORITY (tskIDLE_PRIORITY + 1)
+
+static uint64_t benchThreadCpuTime(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+/* Burns the given amount of CPU time, however long the host takes for it */
+static void vSpinWorker(void *pvParameters)
+{
+    const uint64_t spin = *(const uint64_t *)pvParameters;
+    uint64_t start = benchThreadCpuTime();
+
+    while (benchThreadCpuTime() - start < spin)
+        ;
+
+    benchSignalDone();
+    vTaskSuspend(NULL);
+}
+
+static void benchRuntimeSpin(const char *metric, uint64_t spin)
+{
+    TaskHandle_t worker;
+    TaskStatus_t status;
+    char name[32];
+
+    if (xTaskCreate(vSpinWorker, "Spin", BENCH_STACK_SIZE, &spin,
+                    RUNTIME_WORKER_PRIORITY, &worker) != pdPASS) {
+        return;
+    }
+
+    benchWaitDone(1);
+    vTaskGetInfo(worker, &status, pdFALSE, eSuspended);
+    vTaskDelete(worker);
+
+    snprintf(name, sizeof(name), "%s_counted", metric);
+    benchReport("runtime", name, status.ulRunTimeCounter, "ns");
+    snprintf(name, sizeof(name), "%s_error", metric);
+    benchReport("runtime", name,
+                100.0 * ((double)status.ulRunTimeCounter - spin) / spin, "%");
+}
+
+static void benchRuntimeRead(void)
+{
+    volatile configRUN_TIME_COUNTER_TYPE counter;
+    uint64_t start;
+    int i;
+
+    start = benchNow();
+    for (i = 0; i < RUNTIME_READ_ITERATIONS; i++) {
+        counter = portGET_RUN_TIME_COUNTER_VALUE();
+    }
+    (void)counter;
+
+    benchReport("runtime", "read_ns",
+                (double)(benchNow() - start) / RUNTIME_READ_ITERATIONS, "ns");
+}
+
+void benchRuntime(void)
+{
+    benchRuntimeSpin("long", RUNTIME_LONG_NS);
+    benchRuntimeSpin("short", RUNTIME_SHORT_NS);
+    benchRuntimeRead();
+}
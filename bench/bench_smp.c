@@ -0,0 +1,78 @@
+/**
+ * @file bench_smp.c
+ * @brief Throughput of CPU-bound tasks across the emulated cores
+ *
+ * @verbatim
+ ----------------------------------------------------------------------
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ----------------------------------------------------------------------
+ @endverbatim
+ */
+
+#include <stdio.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "bench.h"
+
+#define SMP_WORKERS 8
+#define SMP_LOOPS 20000000UL
+
+#define SMP_WORKER_PRIORITY (tskIDLE_PRIORITY + 1)
+
+/* The same fixed amount of work for every worker, ticks share them out */
+static void vLoopWorker(void *pvParameters)
+{
+    volatile unsigned long sum = 0;
+    unsigned long i;
+
+    (void)pvParameters;
+
+    for (i = 0; i < SMP_LOOPS; i++) {
+        sum += i;
+    }
+
+    benchSignalDone();
+    vTaskDelete(NULL);
+}
+
+static void benchSmpRun(unsigned int workers)
+{
+    uint64_t start;
+    double seconds;
+    unsigned int created = 0;
+    unsigned int i;
+    char name[32];
+
+    start = benchNow();
+    for (i = 0; i < workers; i++) {
+        if (xTaskCreate(vLoopWorker, "Loop", BENCH_STACK_SIZE, NULL,
+                        SMP_WORKER_PRIORITY, NULL) == pdPASS) {
+            created++;
+        }
+    }
+    benchWaitDone(created);
+    seconds = (double)(benchNow() - start) / 1e9;
+
+    snprintf(name, sizeof(name), "%u_workers_loops_per_s", created);
+    benchReport("smp", name, created * (double)SMP_LOOPS / seconds,
+                "loops/s");
+}
+
+void benchSmp(void)
+{
+    benchReport("smp", "cores", configNUMBER_OF_CORES, "cores");
+
+    benchSmpRun(1);
+    benchSmpRun(SMP_WORKERS);
+}
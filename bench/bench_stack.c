@@ -0,0 +1,104 @@
+/**
+ * @file bench_stack.c
+ * @brief Memory taken by each task and stack used by a blocking task
+ *
+ * @verbatim
+ ----------------------------------------------------------------------
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ----------------------------------------------------------------------
+ @endverbatim
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "bench.h"
+
+#define STACK_TASKS 100
+
+#define STACK_WORKER_PRIORITY (tskIDLE_PRIORITY + 1)
+
+static void vBlockedWorker(void *pvParameters)
+{
+    /* Never notified, stays blocked until the controller deletes it */
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+/* Virtual and resident size of the process in bytes */
+static int benchMemory(double *vm, double *rss)
+{
+    unsigned long vm_pages, rss_pages;
+    FILE *statm = fopen("/proc/self/statm", "r");
+
+    if (!statm) {
+        return -1;
+    }
+
+    if (fscanf(statm, "%lu %lu", &vm_pages, &rss_pages) != 2) {
+        fclose(statm);
+        return -1;
+    }
+    fclose(statm);
+
+    *vm = (double)vm_pages * sysconf(_SC_PAGESIZE);
+    *rss = (double)rss_pages * sysconf(_SC_PAGESIZE);
+
+    return 0;
+}
+
+void benchStack(void)
+{
+    TaskHandle_t workers[STACK_TASKS];
+    double vm_start, rss_start, vm, rss;
+    unsigned int created, i;
+    UBaseType_t unused;
+
+    if (benchMemory(&vm_start, &rss_start)) {
+        return;
+    }
+
+    for (created = 0; created < STACK_TASKS; created++) {
+        if (xTaskCreate(vBlockedWorker, "Worker", configMINIMAL_STACK_SIZE,
+                        NULL, STACK_WORKER_PRIORITY,
+                        &workers[created]) != pdPASS) {
+            break;
+        }
+    }
+
+    /* Let every worker run once and block before measuring */
+    vTaskDelay(pdMS_TO_TICKS(100));
+
+    if (created == STACK_TASKS && !benchMemory(&vm, &rss)) {
+        benchReport("stack", "vm_bytes_per_task",
+                    (vm - vm_start) / STACK_TASKS, "B");
+        benchReport("stack", "rss_bytes_per_task",
+                    (rss - rss_start) / STACK_TASKS, "B");
+
+        unused = uxTaskGetStackHighWaterMark(workers[0]);
+        benchReport("stack", "blocked_task_stack_used",
+                    (double)(configMINIMAL_STACK_SIZE - unused) *
+                    sizeof(StackType_t), "B");
+        unused = uxTaskGetStackHighWaterMark(xTaskGetIdleTaskHandle());
+        benchReport("stack", "idle_task_stack_used",
+                    (double)(configMINIMAL_STACK_SIZE - unused) *
+                    sizeof(StackType_t), "B");
+    }
+
+    for (i = 0; i < created; i++) {
+        vTaskDelete(workers[i]);
+    }
+}
@@ -0,0 +1,191 @@
+/**
+ * @file bench_startup.c
+ * @brief Time from the first xTaskCreate() until the scheduler runs a task
+ *
+ * The scheduler can only be started once per process, so every measurement
+ * runs in a fresh copy of the benchmark that reports back through a pipe.
+ *
+ * @verbatim
+ ----------------------------------------------------------------------
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ----------------------------------------------------------------------
+ @endverbatim
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "bench.h"
+
+#define STARTUP_EXECUTABLE "/proc/self/exe"
+
+/* Total task counts created before the scheduler starts */
+static const unsigned int startup_task_counts[] = { 10, 100, 1000 };
+#define STARTUP_STEPS \
+    (sizeof(startup_task_counts) / sizeof(startup_task_counts[0]))
+
+static uint64_t startup_begin, startup_created;
+static int startup_fd;
+
+static void vStartupFiller(void *pvParameters)
+{
+    /* Never gets to run, the first task ends the process */
+    for (;;) {
+        vTaskSuspend(NULL);
+    }
+}
+
+static void vStartupFirst(void *pvParameters)
+{
+    uint64_t started = benchNow();
+
+    dprintf(startup_fd, "%llu %llu\n",
+            (unsigned long long)(startup_created - startup_begin),
+            (unsigned long long)(started - startup_begin));
+
+    exit(EXIT_SUCCESS);
+}
+
+int benchStartupMain(int argc, char *argv[])
+{
+    unsigned int count, i;
+
+    if (argc < 4) {
+        return EXIT_FAILURE;
+    }
+
+    count = strtoul(argv[2], NULL, 10);
+    startup_fd = atoi(argv[3]);
+
+    startup_begin = benchNow();
+
+    for (i = 1; i < count; i++)
+        if (xTaskCreate(vStartupFiller, "Filler", configMINIMAL_STACK_SIZE,
+                        NULL, tskIDLE_PRIORITY + 1, NULL) != pdPASS) {
+            return EXIT_FAILURE;
+        }
+
+    if (xTaskCreate(vStartupFirst, "First", BENCH_STACK_SIZE, NULL,
+                    BENCH_CONTROLLER_PRIORITY, NULL) != pdPASS) {
+        return EXIT_FAILURE;
+    }
+
+    startup_created = benchNow();
+
+    vTaskStartScheduler();
+
+    return EXIT_FAILURE;
+}
+
+static int benchStartupRun(unsigned int count, unsigned long long *created,
+                           unsigned long long *started)
+{
+    char count_arg[16], fd_arg[16], result[64];
+    char *const child_argv[] = { STARTUP_EXECUTABLE, BENCH_STARTUP_ARG,
+                                 count_arg, fd_arg, NULL
+                               };
+    extern char **environ;
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+    sigset_t no_signals;
+    size_t len = 0;
+    ssize_t got;
+    int fds[2], status, ret = -1;
+    pid_t pid;
+
+    if (pipe(fds)) {
+        return -1;
+    }
+
+    snprintf(count_arg, sizeof(count_arg), "%u", count);
+    snprintf(fd_arg, sizeof(fd_arg), "%d", fds[1]);
+
+    /* Keeps the port's messages out of the results */
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null",
+                                     O_WRONLY, 0);
+
+    /* The child would inherit the blocked signals of the calling task */
+    sigemptyset(&no_signals);
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setsigmask(&attr, &no_signals);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK);
+
+    if (posix_spawn(&pid, STARTUP_EXECUTABLE, &actions, &attr, child_argv,
+                    environ)) {
+        goto out;
+    }
+
+    close(fds[1]);
+    fds[1] = -1;
+
+    while (len < sizeof(result) - 1) {
+        got = read(fds[0], result + len, sizeof(result) - 1 - len);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            break;
+        }
+        len += got;
+    }
+    result[len] = '\0';
+
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+        ;
+
+    if (WIFEXITED(status) && !WEXITSTATUS(status) &&
+        sscanf(result, "%llu %llu", created, started) == 2) {
+        ret = 0;
+    }
+
+out:
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&actions);
+    close(fds[0]);
+    if (fds[1] >= 0) {
+        close(fds[1]);
+    }
+
+    return ret;
+}
+
+void benchStartup(void)
+{
+    unsigned long long created, started;
+    char metric[48];
+    unsigned int i;
+
+    for (i = 0; i < STARTUP_STEPS; i++) {
+        if (benchStartupRun(startup_task_counts[i], &created, &started)) {
+            fprintf(stderr, "[ERROR] Startup of %u tasks failed\n",
+                    startup_task_counts[i]);
+            continue;
+        }
+
+        snprintf(metric, sizeof(metric), "create_ns_tasks_%u",
+                 startup_task_counts[i]);
+        benchReport("startup", metric, created, "ns");
+        snprintf(metric, sizeof(metric), "start_ns_tasks_%u",
+                 startup_task_counts[i]);
+        benchReport("startup", metric, started, "ns");
+    }
+}
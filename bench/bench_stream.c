@@ -0,0 +1,213 @@
+/**
+ * @file bench_stream.c
+ * @brief Throughput of a byte stream passed between two tasks through a stream
+ * buffer, through a message buffer and through a queue of fixed size chunks,
+ * for a range of chunk sizes and stream buffer trigger levels
+ *
+ * @verbatim
+ ----------------------------------------------------------------------
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ----------------------------------------------------------------------
+ @endverbatim
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "message_buffer.h"
+#include "queue.h"
+#include "stream_buffer.h"
+#include "task.h"
+
+#include "bench.h"
+
+#define STREAM_BYTES (1024 * 1024)
+/* Bytes held by each pipe, the queue holds as many chunks as fit */
+#define STREAM_BUFFER_SIZE 4096
+#define STREAM_MAX_CHUNK 1024
+/* Below the trigger level a blocked reader only gets the end of the stream
+ * once its block time runs out */
+#define STREAM_RECEIVE_TICKS pdMS_TO_TICKS(10)
+
+#define STREAM_PRODUCER_PRIORITY (tskIDLE_PRIORITY + 1)
+#define STREAM_CONSUMER_PRIORITY (tskIDLE_PRIORITY + 2)
+
+typedef enum { PIPE_QUEUE, PIPE_STREAM, PIPE_MESSAGE } stream_pipe_t;
+
+static const char *const stream_pipe_names[] = {
+    "queue", "stream_buffer", "message_buffer"
+};
+
+static const unsigned int stream_chunk_sizes[] = { 16, 128, 1024 };
+#define STREAM_CHUNK_STEPS \
+    (sizeof(stream_chunk_sizes) / sizeof(stream_chunk_sizes[0]))
+
+static stream_pipe_t stream_pipe;
+static unsigned int stream_chunk;
+static QueueHandle_t stream_queue = NULL;
+static StreamBufferHandle_t stream_buffer = NULL;
+static unsigned int stream_receives;
+
+/* Every byte holds its offset in the stream, so the consumer can tell from
+ * the first byte of what it received whether bytes were lost or reordered */
+static void vStreamProducer(void *pvParameters)
+{
+    unsigned char chunk[STREAM_MAX_CHUNK];
+    size_t sent = 0, n, i;
+
+    while (sent < STREAM_BYTES) {
+        for (i = 0; i < stream_chunk; i++) {
+            chunk[i] = (unsigned char)(sent + i);
+        }
+
+        switch (stream_pipe) {
+            case PIPE_QUEUE:
+                xQueueSend(stream_queue, chunk, portMAX_DELAY);
+                n = stream_chunk;
+                break;
+            case PIPE_STREAM:
+            case PIPE_MESSAGE:
+            default:
+                n = xStreamBufferSend(stream_buffer, chunk, stream_chunk,
+                                      portMAX_DELAY);
+                break;
+        }
+        sent += n;
+    }
+
+    benchSignalDone();
+    vTaskDelete(NULL);
+}
+
+static void vStreamConsumer(void *pvParameters)
+{
+    unsigned char buffer[STREAM_BUFFER_SIZE];
+    size_t received = 0, n;
+    unsigned int receives = 0, out_of_order = 0;
+
+    while (received < STREAM_BYTES) {
+        switch (stream_pipe) {
+            case PIPE_QUEUE:
+                xQueueReceive(stream_queue, buffer, portMAX_DELAY);
+                n = stream_chunk;
+                break;
+            case PIPE_STREAM:
+            case PIPE_MESSAGE:
+            default:
+                n = xStreamBufferReceive(stream_buffer, buffer, sizeof(buffer),
+                                         STREAM_RECEIVE_TICKS);
+                break;
+        }
+        if (n == 0) {
+            continue;
+        }
+        if (buffer[0] != (unsigned char)received ||
+            (stream_pipe == PIPE_MESSAGE && n != stream_chunk)) {
+            out_of_order++;
+        }
+        received += n;
+        receives++;
+    }
+
+    if (out_of_order) {
+        fprintf(stderr, "[ERROR] %u %s receives out of order\n",
+                out_of_order, stream_pipe_names[stream_pipe]);
+    }
+    stream_receives = receives;
+
+    benchSignalDone();
+    vTaskDelete(NULL);
+}
+
+/* The consumer preempts the producer as soon as it is woken, as a task
+ * handling a byte stream would, so the trigger level sets how much a stream
+ * buffer collects per wake up. It takes whatever a stream buffer holds but one
+ * chunk or message at a time from the others. */
+static void benchStreamPipe(stream_pipe_t pipe, unsigned int chunk,
+                            size_t trigger_level)
+{
+    uint64_t start, elapsed;
+    char metric[64], suffix[24];
+
+    stream_pipe = pipe;
+    stream_chunk = chunk;
+
+    switch (pipe) {
+        case PIPE_QUEUE:
+            stream_queue = xQueueCreate(STREAM_BUFFER_SIZE / chunk, chunk);
+            if (stream_queue == NULL) {
+                return;
+            }
+            snprintf(suffix, sizeof(suffix), "%ub", chunk);
+            break;
+        case PIPE_STREAM:
+            stream_buffer = xStreamBufferCreate(STREAM_BUFFER_SIZE,
+                                                trigger_level);
+            if (stream_buffer == NULL) {
+                return;
+            }
+            snprintf(suffix, sizeof(suffix), "%ub_trigger_%u", chunk,
+                     (unsigned)trigger_level);
+            break;
+        case PIPE_MESSAGE:
+        default:
+            stream_buffer = xMessageBufferCreate(STREAM_BUFFER_SIZE);
+            if (stream_buffer == NULL) {
+                return;
+            }
+            snprintf(suffix, sizeof(suffix), "%ub", chunk);
+            break;
+    }
+
+    vTaskSuspendAll();
+    xTaskCreate(vStreamConsumer, "StreamRecv", BENCH_STACK_SIZE, NULL,
+                STREAM_CONSUMER_PRIORITY, NULL);
+    xTaskCreate(vStreamProducer, "StreamSend", BENCH_STACK_SIZE, NULL,
+                STREAM_PRODUCER_PRIORITY, NULL);
+    start = benchNow();
+    xTaskResumeAll();
+
+    benchWaitDone(2);
+    elapsed = benchNow() - start;
+
+    snprintf(metric, sizeof(metric), "%s_bandwidth_%s",
+             stream_pipe_names[pipe], suffix);
+    benchReport("stream", metric, (double)STREAM_BYTES * 1e3 / elapsed,
+                "MB/s");
+    if (pipe == PIPE_STREAM) {
+        snprintf(metric, sizeof(metric), "%s_bytes_per_receive_%s",
+                 stream_pipe_names[pipe], suffix);
+        benchReport("stream", metric,
+                    (double)STREAM_BYTES / stream_receives, "B");
+    }
+
+    if (pipe == PIPE_QUEUE) {
+        vQueueDelete(stream_queue);
+    }
+    else {
+        vStreamBufferDelete(stream_buffer);
+    }
+}
+
+void benchStream(void)
+{
+    unsigned int step;
+
+    for (step = 0; step < STREAM_CHUNK_STEPS; step++) {
+        benchStreamPipe(PIPE_QUEUE, stream_chunk_sizes[step], 0);
+        benchStreamPipe(PIPE_STREAM, stream_chunk_sizes[step], 1);
+        benchStreamPipe(PIPE_STREAM, stream_chunk_sizes[step],
+                        STREAM_BUFFER_SIZE / 2);
+        benchStreamPipe(PIPE_MESSAGE, stream_chunk_sizes[step], 0);
+    }
+}
@@ -0,0 +1,315 @@
+/**
+ * @file bench_switch.c
+ * @brief Context switch throughput and latency of the port's switch backend
+ *
+ * @verbatim
+ ----------------------------------------------------------------------
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ----------------------------------------------------------------------
+ @endverbatim
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "bench.h"
+
+#define SWITCH_YIELD_ITERATIONS 20000
+#define SWITCH_NOTIFY_ITERATIONS 5000
+#define SWITCH_RESELECT_ITERATIONS 100000
+
+/* Power of two histogram buckets of the notify latency, from below 1 us up */
+#define SWITCH_HIST_FIRST_SHIFT 10
+#define SWITCH_HIST_BUCKETS 12
+
+#define SWITCH_WORKER_PRIORITY (tskIDLE_PRIORITY + 1)
+
+/* Total task counts the yield pair is measured against, fillers included */
+static const unsigned int scaling_task_counts[] = { 5, 50, 500 };
+#define SWITCH_SCALING_STEPS \
+    (sizeof(scaling_task_counts) / sizeof(scaling_task_counts[0]))
+
+static TaskHandle_t notify_waiter = NULL;
+static volatile uint64_t notify_sent_at = 0;
+static uint64_t notify_min, notify_max, notify_total;
+static uint64_t notify_latencies[SWITCH_NOTIFY_ITERATIONS];
+
+static void vYieldWorker(void *pvParameters)
+{
+    int i;
+
+    for (i = 0; i < SWITCH_YIELD_ITERATIONS; i++) {
+        taskYIELD();
+    }
+
+    benchSignalDone();
+    vTaskDelete(NULL);
+}
+
+static void vFillerTask(void *pvParameters)
+{
+    /* Never notified, stays blocked until the controller deletes it */
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+static void vNotifyWaiter(void *pvParameters)
+{
+    uint64_t latency;
+    int i;
+
+    notify_min = UINT64_MAX;
+    notify_max = 0;
+    notify_total = 0;
+
+    for (i = 0; i < SWITCH_NOTIFY_ITERATIONS; i++) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        latency = benchNow() - notify_sent_at;
+
+        notify_latencies[i] = latency;
+        notify_total += latency;
+        if (latency < notify_min) {
+            notify_min = latency;
+        }
+        if (latency > notify_max) {
+            notify_max = latency;
+        }
+    }
+
+    benchSignalDone();
+    vTaskDelete(NULL);
+}
+
+static void vNotifySender(void *pvParameters)
+{
+    int i;
+
+    for (i = 0; i < SWITCH_NOTIFY_ITERATIONS; i++) {
+        notify_sent_at = benchNow();
+        /* The waiter has the higher priority and runs before this returns */
+        xTaskNotifyGive(notify_waiter);
+    }
+
+    benchSignalDone();
+    vTaskDelete(NULL);
+}
+
+/* Dropping its own priority makes the task yield. It is still the highest
+ * priority task ready and is selected again without a switch, but the kernel
+ * has to look for it from the priority it dropped from */
+static void vReselectWorker(void *pvParameters)
+{
+    uint64_t start, elapsed;
+    int i;
+
+    start = benchNow();
+    for (i = 0; i < SWITCH_RESELECT_ITERATIONS; i++) {
+        vTaskPrioritySet(NULL, SWITCH_WORKER_PRIORITY);
+        vTaskPrioritySet(NULL, configMAX_PRIORITIES - 2);
+    }
+    elapsed = benchNow() - start;
+
+    benchReport("switch", "reselect_ns", (double)elapsed /
+                SWITCH_RESELECT_ITERATIONS, "ns");
+    benchReport("switch", "max_priorities", configMAX_PRIORITIES, "count");
+
+    benchSignalDone();
+    vTaskDelete(NULL);
+}
+
+static void benchSwitchReselect(void)
+{
+    TaskHandle_t worker;
+
+    /* Nothing else is ready on the worker's core, there is no switch */
+    vTaskSuspendAll();
+    xTaskCreate(vReselectWorker, "Reselect", BENCH_STACK_SIZE, NULL,
+                configMAX_PRIORITIES - 2, &worker);
+#if (configNUMBER_OF_CORES > 1)
+    vTaskCoreAffinitySet(worker, 1 << 0);
+#else
+    (void)worker;
+#endif
+    xTaskResumeAll();
+
+    benchWaitDone(1);
+}
+
+static uint64_t benchSwitchYieldPair(void)
+{
+    uint64_t start;
+
+    xTaskCreate(vYieldWorker, "Yield1", BENCH_STACK_SIZE, NULL,
+                SWITCH_WORKER_PRIORITY, NULL);
+    xTaskCreate(vYieldWorker, "Yield2", BENCH_STACK_SIZE, NULL,
+                SWITCH_WORKER_PRIORITY, NULL);
+
+    start = benchNow();
+    benchWaitDone(2);
+    return benchNow() - start;
+}
+
+static void benchSwitchYield(void)
+{
+    uint64_t elapsed;
+    double switches = 2.0 * SWITCH_YIELD_ITERATIONS;
+
+    elapsed = benchSwitchYieldPair();
+
+    benchReport("switch", "yield_ns_per_switch", elapsed / switches, "ns");
+    benchReport("switch", "yield_switches_per_s",
+                switches * 1e9 / elapsed, "1/s");
+}
+
+/* Yield cost of the same pair with a growing number of blocked tasks around */
+static void benchSwitchScaling(void)
+{
+    double switches = 2.0 * SWITCH_YIELD_ITERATIONS;
+    unsigned int fillers, created, i, step;
+    TaskHandle_t *filler_tasks;
+    uint64_t elapsed;
+    char metric[48];
+
+    for (step = 0; step < SWITCH_SCALING_STEPS; step++) {
+        fillers = scaling_task_counts[step] - 2;
+        filler_tasks = pvPortMalloc(fillers * sizeof(TaskHandle_t));
+        if (filler_tasks == NULL) {
+            return;
+        }
+
+        for (created = 0; created < fillers; created++) {
+            if (xTaskCreate(vFillerTask, "Filler", configMINIMAL_STACK_SIZE,
+                            NULL, SWITCH_WORKER_PRIORITY,
+                            &filler_tasks[created]) != pdPASS) {
+                break;
+            }
+        }
+
+        if (created == fillers) {
+            /* Let every filler run once and block before measuring */
+            vTaskDelay(pdMS_TO_TICKS(100));
+            elapsed = benchSwitchYieldPair();
+            snprintf(metric, sizeof(metric), "yield_ns_per_switch_tasks_%u",
+                     scaling_task_counts[step]);
+            benchReport("switch", metric, elapsed / switches, "ns");
+        }
+
+        for (i = 0; i < created; i++) {
+            vTaskDelete(filler_tasks[i]);
+        }
+        vPortFree(filler_tasks);
+    }
+}
+
+static int benchCompareLatency(const void *a, const void *b)
+{
+    uint64_t la = *(const uint64_t *)a, lb = *(const uint64_t *)b;
+
+    return (la > lb) - (la < lb);
+}
+
+/* Latency percentiles and a histogram of all notify iterations */
+static void benchSwitchNotifyDistribution(void)
+{
+    unsigned int counts[SWITCH_HIST_BUCKETS] = { 0 };
+    unsigned int bucket, i;
+    char metric[48];
+
+    for (i = 0; i < SWITCH_NOTIFY_ITERATIONS; i++) {
+        for (bucket = 0; bucket < SWITCH_HIST_BUCKETS - 1; bucket++)
+            if (notify_latencies[i] <
+                (1ULL << (SWITCH_HIST_FIRST_SHIFT + bucket))) {
+                break;
+            }
+        counts[bucket]++;
+    }
+
+    qsort(notify_latencies, SWITCH_NOTIFY_ITERATIONS,
+          sizeof(notify_latencies[0]), benchCompareLatency);
+    benchReport("switch", "notify_latency_p50",
+                notify_latencies[SWITCH_NOTIFY_ITERATIONS / 2], "ns");
+    benchReport("switch", "notify_latency_p99",
+                notify_latencies[SWITCH_NOTIFY_ITERATIONS * 99 / 100], "ns");
+    benchReport("switch", "notify_latency_p999",
+                notify_latencies[SWITCH_NOTIFY_ITERATIONS * 999 / 1000], "ns");
+
+    for (bucket = 0; bucket < SWITCH_HIST_BUCKETS - 1; bucket++) {
+        snprintf(metric, sizeof(metric), "notify_latency_hist_lt_%lluns",
+                 1ULL << (SWITCH_HIST_FIRST_SHIFT + bucket));
+        benchReport("switch", metric, counts[bucket], "count");
+    }
+    snprintf(metric, sizeof(metric), "notify_latency_hist_ge_%lluns",
+             1ULL << (SWITCH_HIST_FIRST_SHIFT + bucket - 1));
+    benchReport("switch", metric, counts[bucket], "count");
+}
+
+/* Host scheduling the task threads run with, see FREERTOS_TASK_CPUS and
+ * FREERTOS_SCHED_FIFO in the port */
+static void benchSwitchHost(void)
+{
+    struct sched_param param;
+    cpu_set_t cpus;
+    int policy;
+
+    if (!sched_getaffinity(0, sizeof(cpus), &cpus)) {
+        benchReport("switch", "host_cpus", CPU_COUNT(&cpus), "count");
+    }
+    if (!pthread_getschedparam(pthread_self(), &policy, &param)) {
+        benchReport("switch", "host_fifo_priority",
+                    policy == SCHED_FIFO ? param.sched_priority : 0, "prio");
+    }
+}
+
+static void benchSwitchNotify(void)
+{
+    TaskHandle_t sender;
+
+    /* The pair shares a core, a waiter running elsewhere would miss gives */
+    vTaskSuspendAll();
+    xTaskCreate(vNotifyWaiter, "NotifyWait", BENCH_STACK_SIZE, NULL,
+                SWITCH_WORKER_PRIORITY + 1, &notify_waiter);
+    xTaskCreate(vNotifySender, "NotifySend", BENCH_STACK_SIZE, NULL,
+                SWITCH_WORKER_PRIORITY, &sender);
+#if (configNUMBER_OF_CORES > 1)
+    vTaskCoreAffinitySet(notify_waiter, 1 << 0);
+    vTaskCoreAffinitySet(sender, 1 << 0);
+#else
+    (void)sender;
+#endif
+    xTaskResumeAll();
+
+    benchWaitDone(2);
+
+    benchReport("switch", "notify_latency_min", notify_min, "ns");
+    benchReport("switch", "notify_latency_avg",
+                (double)notify_total / SWITCH_NOTIFY_ITERATIONS, "ns");
+    benchReport("switch", "notify_latency_max", notify_max, "ns");
+    benchSwitchNotifyDistribution();
+}
+
+void benchSwitch(void)
+{
+    benchSwitchHost();
+    benchSwitchYield();
+    benchSwitchNotify();
+    benchSwitchReselect();
+    benchSwitchScaling();
+}
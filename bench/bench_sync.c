@@ -0,0 +1,129 @@
+/**
+ * @file bench_sync.c
+ * @brief Cost of semaphore and mutex hand-overs between tasks
+ *
+ * @verbatim
+ ----------------------------------------------------------------------
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ----------------------------------------------------------------------
+ @endverbatim
+ */
+
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "task.h"
+
+#include "bench.h"
+
+#define SYNC_PING_PONG_ITERATIONS 10000
+#define SYNC_MUTEX_ITERATIONS 100000
+
+#define SYNC_WORKER_PRIORITY (tskIDLE_PRIORITY + 1)
+
+static SemaphoreHandle_t sync_ping = NULL;
+static SemaphoreHandle_t sync_pong = NULL;
+
+/* Gives ping and blocks on pong, every round trip takes two task switches */
+static void vPingTask(void *pvParameters)
+{
+    int i;
+
+    for (i = 0; i < SYNC_PING_PONG_ITERATIONS; i++) {
+        xSemaphoreGive(sync_ping);
+        xSemaphoreTake(sync_pong, portMAX_DELAY);
+    }
+
+    benchSignalDone();
+    vTaskDelete(NULL);
+}
+
+static void vPongTask(void *pvParameters)
+{
+    int i;
+
+    for (i = 0; i < SYNC_PING_PONG_ITERATIONS; i++) {
+        xSemaphoreTake(sync_ping, portMAX_DELAY);
+        xSemaphoreGive(sync_pong);
+    }
+
+    benchSignalDone();
+    vTaskDelete(NULL);
+}
+
+static void benchSyncPingPong(void)
+{
+    TaskHandle_t ping, pong;
+    uint64_t start, elapsed;
+
+    sync_ping = xSemaphoreCreateBinary();
+    sync_pong = xSemaphoreCreateBinary();
+    if (sync_ping == NULL || sync_pong == NULL) {
+        return;
+    }
+
+    /* The pair shares a core, the hand-over is what is measured */
+    vTaskSuspendAll();
+    xTaskCreate(vPongTask, "Pong", BENCH_STACK_SIZE, NULL,
+                SYNC_WORKER_PRIORITY, &pong);
+    xTaskCreate(vPingTask, "Ping", BENCH_STACK_SIZE, NULL,
+                SYNC_WORKER_PRIORITY, &ping);
+#if (configNUMBER_OF_CORES > 1)
+    vTaskCoreAffinitySet(ping, 1 << 0);
+    vTaskCoreAffinitySet(pong, 1 << 0);
+#else
+    (void)ping;
+    (void)pong;
+#endif
+    start = benchNow();
+    xTaskResumeAll();
+
+    benchWaitDone(2);
+    elapsed = benchNow() - start;
+
+    benchReport("sync", "semaphore_round_trip_ns",
+                (double)elapsed / SYNC_PING_PONG_ITERATIONS, "ns");
+    benchReport("sync", "semaphore_round_trips_per_s",
+                SYNC_PING_PONG_ITERATIONS * 1e9 / elapsed, "1/s");
+
+    vSemaphoreDelete(sync_ping);
+    vSemaphoreDelete(sync_pong);
+}
+
+/* Take and give without contention, the cost of guarding a resource */
+static void benchSyncMutex(void)
+{
+    SemaphoreHandle_t mutex = xSemaphoreCreateMutex();
+    uint64_t start, elapsed;
+    int i;
+
+    if (mutex == NULL) {
+        return;
+    }
+
+    start = benchNow();
+    for (i = 0; i < SYNC_MUTEX_ITERATIONS; i++) {
+        xSemaphoreTake(mutex, portMAX_DELAY);
+        xSemaphoreGive(mutex);
+    }
+    elapsed = benchNow() - start;
+
+    benchReport("sync", "mutex_take_give_ns",
+                (double)elapsed / SYNC_MUTEX_ITERATIONS, "ns");
+
+    vSemaphoreDelete(mutex);
+}
+
+void benchSync(void)
+{
+    benchSyncPingPong();
+    benchSyncMutex();
+}
@@ -0,0 +1,123 @@
+/**
+ * @file bench_tick.c
+ * @brief Rate and lateness of the port's tick source
+ *
+ * @verbatim
+ ----------------------------------------------------------------------
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ----------------------------------------------------------------------
+ @endverbatim
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "bench.h"
+
+#define TICK_MEASURE_MS 2000
+#define TICK_LOAD_MS 1000
+#define TICK_LOAD_WORKERS 2
+#define TICK_CRITICAL_NS 200000ULL
+
+#define TICK_WORKER_PRIORITY (tskIDLE_PRIORITY + 1)
+
+#if ( configPOSIX_TICK_SOURCE != portTICK_SOURCE_VIRTUAL )
+
+static volatile int tick_load_stop;
+
+/* Spends most of its time in critical sections, where ticks are deferred */
+static void vCriticalWorker(void *pvParameters)
+{
+    uint64_t start;
+
+    (void)pvParameters;
+
+    while (!tick_load_stop) {
+        taskENTER_CRITICAL();
+        start = benchNow();
+        while (benchNow() - start < TICK_CRITICAL_NS)
+            ;
+        taskEXIT_CRITICAL();
+    }
+
+    benchSignalDone();
+    vTaskSuspend(NULL);
+}
+
+/* Every tick raised under load has to reach the kernel */
+static void benchTickLoad(void)
+{
+    xPortInterruptStats stats;
+    TaskHandle_t workers[TICK_LOAD_WORKERS];
+    unsigned int created = 0;
+    unsigned int i;
+
+    tick_load_stop = 0;
+    vPortResetInterruptStats();
+
+    for (i = 0; i < TICK_LOAD_WORKERS; i++) {
+        if (xTaskCreate(vCriticalWorker, "Critical", BENCH_STACK_SIZE, NULL,
+                        TICK_WORKER_PRIORITY, &workers[created]) == pdPASS) {
+            created++;
+        }
+    }
+
+    vTaskDelay(pdMS_TO_TICKS(TICK_LOAD_MS));
+    tick_load_stop = 1;
+    benchWaitDone(created);
+
+    for (i = 0; i < created; i++) {
+        vTaskDelete(workers[i]);
+    }
+
+    vPortGetInterruptStats(&stats);
+    benchReport("tick", "load_raised", stats.ullTicksRaised, "ticks");
+    benchReport("tick", "load_taken", stats.ullTicksTaken, "ticks");
+    benchReport("tick", "load_pending", stats.ullTicksPending, "ticks");
+    benchReport("tick", "load_deferred", stats.ullTicksDeferred, "ticks");
+    benchReport("tick", "load_replayed", stats.ullTicksReplayed, "ticks");
+}
+
+#endif
+
+void benchTick(void)
+{
+    xPortTickStats stats;
+    TickType_t ticks;
+    uint64_t start, elapsed;
+
+    vPortResetTickStats();
+    ticks = xTaskGetTickCount();
+    start = benchNow();
+
+    vTaskDelay(pdMS_TO_TICKS(TICK_MEASURE_MS));
+
+    elapsed = benchNow() - start;
+    ticks = xTaskGetTickCount() - ticks;
+
+    benchReport("tick", "configured_rate", configTICK_RATE_HZ, "Hz");
+    benchReport("tick", "measured_rate", ticks * 1e9 / elapsed, "Hz");
+
+    /* Lateness is only known for sources that keep statistics */
+    if (xPortGetTickStats(&stats) == pdTRUE) {
+        benchReport("tick", "lateness_min", stats.ullMinLateness, "ns");
+        benchReport("tick", "lateness_avg", stats.ullAvgLateness, "ns");
+        benchReport("tick", "lateness_p99", stats.ullP99Lateness, "ns");
+        benchReport("tick", "lateness_max", stats.ullMaxLateness, "ns");
+        benchReport("tick", "missed", stats.ullMissed, "ticks");
+    }
+
+#if ( configPOSIX_TICK_SOURCE != portTICK_SOURCE_VIRTUAL )
+    /* Virtual time stands still while the workers spin */
+    benchTickLoad();
+#endif
+}
@@ -0,0 +1,98 @@
+/**
+ * @file bench_timebase.c
+ * @brief Simulated time against wall time for periodic tasks
+ *
+ * Under virtual time the simulated second passes as fast as the tasks can
+ * run, with a real tick it takes a second.
+ *
+ * @verbatim
+ ----------------------------------------------------------------------
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ----------------------------------------------------------------------
+ @endverbatim
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "bench.h"
+
+#define TIMEBASE_SIMULATED_MS 1000
+#define TIMEBASE_WORKER_PRIORITY (tskIDLE_PRIORITY + 1)
+
+static const TickType_t timebase_periods[] = { 3, 7, 11 };
+#define TIMEBASE_WORKERS \
+    (sizeof(timebase_periods) / sizeof(timebase_periods[0]))
+
+static TickType_t timebase_start, timebase_end;
+static uint32_t timebase_wakeups;
+static uint32_t timebase_trace;
+
+static void vPeriodicWorker(void *pvParameters)
+{
+    const TickType_t period = *(const TickType_t *)pvParameters;
+    TickType_t last_wake = xTaskGetTickCount();
+
+    while (last_wake + period <= timebase_end) {
+        vTaskDelayUntil(&last_wake, period);
+
+        /* Order sensitive hash of who woke up when */
+        timebase_wakeups++;
+        timebase_trace = timebase_trace * 31 +
+                         (xTaskGetTickCount() - timebase_start) * period;
+    }
+
+    benchSignalDone();
+    vTaskDelete(NULL);
+}
+
+static uint32_t benchTimebaseRun(void)
+{
+    unsigned int i;
+
+    timebase_wakeups = 0;
+    timebase_trace = 0;
+    timebase_start = xTaskGetTickCount();
+    timebase_end = timebase_start + pdMS_TO_TICKS(TIMEBASE_SIMULATED_MS);
+
+    for (i = 0; i < TIMEBASE_WORKERS; i++) {
+        xTaskCreate(vPeriodicWorker, "Periodic", BENCH_STACK_SIZE,
+                    (void *)&timebase_periods[i], TIMEBASE_WORKER_PRIORITY,
+                    NULL);
+    }
+
+    benchWaitDone(TIMEBASE_WORKERS);
+
+    return timebase_trace;
+}
+
+void benchTimebase(void)
+{
+    uint64_t start, elapsed;
+    uint32_t trace;
+
+    /* Start both runs on a tick boundary, so they see the same phases */
+    vTaskDelay(1);
+    start = benchNow();
+    trace = benchTimebaseRun();
+    elapsed = benchNow() - start;
+
+    benchReport("timebase", "simulated", TIMEBASE_SIMULATED_MS * 1e6, "ns");
+    benchReport("timebase", "wall", elapsed, "ns");
+    benchReport("timebase", "speedup",
+                TIMEBASE_SIMULATED_MS * 1e6 / elapsed, "x");
+    benchReport("timebase", "wakeups", timebase_wakeups, "1");
+
+    vTaskDelay(1);
+    benchReport("timebase", "repeatable",
+                benchTimebaseRun() == trace ? 1 : 0, "bool");
+}
@@ -0,0 +1,311 @@
+/**
+ * @file bench_timer.c
+ * @brief Lateness of delayed tasks, jitter of software timers, the cost of
+ * keeping thousands of software timers running and of resetting a set of
+ * watchdog timers one by one and as a batch
+ *
+ * @verbatim
+ ----------------------------------------------------------------------
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ----------------------------------------------------------------------
+ @endverbatim
+ */
+
+#include <stdio.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+#include "bench.h"
+
+#define TIMER_DELAY_ITERATIONS 200
+#define TIMER_EXPIRIES 200
+#define TIMER_PERIOD_TICKS 5
+
+/* Auto reload timers with periods of one to five seconds, as many per
+ * connection timeouts would be */
+#define TIMER_MANY_COUNT 10000
+#define TIMER_MANY_MIN_PERIOD pdMS_TO_TICKS(1000)
+#define TIMER_MANY_PERIOD_SPREAD pdMS_TO_TICKS(4000)
+#define TIMER_MANY_RUN_TICKS pdMS_TO_TICKS(2000)
+
+/* Watchdog timers a task below the timer service task resets every round,
+ * they never get to expire */
+#define TIMER_KICK_TIMERS 64
+#define TIMER_KICK_ROUNDS 200
+#define TIMER_KICK_PERIOD pdMS_TO_TICKS(10000)
+#define TIMER_KICK_PRIORITY (tskIDLE_PRIORITY + 1)
+
+#define TIMER_TICK_NS (1000000000ULL / configTICK_RATE_HZ)
+
+/* Delays, in ticks, the lateness is measured for */
+static const TickType_t timer_delays[] = { 1, 10 };
+#define TIMER_DELAY_STEPS (sizeof(timer_delays) / sizeof(timer_delays[0]))
+
+static uint64_t delay_lateness[TIMER_DELAY_ITERATIONS];
+static uint64_t timer_jitter[TIMER_EXPIRIES];
+static uint64_t timer_last_expiry;
+static unsigned int timer_expiries;
+
+static TimerHandle_t many_timers[TIMER_MANY_COUNT];
+static volatile unsigned int many_expiries;
+static volatile TickType_t many_max_lateness;
+
+static TimerHandle_t kick_timers[TIMER_KICK_TIMERS];
+static TimerCommand_t kick_commands[TIMER_KICK_TIMERS];
+static uint64_t kick_elapsed;
+
+/* Time from a delay's nominal expiry until the delayed task runs again */
+static void benchTimerDelay(TickType_t ticks)
+{
+    const uint64_t nominal = (uint64_t)ticks * TIMER_TICK_NS;
+    uint64_t start, elapsed;
+    char metric[48];
+    int i;
+
+    for (i = 0; i < TIMER_DELAY_ITERATIONS; i++) {
+        /* Start right after a tick, so the delay ends on a tick boundary */
+        vTaskDelay(1);
+        start = benchNow();
+
+        vTaskDelay(ticks);
+
+        elapsed = benchNow() - start;
+        delay_lateness[i] = elapsed > nominal ? elapsed - nominal : 0;
+    }
+
+    snprintf(metric, sizeof(metric), "delay_%lu_ticks_lateness",
+             (unsigned long)ticks);
+    benchReportDistribution("timer", metric, delay_lateness,
+                            TIMER_DELAY_ITERATIONS, "ns");
+}
+
+/* Runs in the timer service task, records how far each period strays */
+static void vJitterTimerCallback(TimerHandle_t xTimer)
+{
+    const uint64_t nominal = TIMER_PERIOD_TICKS * TIMER_TICK_NS;
+    uint64_t now = benchNow(), interval;
+
+    if (timer_expiries) {
+        interval = now - timer_last_expiry;
+        timer_jitter[timer_expiries - 1] =
+            interval > nominal ? interval - nominal : nominal - interval;
+    }
+    timer_last_expiry = now;
+
+    if (++timer_expiries > TIMER_EXPIRIES) {
+        xTimerStop(xTimer, 0);
+        benchSignalDone();
+    }
+}
+
+static void benchTimerJitter(void)
+{
+    TimerHandle_t timer;
+
+    timer_expiries = 0;
+    timer = xTimerCreate("Jitter", TIMER_PERIOD_TICKS, pdTRUE, NULL,
+                         vJitterTimerCallback);
+    if (timer == NULL || xTimerStart(timer, portMAX_DELAY) != pdPASS) {
+        return;
+    }
+
+    benchWaitDone(1);
+    xTimerDelete(timer, portMAX_DELAY);
+
+    benchReportDistribution("timer", "software_timer_jitter", timer_jitter,
+                            TIMER_EXPIRIES, "ns");
+}
+
+/* CPU time the timer service task has taken so far */
+static uint64_t benchTimerDaemonTime(void)
+{
+    TaskStatus_t status;
+
+    vTaskGetInfo(xTimerGetTimerDaemonTaskHandle(), &status, pdFALSE,
+                 eInvalid);
+    return status.ulRunTimeCounter;
+}
+
+/* The timer is reloaded before its callback runs, so it was due a period
+ * before its expiry time */
+static void vManyTimerCallback(TimerHandle_t xTimer)
+{
+    TickType_t lateness = xTaskGetTickCount() -
+                          (xTimerGetExpiryTime(xTimer) - xTimerGetPeriod(xTimer));
+
+    if (lateness > many_max_lateness) {
+        many_max_lateness = lateness;
+    }
+    many_expiries++;
+}
+
+/* Issues a start or reset for every timer, the controller runs at the timer
+ * service task's priority so the commands are handled once the timer queue is
+ * full, and reports the time per command and the service task's share */
+static void benchTimerManyCommand(BaseType_t reset, const char *name)
+{
+    uint64_t start, elapsed, daemon;
+    char metric[48];
+    unsigned int i;
+
+    daemon = benchTimerDaemonTime();
+    start = benchNow();
+    for (i = 0; i < TIMER_MANY_COUNT; i++) {
+        if (reset) {
+            xTimerReset(many_timers[i], portMAX_DELAY);
+        }
+        else {
+            xTimerStart(many_timers[i], portMAX_DELAY);
+        }
+    }
+    /* Let the service task empty the queue */
+    vTaskDelay(1);
+    elapsed = benchNow() - start;
+    daemon = benchTimerDaemonTime() - daemon;
+
+    snprintf(metric, sizeof(metric), "many_%s_ns", name);
+    benchReport("timer", metric, (double)elapsed / TIMER_MANY_COUNT, "ns");
+    snprintf(metric, sizeof(metric), "many_daemon_ns_per_%s", name);
+    benchReport("timer", metric, (double)daemon / TIMER_MANY_COUNT, "ns");
+}
+
+/* Keeps TIMER_MANY_COUNT timers running, what each start, reset and expiry
+ * costs the timer service task shows how it scales with the active timers */
+static void benchTimerMany(void)
+{
+    uint64_t daemon;
+    unsigned int i, created;
+
+    for (created = 0; created < TIMER_MANY_COUNT; created++) {
+        many_timers[created] = xTimerCreate(
+            "Many", TIMER_MANY_MIN_PERIOD +
+            (created * 7919U) % TIMER_MANY_PERIOD_SPREAD, pdTRUE, NULL,
+            vManyTimerCallback);
+        if (many_timers[created] == NULL) {
+            break;
+        }
+    }
+
+    if (created == TIMER_MANY_COUNT) {
+        benchTimerManyCommand(pdFALSE, "start");
+
+        many_expiries = 0;
+        many_max_lateness = 0;
+        daemon = benchTimerDaemonTime();
+        vTaskDelay(TIMER_MANY_RUN_TICKS);
+        daemon = benchTimerDaemonTime() - daemon;
+
+        benchReport("timer", "many_active", TIMER_MANY_COUNT, "1");
+        benchReport("timer", "many_expiries", many_expiries, "1");
+        if (many_expiries) {
+            benchReport("timer", "many_daemon_ns_per_expiry",
+                        (double)daemon / many_expiries, "ns");
+        }
+        benchReport("timer", "many_max_lateness", many_max_lateness,
+                    "ticks");
+
+        benchTimerManyCommand(pdTRUE, "reset");
+    }
+
+    for (i = 0; i < created; i++) {
+        xTimerDelete(many_timers[i], portMAX_DELAY);
+    }
+    vTaskDelay(1);
+}
+
+static void vKickTimerCallback(TimerHandle_t xTimer)
+{
+    fprintf(stderr, "[ERROR] watchdog timer %s expired\n",
+            pcTimerGetName(xTimer));
+}
+
+static void vKickWorker(void *pvParameters)
+{
+    const BaseType_t batch = (BaseType_t)(uintptr_t)pvParameters;
+    uint64_t start;
+    unsigned int round, i;
+
+    start = benchNow();
+    for (round = 0; round < TIMER_KICK_ROUNDS; round++) {
+        if (batch) {
+            uxTimerSendCommandBatch(kick_commands, TIMER_KICK_TIMERS,
+                                    portMAX_DELAY);
+        }
+        else {
+            for (i = 0; i < TIMER_KICK_TIMERS; i++) {
+                xTimerReset(kick_timers[i], portMAX_DELAY);
+            }
+        }
+    }
+    kick_elapsed = benchNow() - start;
+
+    benchSignalDone();
+    vTaskDelete(NULL);
+}
+
+/* Time per reset from a task the timer service task preempts, which a queued
+ * command wakes once per command or, batched, once per queue full */
+static void benchTimerKick(void)
+{
+    static const char *const kick_names[] = { "kick_single_ns",
+                                              "kick_batch_ns"
+                                            };
+    unsigned int created, i;
+    BaseType_t batch;
+
+    for (created = 0; created < TIMER_KICK_TIMERS; created++) {
+        kick_timers[created] = xTimerCreate("Kick", TIMER_KICK_PERIOD, pdFALSE,
+                                            NULL, vKickTimerCallback);
+        if (kick_timers[created] == NULL) {
+            break;
+        }
+        kick_commands[created].xTimer = kick_timers[created];
+        kick_commands[created].xCommandID = tmrCOMMAND_START;
+    }
+
+    if (created == TIMER_KICK_TIMERS &&
+        uxTimerSendCommandBatch(kick_commands, TIMER_KICK_TIMERS,
+                                portMAX_DELAY) == TIMER_KICK_TIMERS) {
+        for (i = 0; i < TIMER_KICK_TIMERS; i++) {
+            kick_commands[i].xCommandID = tmrCOMMAND_RESET;
+        }
+
+        for (batch = pdFALSE; batch <= pdTRUE; batch++) {
+            xTaskCreate(vKickWorker, "Kick", BENCH_STACK_SIZE,
+                        (void *)(uintptr_t)batch, TIMER_KICK_PRIORITY, NULL);
+            benchWaitDone(1);
+            benchReport("timer", kick_names[batch],
+                        (double)kick_elapsed /
+                        (TIMER_KICK_ROUNDS * TIMER_KICK_TIMERS), "ns");
+        }
+    }
+
+    for (i = 0; i < created; i++) {
+        kick_commands[i].xCommandID = tmrCOMMAND_DELETE;
+    }
+    uxTimerSendCommandBatch(kick_commands, created, portMAX_DELAY);
+    vTaskDelay(1);
+}
+
+void benchTimer(void)
+{
+    unsigned int step;
+
+    for (step = 0; step < TIMER_DELAY_STEPS; step++) {
+        benchTimerDelay(timer_delays[step]);
+    }
+    benchTimerJitter();
+    benchTimerMany();
+    benchTimerKick();
+}
@@ -0,0 +1,148 @@
+/**
+ * @file bench.h
+ * @brief Headless micro benchmarks for the FreeRTOS POSIX port
+ *
+ * @verbatim
+ ----------------------------------------------------------------------
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ----------------------------------------------------------------------
+ @endverbatim
+ */
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <stdint.h>
+
+/**
+ * @defgroup bench Benchmark API
+ *
+ * @brief Helpers shared by the benchmark suites
+ *
+ * Every suite is run from a controller task at the highest priority. A suite
+ * creates its worker tasks, waits for them with benchWaitDone() and reports
+ * its results with benchReport(), one CSV line per metric.
+ *
+ * @{
+ */
+
+/**
+ * @brief Priority the controller task runs at, workers must stay below it
+ */
+#define BENCH_CONTROLLER_PRIORITY (configMAX_PRIORITIES - 1)
+
+/**
+ * @brief Stack depth used for worker tasks
+ */
+#define BENCH_STACK_SIZE ((unsigned short)8192)
+
+/**
+ * @brief A benchmark suite, run in the context of the controller task
+ */
+typedef struct bench_suite {
+    const char *name; /**< Name used to select the suite on the command line */
+    void (*run)(void); /**< Runs the suite and reports its results */
+} bench_suite_t;
+
+/**
+ * @brief Returns a monotonic timestamp in nanoseconds
+ */
+uint64_t benchNow(void);
+
+/**
+ * @brief Reports a single result
+ *
+ * @param suite Name of the suite producing the result
+ * @param metric Name of the measured metric
+ * @param value Measured value
+ * @param unit Unit of the value
+ */
+void benchReport(const char *suite, const char *metric, double value,
+                 const char *unit);
+
+/**
+ * @brief Reports the min, average, median, 99th percentile and max of a set
+ * of samples, as metric_min, metric_avg, metric_p50, metric_p99 and metric_max
+ *
+ * @param suite Name of the suite producing the result
+ * @param metric Name prefix of the reported metrics
+ * @param samples Measured samples, sorted in place
+ * @param count Number of samples
+ * @param unit Unit of the samples
+ */
+void benchReportDistribution(const char *suite, const char *metric,
+                             uint64_t *samples, unsigned int count,
+                             const char *unit);
+
+/**
+ * @brief Signals the controller that a worker has finished
+ *
+ * Workers call this once done and then delete themselves.
+ */
+void benchSignalDone(void);
+
+/**
+ * @brief Blocks the controller until a number of workers have finished
+ *
+ * @param count Number of benchSignalDone() calls to wait for
+ */
+void benchWaitDone(unsigned int count);
+
+/**
+ * @name Benchmark suites
+ *
+ * @{
+ */
+void benchSwitch(void);
+void benchTick(void);
+void benchIdle(void);
+void benchTimebase(void);
+void benchRuntime(void);
+void benchStartup(void);
+void benchLifecycle(void);
+void benchStack(void);
+void benchSmp(void);
+void benchIrq(void);
+void benchSync(void);
+void benchQstats(void);
+void benchQueue(void);
+void benchStream(void);
+void benchTimer(void);
+void benchDelay(void);
+void benchHeap(void);
+/** @} */
+
+/**
+ * @brief First argument that makes the benchmark print its results as JSON
+ * lines of the form {"suite":...,"metric":...,"value":...,"unit":...}
+ */
+#define BENCH_JSON_ARG "--json"
+
+/**
+ * @brief First argument that makes the benchmark run a single startup
+ * measurement for benchStartup() instead of the suites
+ */
+#define BENCH_STARTUP_ARG "--startup"
+
+/**
+ * @brief Creates the requested number of tasks, starts the scheduler and
+ * reports the elapsed times to benchStartup()
+ *
+ * @param argc Argument count as passed to main()
+ * @param argv BENCH_STARTUP_ARG, the task count and the file descriptor to
+ * report to
+ * @return Only returns on failure
+ */
+int benchStartupMain(int argc, char *argv[]);
+
+/** @} */
+#endif // __BENCH_H__
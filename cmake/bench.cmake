@@ -0,0 +1,74 @@
+# ------------------------------------------------------------------------------
+# Benchmarks
+# ------------------------------------------------------------------------------
+
+if(ENABLE_BENCH)
+
+    SET(BENCH_INCLUDES ${PROJECT_SOURCE_DIR}/bench/include)
+
+    file(GLOB BENCH_SOURCES "${PROJECT_SOURCE_DIR}/bench/*.c")
+
+    set(BENCH_LIBRARIES
+        m
+        ${CMAKE_THREAD_LIBS_INIT}
+        rt
+    )
+
+    # The benchmarks need only the kernel and the port, the variants are built
+    # against their own copy configured through the given definitions
+    freertos_add_bench("")
+
+    # Same benchmarks on the signal based switch backend, for comparison
+    freertos_add_bench(_signal configPOSIX_SWITCH_BACKEND=portSWITCH_SIGNAL)
+
+    # Checks that the tick source holds a 10 kHz tick rate
+    freertos_add_bench(_10khz configTICK_RATE_HZ=10000)
+
+    # Virtual time, runs as fast as the tasks allow and repeats exactly
+    freertos_add_bench(_virtual configPOSIX_TICK_SOURCE=portTICK_SOURCE_VIRTUAL)
+
+    # Four emulated cores, for the throughput of the smp suite
+    freertos_add_bench(_smp configNUMBER_OF_CORES=4)
+
+    # 256 priorities, tasks selected through the port's bitmap and by walking
+    # the ready lists
+    freertos_add_bench(_prio256 configMAX_PRIORITIES=256)
+    freertos_add_bench(_prio256_generic configMAX_PRIORITIES=256
+        configUSE_PORT_OPTIMISED_TASK_SELECTION=0)
+
+    # Software timers kept in the sorted lists instead of the timing wheel
+    freertos_add_bench(_timerlist configUSE_TIMER_WHEEL=0)
+
+    # Every timer command through the timer queue, also where it could be
+    # applied directly
+    freertos_add_bench(_timerqueue configUSE_TIMER_DIRECT_COMMANDS=0)
+
+    # Delayed tasks kept in the kernel's sorted lists
+    freertos_add_bench(_delaylist configUSE_DELAYED_TASK_WHEEL=0)
+
+    # Queues, semaphores and mutexes without the statistics, for their cost
+    freertos_add_bench(_noqueuestats configUSE_QUEUE_STATS=0)
+
+    add_custom_target(
+        bench
+        COMMAND ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/${CMAKE_PROJECT_NAME}_bench
+        COMMAND ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/${CMAKE_PROJECT_NAME}_bench_signal
+        COMMAND ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/${CMAKE_PROJECT_NAME}_bench_10khz tick
+        COMMAND ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/${CMAKE_PROJECT_NAME}_bench_virtual timebase
+        COMMAND ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/${CMAKE_PROJECT_NAME}_bench_smp smp
+        COMMAND ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/${CMAKE_PROJECT_NAME}_bench_prio256 switch
+        COMMAND ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/${CMAKE_PROJECT_NAME}_bench_prio256_generic switch
+        COMMAND ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/${CMAKE_PROJECT_NAME}_bench_timerlist timer
+        COMMAND ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/${CMAKE_PROJECT_NAME}_bench_timerqueue timer
+        COMMAND ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/${CMAKE_PROJECT_NAME}_bench_delaylist delay
+        COMMAND ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/${CMAKE_PROJECT_NAME}_bench_noqueuestats sync qstats queue
+        # Switch latencies again with the threads pinned to the first CPU and,
+        # where permitted, on SCHED_FIFO
+        COMMAND ${CMAKE_COMMAND} -E env FREERTOS_TASK_CPUS=0 FREERTOS_TICK_CPUS=0
+                FREERTOS_SCHED_FIFO=10
+                ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/${CMAKE_PROJECT_NAME}_bench switch
+        DEPENDS ${BENCH_TARGETS}
+        COMMENT "running benchmarks"
+    )
+
+endif()
@@ -0,0 +1,49 @@
+# ------------------------------------------------------------------------------
+# FreeRTOS kernel and POSIX port
+# ------------------------------------------------------------------------------
+
+# heap_6 is the pool allocator, heap_3 forwards to malloc(), heap_4 and heap_5
+# are bounded by configTOTAL_HEAP_SIZE
+set(FREERTOS_HEAP 6 CACHE STRING "Heap implementation, portable/MemMang/heap_<N>.c")
+
+file(GLOB FREERTOS_KERNEL_SOURCES "${PROJECT_SOURCE_DIR}/lib/FreeRTOS_Kernel/*.c")
+list(APPEND FREERTOS_KERNEL_SOURCES
+    "${PROJECT_SOURCE_DIR}/lib/FreeRTOS_Kernel/portable/MemMang/heap_${FREERTOS_HEAP}.c")
+file(GLOB FREERTOS_PORT_SOURCES
+    "${PROJECT_SOURCE_DIR}/lib/FreeRTOS_Kernel/portable/GCC/Posix/*.c")
+
+# Builds freertos_kernel<SUFFIX> and freertos_posix_port<SUFFIX>, any further
+# arguments are definitions that override FreeRTOSConfig.h and are passed on to
+# everything linking the pair. The kernel and the port call into each other,
+# CMake repeats the two static libraries on the link line to resolve that.
+function(freertos_add_libraries SUFFIX)
+    add_library(freertos_kernel${SUFFIX} STATIC ${FREERTOS_KERNEL_SOURCES})
+    add_library(freertos_posix_port${SUFFIX} STATIC ${FREERTOS_PORT_SOURCES})
+
+    if(ARGN)
+        target_compile_definitions(freertos_kernel${SUFFIX} PUBLIC ${ARGN})
+        target_compile_definitions(freertos_posix_port${SUFFIX} PUBLIC ${ARGN})
+    endif()
+
+    target_link_libraries(freertos_kernel${SUFFIX} freertos_posix_port${SUFFIX})
+    target_link_libraries(freertos_posix_port${SUFFIX} freertos_kernel${SUFFIX}
+        ${CMAKE_THREAD_LIBS_INIT} rt)
+endfunction()
+
+# Builds the benchmarks as ${CMAKE_PROJECT_NAME}_bench<SUFFIX> against their own
+# freertos_kernel<SUFFIX>, configured by any further arguments as for
+# freertos_add_libraries(). The default libraries are used as they are for an
+# empty suffix. The target is appended to BENCH_TARGETS, which the bench target
+# depends on.
+function(freertos_add_bench SUFFIX)
+    if(NOT "${SUFFIX}" STREQUAL "")
+        freertos_add_libraries(${SUFFIX} ${ARGN})
+    endif()
+
+    set(TARGET ${CMAKE_PROJECT_NAME}_bench${SUFFIX})
+    add_executable(${TARGET} ${BENCH_SOURCES})
+    target_include_directories(${TARGET} PRIVATE ${BENCH_INCLUDES})
+    target_link_libraries(${TARGET} freertos_kernel${SUFFIX} ${BENCH_LIBRARIES})
+
+    set(BENCH_TARGETS ${BENCH_TARGETS} ${TARGET} PARENT_SCOPE)
+endfunction()
@@ -5,6 +5,7 @@ SET(CHECK_FILES
     ${PROJECT_SOURCE_DIR}/include/*.h
     ${PROJECT_SOURCE_DIR}/lib/Gfx/include/*.h
     ${PROJECT_SOURCE_DIR}/lib/Gfx/*.c
+    ${PROJECT_SOURCE_DIR}/lib/Gfx/headless/*.c
     ${PROJECT_SOURCE_DIR}/lib/AsyncIO/include/*.h
     ${PROJECT_SOURCE_DIR}/lib/AsyncIO/*.c
     ${PROJECT_SOURCE_DIR}/src/*.c)
@@ -69,13 +69,30 @@
 #define configUSE_PREEMPTION            1
 #define configUSE_IDLE_HOOK             1
 #define configUSE_TICK_HOOK             0
+#ifndef configNUMBER_OF_CORES
+#define configNUMBER_OF_CORES           1 /* More than one needs the POSIX port's condition variable switch and tick thread. */
+#endif
+#ifndef configUSE_TICKLESS_IDLE
+#if ( configNUMBER_OF_CORES > 1 )
+#define configUSE_TICKLESS_IDLE         0 /* The idle tasks of the other cores would have to agree on the sleep. */
+#else
+#define configUSE_TICKLESS_IDLE         1 /* Only with the POSIX port's tick thread. */
+#endif
+#endif
+#ifndef configTICK_RATE_HZ
 #define configTICK_RATE_HZ              ( ( TickType_t ) 1000 )
-#define configMINIMAL_STACK_SIZE        ( ( unsigned short ) 4 ) /* This can be made smaller if required. */
+#endif
+#ifndef configUSE_DELAYED_TASK_WHEEL
+#define configUSE_DELAYED_TASK_WHEEL    1 /* Blocking a task for a time costs the same however many are delayed. */
+#endif
+#define configMINIMAL_STACK_SIZE        ( ( unsigned short ) 4096 ) /* In 4 byte words. The POSIX port runs each task on exactly the stack it asks for, nested signal frames can take half of this one. */
+#define configSTACK_ALLOCATION_FROM_SEPARATE_HEAP 1 /* The POSIX port maps each task stack with a guard page. */
 #define configTOTAL_HEAP_SIZE           ( ( size_t ) ( 32 * 1024 ) )
 #define configMAX_TASK_NAME_LEN         ( 16 )
 #define configUSE_TRACE_FACILITY        1
 #define configUSE_STATS_FORMATTING_FUNCTIONS 1
 #define configGENERATE_RUN_TIME_STATS   1
+#define configRUN_TIME_COUNTER_TYPE     uint64_t /* Nanoseconds of CPU time with the POSIX port. */
 #define configUSE_16_BIT_TICKS          0
 #define configIDLE_SHOULD_YIELD         1
 #define configUSE_CO_ROUTINES           1
@@ -84,12 +101,29 @@
 #define configUSE_COUNTING_SEMAPHORES   1
 #define configUSE_ALTERNATIVE_API       0
 #define configUSE_RECURSIVE_MUTEXES     1
-#define configCHECK_FOR_STACK_OVERFLOW  0 /* Do not use this option on the PC port. */
+#define configUSE_QUEUE_ZERO_COPY       1 /* xQueueReserve() and xQueueBorrow() hand out queue slots to fill and read in place. */
+#define configCHECK_FOR_STACK_OVERFLOW  2
 #define configUSE_APPLICATION_TASK_TAG  1
-#define configQUEUE_REGISTRY_SIZE       0
+#define configQUEUE_REGISTRY_SIZE       16
+#ifndef configUSE_QUEUE_STATS
+#define configUSE_QUEUE_STATS           1 /* Counts and blocked times of every queue, semaphore and mutex, see vQueueGetStatsList(). */
+#endif
+#define configQUEUE_STATS_SIZE          32
+#define configUSE_TIMERS                1
+#define configTIMER_TASK_PRIORITY       ( configMAX_PRIORITIES - 1 )
+#define configTIMER_QUEUE_LENGTH        10
+#define configTIMER_TASK_STACK_DEPTH    configMINIMAL_STACK_SIZE
+#ifndef configUSE_TIMER_WHEEL
+#define configUSE_TIMER_WHEEL           1 /* Starting and stopping a timer costs the same however many are active. */
+#endif
+#ifndef configUSE_TIMER_DIRECT_COMMANDS
+#define configUSE_TIMER_DIRECT_COMMANDS configUSE_TIMER_WHEEL /* Timer commands skip the queue while the timer service task leaves the wheel alone. */
+#endif
 #define configMAX_SYSCALL_INTERRUPT_PRIORITY    1
 
-#define configMAX_PRIORITIES        ( 10 )
+#ifndef configMAX_PRIORITIES
+#define configMAX_PRIORITIES        ( 10 ) /* Selected through a bitmap, more priorities cost no time per switch. */
+#endif
 #define configMAX_CO_ROUTINE_PRIORITIES ( 2 )
 
 /* Set the following definitions to 1 to include the API function, or zero
@@ -102,11 +136,10 @@
 #define INCLUDE_vTaskSuspend                1
 #define INCLUDE_vTaskDelayUntil             1
 #define INCLUDE_vTaskDelay                  1
-#define INCLUDE_uxTaskGetStackHighWaterMark 0 /* Do not use this option on the PC port. */
+#define INCLUDE_uxTaskGetStackHighWaterMark 1
 #define INCLUDE_xTaskGetSchedulerState      1
-
-extern void vMainQueueSendPassed(void);
-#define traceQUEUE_SEND( pxQueue ) vMainQueueSendPassed()
+#define INCLUDE_xTaskGetIdleTaskHandle      1
+#define INCLUDE_xTaskAbortDelay             1
 
 #define configGENERATE_RUN_TIME_STATS       1
 
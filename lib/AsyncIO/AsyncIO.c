@@ -414,12 +414,14 @@ aIO_handle_t aIOOpenMessageQueue(char *name, long max_msg_num,
     return (aIO_handle_t)conn->next;
 
 error_notify:
+    mq_close(mq->fd);
 error_open:
     free(mq->name);
 error_name:
+    pthread_mutex_unlock(&conn->next->lock);
+    free(conn->next->buffer);
     free(conn->next);
     conn->next = NULL;
-    pthread_mutex_unlock(&conn->next->lock);
 error_IO:
     return NULL;
 }
@@ -563,9 +565,10 @@ aIO_handle_t aIOOpenUDPSocket(char *s_addr, in_port_t port, size_t buffer_size,
 error_fcntl:
     close(s_udp->fd);
 error_socket:
+    pthread_mutex_unlock(&conn->next->lock);
+    free(conn->next->buffer);
     free(conn->next);
     conn->next = NULL;
-    pthread_mutex_unlock(&conn->next->lock);
 error_IO:
     return NULL;
 }
@@ -690,9 +693,10 @@ aIO_handle_t aIOOpenTCPSocket(char *s_addr, in_port_t port, size_t buffer_size,
 error_fcntl:
     close(s_tcp->fd);
 error_socket:
+    pthread_mutex_unlock(&conn->next->lock);
+    free(conn->next->buffer);
     free(conn->next);
     conn->next = NULL;
-    pthread_mutex_unlock(&conn->next->lock);
 error_IO:
     PRINT_CHECK;
     return NULL;
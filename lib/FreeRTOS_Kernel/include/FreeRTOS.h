@@ -100,6 +100,12 @@ extern "C" {
 /* Basic FreeRTOS definitions. */
 #include "projdefs.h"
 
+/* Must be defaulted before the port is included, as the port layer sizes some
+of its state by it. */
+#ifndef configNUMBER_OF_CORES
+#define configNUMBER_OF_CORES 1
+#endif
+
 /* Definitions specific to the port being used. */
 #include "portable.h"
 
@@ -330,6 +336,23 @@ extern "C" {
 #define portPOINTER_SIZE_TYPE uint32_t
 #endif
 
+#ifndef configUSE_QUEUE_STATS
+#define configUSE_QUEUE_STATS 0
+#endif
+
+#if ( configUSE_QUEUE_STATS == 1 )
+#if ( configUSE_TRACE_FACILITY != 1 )
+#error configUSE_QUEUE_STATS needs configUSE_TRACE_FACILITY set to 1.
+#endif
+
+#ifndef configQUEUE_STATS_SIZE
+#define configQUEUE_STATS_SIZE 16U
+#endif
+
+/* Defines the queue trace macros, so those are not removed below. */
+#include "queue_stats.h"
+#endif /* configUSE_QUEUE_STATS */
+
 /* Remove any unused trace macros. */
 #ifndef traceSTART
 /* Used to perform any necessary initialisation - for example, open a file
@@ -462,6 +485,12 @@ task that attempted the write. */
 #define traceQUEUE_SEND( pxQueue )
 #endif
 
+#ifndef traceQUEUE_SET_SEND
+/* A queue that is a member of a set notifying the set, from a task or an
+interrupt. */
+#define traceQUEUE_SET_SEND traceQUEUE_SEND
+#endif
+
 #ifndef traceQUEUE_SEND_FAILED
 #define traceQUEUE_SEND_FAILED( pxQueue )
 #endif
@@ -634,6 +663,58 @@ task that attempted the write. */
 #define traceTASK_NOTIFY_TAKE_BLOCK()
 #endif
 
+#ifndef traceSTREAM_BUFFER_CREATE_FAILED
+#define traceSTREAM_BUFFER_CREATE_FAILED( xIsMessageBuffer )
+#endif
+
+#ifndef traceSTREAM_BUFFER_CREATE_STATIC_FAILED
+#define traceSTREAM_BUFFER_CREATE_STATIC_FAILED( xReturn, xIsMessageBuffer )
+#endif
+
+#ifndef traceSTREAM_BUFFER_CREATE
+#define traceSTREAM_BUFFER_CREATE( pxStreamBuffer, xIsMessageBuffer )
+#endif
+
+#ifndef traceSTREAM_BUFFER_DELETE
+#define traceSTREAM_BUFFER_DELETE( xStreamBuffer )
+#endif
+
+#ifndef traceSTREAM_BUFFER_RESET
+#define traceSTREAM_BUFFER_RESET( xStreamBuffer )
+#endif
+
+#ifndef traceBLOCKING_ON_STREAM_BUFFER_SEND
+#define traceBLOCKING_ON_STREAM_BUFFER_SEND( xStreamBuffer )
+#endif
+
+#ifndef traceSTREAM_BUFFER_SEND
+#define traceSTREAM_BUFFER_SEND( xStreamBuffer, xBytesSent )
+#endif
+
+#ifndef traceSTREAM_BUFFER_SEND_FAILED
+#define traceSTREAM_BUFFER_SEND_FAILED( xStreamBuffer )
+#endif
+
+#ifndef traceSTREAM_BUFFER_SEND_FROM_ISR
+#define traceSTREAM_BUFFER_SEND_FROM_ISR( xStreamBuffer, xBytesSent )
+#endif
+
+#ifndef traceBLOCKING_ON_STREAM_BUFFER_RECEIVE
+#define traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( xStreamBuffer )
+#endif
+
+#ifndef traceSTREAM_BUFFER_RECEIVE
+#define traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xReceivedLength )
+#endif
+
+#ifndef traceSTREAM_BUFFER_RECEIVE_FAILED
+#define traceSTREAM_BUFFER_RECEIVE_FAILED( xStreamBuffer )
+#endif
+
+#ifndef traceSTREAM_BUFFER_RECEIVE_FROM_ISR
+#define traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xReceivedLength )
+#endif
+
 #ifndef traceTASK_NOTIFY_TAKE
 #define traceTASK_NOTIFY_TAKE()
 #endif
@@ -676,6 +757,12 @@ task that attempted the write. */
 
 #endif /* configGENERATE_RUN_TIME_STATS */
 
+#ifndef configRUN_TIME_COUNTER_TYPE
+/* Defaults to uint32_t for backward compatibility, can be overridden in
+FreeRTOSConfig.h if the run time counter wraps too quickly. */
+#define configRUN_TIME_COUNTER_TYPE uint32_t
+#endif
+
 #ifndef portCONFIGURE_TIMER_FOR_RUN_TIME_STATS
 #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
 #endif
@@ -720,6 +807,38 @@ task that attempted the write. */
 #define configUSE_QUEUE_SETS 0
 #endif
 
+#ifndef configUSE_QUEUE_ZERO_COPY
+#define configUSE_QUEUE_ZERO_COPY 0
+#endif
+
+#ifndef configUSE_TIMER_WHEEL
+#define configUSE_TIMER_WHEEL 0
+#endif
+
+#ifndef configUSE_DELAYED_TASK_WHEEL
+#define configUSE_DELAYED_TASK_WHEEL 0
+#endif
+
+#ifndef configUSE_TIMER_DIRECT_COMMANDS
+#define configUSE_TIMER_DIRECT_COMMANDS 0
+#endif
+
+#if ( configUSE_TIMER_DIRECT_COMMANDS == 1 ) && ( ( configUSE_TIMER_WHEEL == 0 ) || ( INCLUDE_xTaskAbortDelay == 0 ) )
+#error configUSE_TIMER_DIRECT_COMMANDS needs configUSE_TIMER_WHEEL and INCLUDE_xTaskAbortDelay set to 1.
+#endif /* configUSE_TIMER_DIRECT_COMMANDS */
+
+#ifndef configMESSAGE_BUFFER_LENGTH_TYPE
+#define configMESSAGE_BUFFER_LENGTH_TYPE size_t
+#endif
+
+#ifndef portMEMORY_BARRIER
+#define portMEMORY_BARRIER()
+#endif
+
+#ifndef configMIN
+#define configMIN( a, b ) ( ( ( a ) < ( b ) ) ? ( a ) : ( b ) )
+#endif
+
 #ifndef portTASK_USES_FLOATING_POINT
 #define portTASK_USES_FLOATING_POINT()
 #endif
@@ -760,6 +879,10 @@ task that attempted the write. */
 #define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
 #endif
 
+#ifndef portGET_CORE_ID
+#define portGET_CORE_ID() ( ( BaseType_t ) 0 )
+#endif
+
 #ifndef configAPPLICATION_ALLOCATED_HEAP
 #define configAPPLICATION_ALLOCATED_HEAP 0
 #endif
@@ -793,6 +916,15 @@ task that attempted the write. */
 #error configSUPPORT_STATIC_ALLOCATION and configSUPPORT_DYNAMIC_ALLOCATION cannot both be 0, but can both be 1.
 #endif
 
+#if( configNUMBER_OF_CORES > 1 )
+#if !defined( portYIELD_CORE ) || !defined( portGET_TASK_LOCK ) || !defined( portRELEASE_TASK_LOCK )
+#error configNUMBER_OF_CORES is greater than 1 but the port does not define portYIELD_CORE, portGET_TASK_LOCK and portRELEASE_TASK_LOCK
+#endif
+#if( configUSE_TICKLESS_IDLE != 0 )
+#error The other cores keep running while the idle task would stop the tick, set configUSE_TICKLESS_IDLE to 0 when configNUMBER_OF_CORES is greater than 1
+#endif
+#endif /* configNUMBER_OF_CORES */
+
 #if( ( configUSE_RECURSIVE_MUTEXES == 1 ) && ( configUSE_MUTEXES != 1 ) )
 #error configUSE_MUTEXES must be set to 1 to use recursive mutexes
 #endif
@@ -933,7 +1065,7 @@ typedef struct xSTATIC_TCB {
     void            *pvDummy15[ configNUM_THREAD_LOCAL_STORAGE_POINTERS ];
 #endif
 #if ( configGENERATE_RUN_TIME_STATS == 1 )
-    uint32_t        ulDummy16;
+    configRUN_TIME_COUNTER_TYPE ulDummy16;
 #endif
 #if ( configUSE_NEWLIB_REENTRANT == 1 )
     struct  _reent  xDummy17;
@@ -945,6 +1077,13 @@ typedef struct xSTATIC_TCB {
 #if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
     uint8_t         uxDummy20;
 #endif
+#if( configNUMBER_OF_CORES > 1 )
+    BaseType_t      xDummy21;
+    UBaseType_t     uxDummy22;
+#endif
+#if( configUSE_QUEUE_STATS == 1 )
+    QueueStatsWait_t xDummy23;
+#endif
 
 } StaticTask_t;
 
@@ -987,6 +1126,14 @@ typedef struct xSTATIC_QUEUE {
     uint8_t ucDummy9;
 #endif
 
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+    void *pvDummy10[ 2 ];
+#endif
+
+#if ( configUSE_QUEUE_STATS == 1 )
+    void *pvDummy11;
+#endif
+
 } StaticQueue_t;
 typedef StaticQueue_t StaticSemaphore_t;
 
@@ -1048,6 +1195,32 @@ typedef struct xSTATIC_TIMER {
 
 } StaticTimer_t;
 
+/*
+ * In line with software engineering best practice, especially when supplying a
+ * library that is likely to change in future versions, FreeRTOS implements a
+ * strict data hiding policy.  This means the stream buffer structure used
+ * internally by FreeRTOS is not accessible to application code.  However, if
+ * the application writer wants to statically allocate the memory required to
+ * create a stream buffer then the size of the stream buffer object needs to be
+ * known.  The StaticStreamBuffer_t structure below is provided for this
+ * purpose.  Its size and alignment requirements are guaranteed to match those
+ * of the genuine structure, no matter which architecture is being used, and no
+ * matter how the values in FreeRTOSConfig.h are set.  Its contents are somewhat
+ * obfuscated in the hope users will recognise that it would be unwise to make
+ * direct use of the structure members.
+ */
+typedef struct xSTATIC_STREAM_BUFFER {
+    size_t              uxDummy1[ 4 ];
+    void                *pvDummy2[ 3 ];
+    uint8_t             ucDummy3;
+#if( configUSE_TRACE_FACILITY == 1 )
+    UBaseType_t         uxDummy4;
+#endif
+} StaticStreamBuffer_t;
+
+/* Message buffers are built on stream buffers. */
+typedef StaticStreamBuffer_t StaticMessageBuffer_t;
+
 #ifdef __cplusplus
 }
 #endif
@@ -126,6 +126,10 @@ must be set in the compiler's include path. */
 #define portNUM_CONFIGURABLE_REGIONS 1
 #endif
 
+#ifndef portHAS_STACK_OVERFLOW_CHECKING
+#define portHAS_STACK_OVERFLOW_CHECKING 0
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -139,10 +143,18 @@ extern "C" {
  *
  */
 #if( portUSING_MPU_WRAPPERS == 1 )
+#if( portHAS_STACK_OVERFLOW_CHECKING == 1 )
+StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack, StackType_t *pxEndOfStack, TaskFunction_t pxCode, void *pvParameters, BaseType_t xRunPrivileged) PRIVILEGED_FUNCTION;
+#else
 StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters, BaseType_t xRunPrivileged) PRIVILEGED_FUNCTION;
+#endif
+#else
+#if( portHAS_STACK_OVERFLOW_CHECKING == 1 )
+StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack, StackType_t *pxEndOfStack, TaskFunction_t pxCode, void *pvParameters) PRIVILEGED_FUNCTION;
 #else
 StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters) PRIVILEGED_FUNCTION;
 #endif
+#endif
 
 /* Used by heap_5.c. */
 typedef struct HeapRegion {
@@ -173,6 +185,50 @@ void vPortInitialiseBlocks(void) PRIVILEGED_FUNCTION;
 size_t xPortGetFreeHeapSize(void) PRIVILEGED_FUNCTION;
 size_t xPortGetMinimumEverFreeHeapSize(void) PRIVILEGED_FUNCTION;
 
+/*
+ * Bytes heap_6.c has taken from the host, including its free blocks.
+ */
+size_t xPortGetHeapReservedSize(void) PRIVILEGED_FUNCTION;
+
+/* Buckets of HeapStats_t.xFreeBlockHistogram.  Bucket n counts the free blocks
+of 2^(n + 4) up to 2^(n + 5) - 1 bytes, the first bucket also counts smaller
+blocks and the last one all larger blocks. */
+#define portHEAP_HISTOGRAM_BUCKETS      16
+
+/* Used to pass information about the heap out of vPortGetHeapStats(). */
+typedef struct xHeapStats {
+    size_t xAvailableHeapSpaceInBytes;          /* The total heap size currently available - this is the sum of all the free blocks, not the largest block that can be allocated. */
+    size_t xSizeOfLargestFreeBlockInBytes;      /* The maximum size, in bytes, of all the free blocks within the heap at the time vPortGetHeapStats() is called. */
+    size_t xSizeOfSmallestFreeBlockInBytes;     /* The minimum size, in bytes, of all the free blocks within the heap at the time vPortGetHeapStats() is called. */
+    size_t xNumberOfFreeBlocks;                 /* The number of free memory blocks within the heap at the time vPortGetHeapStats() is called. */
+    size_t xMinimumEverFreeBytesRemaining;      /* The minimum amount of total free memory (sum of all free blocks) there has been in the heap since the system booted. */
+    size_t xNumberOfSuccessfulAllocations;      /* The number of calls to pvPortMalloc() that have returned a valid memory block. */
+    size_t xNumberOfSuccessfulFrees;            /* The number of calls to vPortFree() that has successfully freed a block of memory. */
+    size_t xFreeBlockHistogram[ portHEAP_HISTOGRAM_BUCKETS ];  /* The free blocks by size, see portHEAP_HISTOGRAM_BUCKETS. */
+} HeapStats_t;
+
+/*
+ * Returns a HeapStats_t structure filled with information about the current
+ * heap state.  Provided by heap_4.c, heap_5.c and heap_6.c.
+ */
+void vPortGetHeapStats(HeapStats_t *pxHeapStats) PRIVILEGED_FUNCTION;
+
+/*
+ * Task stacks are taken from the port's own allocator when
+ * configSTACK_ALLOCATION_FROM_SEPARATE_HEAP is 1.
+ */
+#ifndef configSTACK_ALLOCATION_FROM_SEPARATE_HEAP
+#define configSTACK_ALLOCATION_FROM_SEPARATE_HEAP 0
+#endif
+
+#if( configSTACK_ALLOCATION_FROM_SEPARATE_HEAP == 1 )
+void *pvPortMallocStack(size_t xSize) PRIVILEGED_FUNCTION;
+void vPortFreeStack(void *pv) PRIVILEGED_FUNCTION;
+#else
+#define pvPortMallocStack pvPortMalloc
+#define vPortFreeStack vPortFree
+#endif
+
 /*
  * Setup the hardware ready for the scheduler to take control.  This generally
  * sets up a tick interrupt and sets timers for the correct tick frequency.
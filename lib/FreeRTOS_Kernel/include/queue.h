@@ -1044,6 +1044,155 @@ UBaseType_t uxQueueMessagesWaiting(const QueueHandle_t xQueue) PRIVILEGED_FUNCTI
  */
 UBaseType_t uxQueueSpacesAvailable(const QueueHandle_t xQueue) PRIVILEGED_FUNCTION;
 
+#if( configUSE_QUEUE_ZERO_COPY == 1 )
+
+/**
+ * queue. h
+ * <pre>
+ BaseType_t xQueueReserve(
+                           QueueHandle_t xQueue,
+                           void **ppvSlot,
+                           TickType_t xTicksToWait
+                         );
+ * </pre>
+ *
+ * Reserves the slot at the back of a queue, so an item can be written
+ * straight into the queue storage instead of being copied in by
+ * xQueueSendToBack().  The item is only posted, and becomes visible to
+ * receivers, once xQueueCommit() is called.  Blocks exactly like
+ * xQueueSendToBack() while the queue is full.
+ *
+ * A queue has at most one slot reserved at a time.  Until it is committed
+ * other tasks reserving or sending to the queue wait as if it were full.
+ *
+ * configUSE_QUEUE_ZERO_COPY must be set to 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * @param xQueue The handle to the queue to reserve a slot in.
+ *
+ * @param ppvSlot Set to the uxItemSize bytes of the reserved slot, or NULL
+ * if none could be reserved.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for a slot to become available, as with xQueueSendToBack().
+ *
+ * @return pdPASS if a slot was reserved, otherwise errQUEUE_FULL.
+ *
+ * Example usage:
+   <pre>
+ struct AMessage
+ {
+    char ucMessageID;
+    char ucData[ 4096 ];
+ };
+
+ void vATask( void *pvParameters )
+ {
+ QueueHandle_t xQueue = xQueueCreate( 4, sizeof( struct AMessage ) );
+ struct AMessage *pxMessage;
+
+    // Fill the message in place and post it.
+    if( xQueueReserve( xQueue, ( void ** ) &pxMessage, ( TickType_t ) 10 ) == pdPASS )
+    {
+        pxMessage->ucMessageID = 1;
+        vFillData( pxMessage->ucData );
+        xQueueCommit( xQueue );
+    }
+ }
+ </pre>
+ * \defgroup xQueueReserve xQueueReserve
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueReserve(QueueHandle_t xQueue, void **const ppvSlot, TickType_t xTicksToWait) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * <pre>BaseType_t xQueueCommit( QueueHandle_t xQueue );</pre>
+ *
+ * Posts the item written to the slot reserved by xQueueReserve() to the back
+ * of the queue, unblocking a task waiting to receive from the queue as
+ * xQueueSendToBack() would.  The slot must not be accessed afterwards.
+ *
+ * @param xQueue The handle to the queue the slot was reserved in.
+ *
+ * @return pdPASS, or pdFAIL if no slot was reserved.
+ *
+ * \defgroup xQueueCommit xQueueCommit
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueCommit(QueueHandle_t xQueue) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * <pre>
+ BaseType_t xQueueBorrow(
+                          QueueHandle_t xQueue,
+                          void **ppvSlot,
+                          TickType_t xTicksToWait
+                        );
+ * </pre>
+ *
+ * Borrows the item at the front of a queue, so it can be read straight from
+ * the queue storage instead of being copied out by xQueueReceive().  The item
+ * stays in the queue until xQueueRelease() is called.  Blocks exactly like
+ * xQueueReceive() while the queue is empty.
+ *
+ * A queue has at most one item borrowed at a time.  Until it is released
+ * other tasks borrowing, receiving or peeking wait as if the queue were
+ * empty, and tasks sending to the front of the queue or overwriting it wait
+ * as if it were full.
+ *
+ * configUSE_QUEUE_ZERO_COPY must be set to 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * @param xQueue The handle to the queue to borrow an item from.
+ *
+ * @param ppvSlot Set to the uxItemSize bytes of the borrowed item, or NULL
+ * if there was none.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for an item, as with xQueueReceive().
+ *
+ * @return pdPASS if an item was borrowed, otherwise errQUEUE_EMPTY.
+ *
+ * Example usage:
+   <pre>
+ void vADifferentTask( void *pvParameters )
+ {
+ struct AMessage *pxMessage;
+
+    // Read the message where it is and give the slot back.
+    if( xQueueBorrow( xQueue, ( void ** ) &pxMessage, portMAX_DELAY ) == pdPASS )
+    {
+        vProcessData( pxMessage->ucData );
+        xQueueRelease( xQueue );
+    }
+ }
+ </pre>
+ * \defgroup xQueueBorrow xQueueBorrow
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueBorrow(QueueHandle_t xQueue, void **const ppvSlot, TickType_t xTicksToWait) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * <pre>BaseType_t xQueueRelease( QueueHandle_t xQueue );</pre>
+ *
+ * Removes the item borrowed by xQueueBorrow() from the queue, unblocking the
+ * tasks waiting to send to the queue as xQueueReceive() would.  The slot must
+ * not be accessed afterwards.
+ *
+ * @param xQueue The handle to the queue the item was borrowed from.
+ *
+ * @return pdPASS, or pdFAIL if no item was borrowed.
+ *
+ * \defgroup xQueueRelease xQueueRelease
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueRelease(QueueHandle_t xQueue) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_QUEUE_ZERO_COPY */
+
 /**
  * queue. h
  * <pre>void vQueueDelete( QueueHandle_t xQueue );</pre>
@@ -1630,6 +1779,81 @@ void vQueueUnregisterQueue(QueueHandle_t xQueue) PRIVILEGED_FUNCTION;
 const char *pcQueueGetName(QueueHandle_t xQueue) PRIVILEGED_FUNCTION;   /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
 #endif
 
+#if( configUSE_QUEUE_STATS == 1 )
+
+/*
+ * What was done to a queue, semaphore or mutex since it was created or its
+ * statistics were last reset with vQueueResetStats().  The statistics are
+ * collected through the trace macros when configUSE_QUEUE_STATS is set to 1
+ * in FreeRTOSConfig.h, for the first configQUEUE_STATS_SIZE objects alive at
+ * the same time.
+ *
+ * A wait starts when a task first blocks on the object and ends when the
+ * same task gets through or gives up, however often it is woken up in
+ * between.  Its length goes into ulBlockedHistogram[ n ], where n is the
+ * number of times it can be halved before dropping below 2 microseconds,
+ * the last bucket also taking every longer wait.
+ */
+typedef struct xQUEUE_STATS
+{
+    QueueHandle_t xHandle;          /* The queue, semaphore or mutex. */
+    const char *pcName;             /* Its name in the queue registry, NULL if it is not registered. */ /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+    uint8_t ucQueueType;            /* One of the queueQUEUE_TYPE_... values it was created with. */
+    UBaseType_t uxMaxDepth;         /* Most items, or the highest count, it held at once. */
+    uint32_t ulSends;               /* Items sent and semaphores or mutexes given. */
+    uint32_t ulReceives;            /* Items received and semaphores or mutexes taken. */
+    uint32_t ulPeeks;
+    uint32_t ulSendsFailed;         /* Sends that found the queue full until their block time ran out. */
+    uint32_t ulReceivesFailed;      /* Receives and peeks that found it empty until their block time ran out. */
+    uint32_t ulFromISR;             /* Of all of the above, those made from interrupts. */
+    uint32_t ulWaits;               /* Waits started by a task blocking on it. */
+    uint32_t ulPriorityInherits;    /* Waits that raised the priority of the mutex holder. */
+    uint32_t ulPriorityDisinherits; /* Gives that returned the holder to its own priority. */
+    uint64_t ullBlockedTime;        /* Nanoseconds of all waits that ended. */
+    uint64_t ullMaxBlockedTime;     /* Nanoseconds of the longest of them. */
+    uint32_t ulBlockedHistogram[ queueSTATS_HISTOGRAM_BUCKETS ];
+} QueueStats_t;
+
+/*
+ * Copies the statistics of one queue, semaphore or mutex to *pxStats.
+ *
+ * @return pdPASS, or pdFAIL if no statistics are collected for xQueue
+ * because configQUEUE_STATS_SIZE other objects were alive when it was
+ * created.
+ */
+BaseType_t xQueueGetStats(QueueHandle_t xQueue, QueueStats_t *pxStats) PRIVILEGED_FUNCTION;
+
+/*
+ * Copies the statistics of every queue, semaphore and mutex collected for to
+ * pxStatsArray, as uxTaskGetSystemState() does for tasks.
+ *
+ * @return The number of entries filled in, at most uxArraySize.
+ */
+UBaseType_t uxQueueGetAllStats(QueueStats_t *const pxStatsArray, const UBaseType_t uxArraySize) PRIVILEGED_FUNCTION;
+
+/*
+ * Starts the statistics of xQueue, or of every object if xQueue is NULL,
+ * from zero again.  Waits that are going on keep their start time.
+ */
+void vQueueResetStats(QueueHandle_t xQueue) PRIVILEGED_FUNCTION;
+
+/*
+ * Formats the statistics of every queue, semaphore and mutex as a human
+ * readable table, one line per object named after its queue registry entry
+ * or its handle, as vTaskList() does for tasks.  Like vTaskList() it is
+ * provided for convenience and depends on snprintf(), uxQueueGetAllStats()
+ * gives the raw data.  configUSE_STATS_FORMATTING_FUNCTIONS must be set to 1
+ * for it to be available.
+ *
+ * @param pcWriteBuffer Takes the table, which is cut short rather than
+ * written past xBufferLength bytes.
+ */
+#if( configUSE_STATS_FORMATTING_FUNCTIONS > 0 )
+void vQueueGetStatsList(char *pcWriteBuffer, size_t xBufferLength) PRIVILEGED_FUNCTION;   /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+#endif
+
+#endif /* configUSE_QUEUE_STATS */
+
 /*
  * Generic version of the function used to creaet a queue using dynamic memory
  * allocation.  This is called by other functions and macros that create other
@@ -0,0 +1,163 @@
+/*
+    FreeRTOS V9.0.0 - Copyright (C) 2016 Real Time Engineers Ltd.
+    All rights reserved
+
+    VISIT http://www.FreeRTOS.org TO ENSURE YOU ARE USING THE LATEST VERSION.
+
+    This file is part of the FreeRTOS distribution.
+
+    FreeRTOS is free software; you can redistribute it and/or modify it under
+    the terms of the GNU General Public License (version 2) as published by the
+    Free Software Foundation >>>> AND MODIFIED BY <<<< the FreeRTOS exception.
+
+    ***************************************************************************
+    >>!   NOTE: The modification to the GPL is included to allow you to     !<<
+    >>!   distribute a combined work that includes FreeRTOS without being   !<<
+    >>!   obliged to provide the source code for proprietary components     !<<
+    >>!   outside of the FreeRTOS kernel.                                   !<<
+    ***************************************************************************
+
+    FreeRTOS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  Full license text is available on the following
+    link: http://www.freertos.org/a00114.html
+
+    ***************************************************************************
+     *                                                                       *
+     *    FreeRTOS provides completely free yet professionally developed,    *
+     *    robust, strictly quality controlled, supported, and cross          *
+     *    platform software that is more than just the market leader, it     *
+     *    is the industry's de facto standard.                               *
+     *                                                                       *
+     *    Help yourself get started quickly while simultaneously helping     *
+     *    to support the FreeRTOS project by purchasing a FreeRTOS           *
+     *    tutorial book, reference manual, or both:                          *
+     *    http://www.FreeRTOS.org/Documentation                              *
+     *                                                                       *
+    ***************************************************************************
+
+    http://www.FreeRTOS.org/FAQHelp.html - Having a problem?  Start by reading
+    the FAQ page "My application does not run, what could be wrong?".  Have you
+    defined configASSERT()?
+
+    http://www.FreeRTOS.org/support - In return for receiving this top quality
+    embedded software for free we request you assist our global community by
+    participating in the support forum.
+
+    http://www.FreeRTOS.org/training - Investing in training allows your team to
+    be as productive as possible as early as possible.  Now you can receive
+    FreeRTOS training directly from Richard Barry, CEO of Real Time Engineers
+    Ltd, and the world's leading authority on the world's leading RTOS.
+
+    http://www.FreeRTOS.org/plus - A selection of FreeRTOS ecosystem products,
+    including FreeRTOS+Trace - an indispensable productivity tool, a DOS
+    compatible FAT file system, and our tiny thread aware UDP/IP stack.
+
+    http://www.FreeRTOS.org/labs - Where new FreeRTOS products go to incubate.
+    Come and try FreeRTOS+TCP, our new open source TCP/IP stack for FreeRTOS.
+
+    http://www.OpenRTOS.com - Real Time Engineers ltd. license FreeRTOS to High
+    Integrity Systems ltd. to sell under the OpenRTOS brand.  Low cost OpenRTOS
+    licenses offer ticketed support, indemnification and commercial middleware.
+
+    http://www.SafeRTOS.com - High Integrity Systems also provide a safety
+    engineered and independently SIL3 certified version for use in safety and
+    mission critical applications that require provable dependability.
+
+    1 tab == 4 spaces!
+*/
+
+/*
+ * The trace macros queue statistics are collected through, included by
+ * FreeRTOS.h when configUSE_QUEUE_STATS is set to 1.  The statistics
+ * themselves are read through xQueueGetStats() and the other functions
+ * declared in queue.h.
+ *
+ * Every macro expands inside queue.c or tasks.c, within the critical section
+ * or interrupt mask the kernel already holds where there is one.  The wait
+ * a task is in is kept in its TCB, so it starts out empty for every task no
+ * matter how the port runs tasks.  The port must define portQUEUE_STATS_TIME()
+ * as a monotonic clock in nanoseconds.
+ */
+
+#ifndef QUEUE_STATS_H
+#define QUEUE_STATS_H
+
+#ifndef INC_FREERTOS_H
+#error "include FreeRTOS.h" must appear in source files before "include queue_stats.h"
+#endif
+
+#ifndef portQUEUE_STATS_TIME
+#error configUSE_QUEUE_STATS needs portQUEUE_STATS_TIME() from the port.
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Waits up to 2^23 microseconds, about 8 seconds, get a bucket of their own. */
+#define queueSTATS_HISTOGRAM_BUCKETS    24
+
+struct xQUEUE_STATS;
+
+/* The object a task is waiting on, if any, and since when.  The mutex the task
+gave last is where a disinherit is charged to. */
+typedef struct xQUEUE_STATS_WAIT
+{
+    struct xQUEUE_STATS *pxWaitingOn;
+    struct xQUEUE_STATS *pxLastSentTo;
+    uint64_t ullWaitStart;
+} QueueStatsWait_t;
+
+/* Not public API functions, only called through the macros below.
+pxTaskGetQueueStatsWait() is defined in tasks.c. */
+QueueStatsWait_t *pxTaskGetQueueStatsWait(void);
+struct xQUEUE_STATS *pxQueueStatsCreate(void *pvQueue, uint8_t ucQueueType);
+void vQueueStatsDelete(struct xQUEUE_STATS *pxStats);
+void vQueueStatsBlock(struct xQUEUE_STATS *pxStats);
+void vQueueStatsSend(struct xQUEUE_STATS *pxStats, UBaseType_t uxDepth, BaseType_t xFromISR);
+void vQueueStatsSetSend(struct xQUEUE_STATS *pxStats, UBaseType_t uxDepth);
+void vQueueStatsReceive(struct xQUEUE_STATS *pxStats, BaseType_t xPeek, BaseType_t xFromISR);
+void vQueueStatsFailed(struct xQUEUE_STATS *pxStats, BaseType_t xSend, BaseType_t xFromISR);
+void vQueueStatsPriorityInherit(void);
+void vQueueStatsPriorityDisinherit(void);
+
+/* Items held once the one being sent is in, an overwrite adds none to a full
+queue. */
+#define queueSTATS_DEPTH_AFTER_SEND( pxQueue ) \
+    ( ( ( pxQueue )->uxMessagesWaiting < ( pxQueue )->uxLength ) ? ( ( pxQueue )->uxMessagesWaiting + 1U ) : ( pxQueue )->uxLength )
+
+/* Every queue, semaphore and mutex points to the entry its statistics are
+collected in, which leaves uxQueueNumber to the application. */
+#define traceQUEUE_CREATE( pxNewQueue )                 ( pxNewQueue )->pxQueueStats = pxQueueStatsCreate( ( pxNewQueue ), ( pxNewQueue )->ucQueueType )
+#define traceQUEUE_DELETE( pxQueue )                    vQueueStatsDelete( ( pxQueue )->pxQueueStats )
+
+#define traceBLOCKING_ON_QUEUE_SEND( pxQueue )          vQueueStatsBlock( ( pxQueue )->pxQueueStats )
+#define traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue )       vQueueStatsBlock( ( pxQueue )->pxQueueStats )
+
+#define traceQUEUE_SEND( pxQueue )                      vQueueStatsSend( ( pxQueue )->pxQueueStats, queueSTATS_DEPTH_AFTER_SEND( pxQueue ), pdFALSE )
+#define traceQUEUE_SEND_FROM_ISR( pxQueue )             vQueueStatsSend( ( pxQueue )->pxQueueStats, queueSTATS_DEPTH_AFTER_SEND( pxQueue ), pdTRUE )
+/* The task or interrupt sending to a member of the set was not waiting on the
+set itself. */
+#define traceQUEUE_SET_SEND( pxQueueSet )               vQueueStatsSetSend( ( pxQueueSet )->pxQueueStats, queueSTATS_DEPTH_AFTER_SEND( pxQueueSet ) )
+#define traceQUEUE_RECEIVE( pxQueue )                   vQueueStatsReceive( ( pxQueue )->pxQueueStats, pdFALSE, pdFALSE )
+#define traceQUEUE_RECEIVE_FROM_ISR( pxQueue )          vQueueStatsReceive( ( pxQueue )->pxQueueStats, pdFALSE, pdTRUE )
+#define traceQUEUE_PEEK( pxQueue )                      vQueueStatsReceive( ( pxQueue )->pxQueueStats, pdTRUE, pdFALSE )
+#define traceQUEUE_PEEK_FROM_ISR( pxQueue )             vQueueStatsReceive( ( pxQueue )->pxQueueStats, pdTRUE, pdTRUE )
+
+#define traceQUEUE_SEND_FAILED( pxQueue )               vQueueStatsFailed( ( pxQueue )->pxQueueStats, pdTRUE, pdFALSE )
+#define traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue )      vQueueStatsFailed( ( pxQueue )->pxQueueStats, pdTRUE, pdTRUE )
+#define traceQUEUE_RECEIVE_FAILED( pxQueue )            vQueueStatsFailed( ( pxQueue )->pxQueueStats, pdFALSE, pdFALSE )
+#define traceQUEUE_RECEIVE_FROM_ISR_FAILED( pxQueue )   vQueueStatsFailed( ( pxQueue )->pxQueueStats, pdFALSE, pdTRUE )
+#define traceQUEUE_PEEK_FROM_ISR_FAILED( pxQueue )      vQueueStatsFailed( ( pxQueue )->pxQueueStats, pdFALSE, pdTRUE )
+
+/* Inheriting is done by the task about to block on the mutex, disinheriting
+by the holder giving it back, each in its own thread. */
+#define traceTASK_PRIORITY_INHERIT( pxTCBOfMutexHolder, uxInheritedPriority )  vQueueStatsPriorityInherit()
+#define traceTASK_PRIORITY_DISINHERIT( pxTCBOfMutexHolder, uxOriginalPriority ) vQueueStatsPriorityDisinherit()
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* QUEUE_STATS_H */
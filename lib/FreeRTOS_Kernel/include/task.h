@@ -166,7 +166,7 @@ typedef struct xTASK_STATUS {
     eTaskState eCurrentState;       /* The state in which the task existed when the structure was populated. */
     UBaseType_t uxCurrentPriority;  /* The priority at which the task was running (may be inherited) when the structure was populated. */
     UBaseType_t uxBasePriority;     /* The priority to which the task will return if the task's current priority has been inherited to avoid unbounded priority inversion when obtaining a mutex.  Only valid if configUSE_MUTEXES is defined as 1 in FreeRTOSConfig.h. */
-    uint32_t ulRunTimeCounter;      /* The total run time allocated to the task so far, as defined by the run time stats clock.  See http://www.freertos.org/rtos-run-time-stats.html.  Only valid when configGENERATE_RUN_TIME_STATS is defined as 1 in FreeRTOSConfig.h. */
+    configRUN_TIME_COUNTER_TYPE ulRunTimeCounter;      /* The total run time allocated to the task so far, as defined by the run time stats clock.  See http://www.freertos.org/rtos-run-time-stats.html.  Only valid when configGENERATE_RUN_TIME_STATS is defined as 1 in FreeRTOSConfig.h. */
     StackType_t *pxStackBase;       /* Points to the lowest address of the task's stack area. */
     uint16_t usStackHighWaterMark;  /* The minimum amount of stack space that has remained for the task since the task was created.  The closer this value is to zero the closer the task has come to overflowing its stack. */
 } TaskStatus_t;
@@ -185,6 +185,13 @@ typedef enum {
  */
 #define tskIDLE_PRIORITY            ( ( UBaseType_t ) 0U )
 
+/**
+ * Core affinity mask that lets a task run on any core.
+ *
+ * \ingroup TaskUtils
+ */
+#define tskNO_AFFINITY              ( ( UBaseType_t ) -1 )
+
 /**
  * task. h
  *
@@ -942,6 +949,62 @@ void vTaskGetInfo(TaskHandle_t xTask, TaskStatus_t *pxTaskStatus, BaseType_t xGe
  */
 void vTaskPrioritySet(TaskHandle_t xTask, UBaseType_t uxNewPriority) PRIVILEGED_FUNCTION;
 
+#if ( configNUMBER_OF_CORES > 1 )
+
+/**
+ * task. h
+ * <pre>void vTaskCoreAffinitySet( TaskHandle_t xTask, UBaseType_t uxCoreAffinityMask );</pre>
+ *
+ * Only available when configNUMBER_OF_CORES is greater than 1.
+ *
+ * Sets the cores a task may run on.  Bit n of the mask allows core n, tasks are
+ * created with tskNO_AFFINITY.  A task running on a core it is no longer
+ * allowed on is switched out straight away.
+ *
+ * @param xTask Handle of the task to set the affinity of.  Passing a NULL
+ * handle results in the affinity of the calling task being set.
+ *
+ * @param uxCoreAffinityMask The cores the task may run on, should include at
+ * least one core.
+ *
+ * Example usage:
+   <pre>
+ void vAFunction( void )
+ {
+ TaskHandle_t xHandle;
+
+     // Create a task, storing the handle.
+     xTaskCreate( vTaskCode, "NAME", STACK_SIZE, NULL, tskIDLE_PRIORITY, &xHandle );
+
+     // ...
+
+     // Keep the task on cores 0 and 2.
+     vTaskCoreAffinitySet( xHandle, ( 1 << 0 ) | ( 1 << 2 ) );
+ }
+   </pre>
+ * \defgroup vTaskCoreAffinitySet vTaskCoreAffinitySet
+ * \ingroup TaskCtrl
+ */
+void vTaskCoreAffinitySet(const TaskHandle_t xTask, UBaseType_t uxCoreAffinityMask) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <pre>UBaseType_t uxTaskCoreAffinityGet( TaskHandle_t xTask );</pre>
+ *
+ * Only available when configNUMBER_OF_CORES is greater than 1.
+ *
+ * @param xTask Handle of the task to query.  Passing a NULL handle results in
+ * the affinity of the calling task being returned.
+ *
+ * @return The mask of the cores the task may run on.
+ *
+ * \defgroup uxTaskCoreAffinityGet uxTaskCoreAffinityGet
+ * \ingroup TaskCtrl
+ */
+UBaseType_t uxTaskCoreAffinityGet(const TaskHandle_t xTask) PRIVILEGED_FUNCTION;
+
+#endif /* configNUMBER_OF_CORES */
+
 /**
  * task. h
  * <pre>void vTaskSuspend( TaskHandle_t xTaskToSuspend );</pre>
@@ -1465,7 +1528,7 @@ TaskHandle_t xTaskGetIdleTaskHandle(void) PRIVILEGED_FUNCTION;
     {
     TaskStatus_t *pxTaskStatusArray;
     volatile UBaseType_t uxArraySize, x;
-    uint32_t ulTotalRunTime, ulStatsAsPercentage;
+    configRUN_TIME_COUNTER_TYPE ulTotalRunTime, ulStatsAsPercentage;
 
         // Make sure the write buffer does not contain a string.
         *pcWriteBuffer = 0x00;
@@ -1519,7 +1582,7 @@ TaskHandle_t xTaskGetIdleTaskHandle(void) PRIVILEGED_FUNCTION;
     }
     </pre>
  */
-UBaseType_t uxTaskGetSystemState(TaskStatus_t *const pxTaskStatusArray, const UBaseType_t uxArraySize, uint32_t *const pulTotalRunTime) PRIVILEGED_FUNCTION;
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *const pxTaskStatusArray, const UBaseType_t uxArraySize, configRUN_TIME_COUNTER_TYPE *const pulTotalRunTime) PRIVILEGED_FUNCTION;
 
 /**
  * task. h
@@ -2173,6 +2236,13 @@ TickType_t uxTaskResetEventItemValue(void) PRIVILEGED_FUNCTION;
  */
 TaskHandle_t xTaskGetCurrentTaskHandle(void) PRIVILEGED_FUNCTION;
 
+#if ( configNUMBER_OF_CORES > 1 )
+/*
+ * Return the handle of the task running on the given core.
+ */
+TaskHandle_t xTaskGetCurrentTaskHandleForCore(BaseType_t xCoreID) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * Capture the current time status for future reference.
  */
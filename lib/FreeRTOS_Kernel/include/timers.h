@@ -128,6 +128,15 @@ typedef void (*TimerCallbackFunction_t)(TimerHandle_t xTimer);
  */
 typedef void (*PendedFunction_t)(void *, uint32_t);
 
+/*
+ * A command in a batch sent by uxTimerSendCommandBatch().
+ */
+typedef struct xTIMER_COMMAND {
+    TimerHandle_t   xTimer;         /*<< The timer the command is for. */
+    BaseType_t      xCommandID;     /*<< tmrCOMMAND_START, tmrCOMMAND_RESET, tmrCOMMAND_STOP, tmrCOMMAND_CHANGE_PERIOD or tmrCOMMAND_DELETE. */
+    TickType_t      xNewPeriod;     /*<< The new period for tmrCOMMAND_CHANGE_PERIOD, not used by the other commands. */
+} TimerCommand_t;
+
 /**
  * TimerHandle_t xTimerCreate(  const char * const pcTimerName,
  *                              TickType_t xTimerPeriodInTicks,
@@ -1261,6 +1270,68 @@ BaseType_t xTimerPendFunctionCallFromISR(PendedFunction_t xFunctionToPend, void
  */
 BaseType_t xTimerPendFunctionCall(PendedFunction_t xFunctionToPend, void *pvParameter1, uint32_t ulParameter2, TickType_t xTicksToWait) PRIVILEGED_FUNCTION;
 
+/**
+ * UBaseType_t uxTimerSendCommandBatch( const TimerCommand_t *pxCommands,
+ *                                      UBaseType_t uxCommands,
+ *                                      TickType_t xTicksToWait );
+ *
+ * Sends a batch of commands to the timer service task.  Each command has the
+ * same effect as the matching xTimerStart(), xTimerReset(), xTimerStop(),
+ * xTimerChangePeriod() or xTimerDelete() call, and the commands are carried
+ * out in order.  They are posted to the timer command queue with the
+ * scheduler suspended, so the timer service task is woken, and switched to,
+ * once for the batch instead of once for every command.  Start and reset
+ * commands all count their period from the tick count at the call.
+ *
+ * With configUSE_TIMER_DIRECT_COMMANDS set to 1, commands sent from a timer
+ * callback, or while the timer service task waits with nothing queued, are
+ * carried out by the caller without going through the queue at all, as the
+ * single command functions are.
+ *
+ * Must not be called from an interrupt service routine.
+ *
+ * @param pxCommands The commands to send.
+ *
+ * @param uxCommands The number of commands in pxCommands.
+ *
+ * @param xTicksToWait Commands that do not fit in the timer queue are sent
+ * once the timer service task has made room for them.  xTicksToWait is the
+ * longest time, over the whole batch, the calling task should remain in the
+ * Blocked state waiting for room.  Ignored if called before the scheduler is
+ * started.
+ *
+ * @return The number of commands sent.  If it is below uxCommands then the
+ * rest of the batch, from pxCommands[ return value ] on, was not sent.
+ *
+ * Example usage:
+ * @verbatim
+ * #define NUM_WATCHDOGS 64
+ *
+ * static TimerCommand_t xKicks[ NUM_WATCHDOGS ];
+ *
+ * void vMonitorTask( void *pvParameters )
+ * {
+ * UBaseType_t x;
+ *
+ *     // One reset command for each watchdog timer, created elsewhere.
+ *     for( x = 0; x < NUM_WATCHDOGS; x++ )
+ *     {
+ *         xKicks[ x ].xTimer = xWatchdogTimers[ x ];
+ *         xKicks[ x ].xCommandID = tmrCOMMAND_RESET;
+ *     }
+ *
+ *     for( ;; )
+ *     {
+ *         vCheckConnections();
+ *
+ *         // Kick every watchdog with one wake up of the timer service task.
+ *         uxTimerSendCommandBatch( xKicks, NUM_WATCHDOGS, portMAX_DELAY );
+ *     }
+ * }
+ * @endverbatim
+ */
+UBaseType_t uxTimerSendCommandBatch(const TimerCommand_t *pxCommands, UBaseType_t uxCommands, TickType_t xTicksToWait) PRIVILEGED_FUNCTION;
+
 /**
  * const char * const pcTimerGetName( TimerHandle_t xTimer );
  *
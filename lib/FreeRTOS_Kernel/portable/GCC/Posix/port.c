@@ -54,80 +54,376 @@
  * Implementation of functions defined in portable.h for the Posix port.
  *----------------------------------------------------------*/
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE                 /* CPU affinity of threads. */
+#endif
 #include <pthread.h>
+#include <semaphore.h>
 #include <sched.h>
+#include <setjmp.h>
 #include <signal.h>
+#include <stdatomic.h>
 #include <errno.h>
 #include <sys/time.h>
 #include <time.h>
-#include <sys/times.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <limits.h>
+#include <ucontext.h>
+#include <sys/mman.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
 
 /* Scheduler includes. */
 #include "FreeRTOS.h"
 #include "task.h"
 /*-----------------------------------------------------------*/
 
-#define MAX_NUMBER_OF_TASKS (_POSIX_THREAD_THREADS_MAX)
-/*-----------------------------------------------------------*/
+#if ( configSTACK_ALLOCATION_FROM_SEPARATE_HEAP != 1 )
+#error The POSIX port maps the task stacks itself, set configSTACK_ALLOCATION_FROM_SEPARATE_HEAP to 1
+#endif
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+#error Task stacks need the mapping set up by pvPortMallocStack(), static allocation is not supported
+#endif
+#if ( configCHECK_FOR_STACK_OVERFLOW == 1 )
+#error Task threads do not save their stack pointer, set configCHECK_FOR_STACK_OVERFLOW to 2
+#endif
 
-/* Parameters to pass to the newly created pthread. */
-typedef struct XPARAMS {
-    pdTASK_CODE pxCode;
-    void *pvParams;
-} xParams;
+#if ( configNUMBER_OF_CORES > 1 )
+#if ( configPOSIX_SWITCH_BACKEND != portSWITCH_CONDVAR ) || ( configPOSIX_TICK_SOURCE == portTICK_SOURCE_VIRTUAL )
+#error More than one core needs portSWITCH_CONDVAR and a tick that is not virtual
+#endif
+/* Interrupt state and critical nesting belong to the core, which is whichever
+one the calling thread was last resumed on. */
+#define portTHREAD_LOCAL            __thread
+#else
+#define portTHREAD_LOCAL
+#endif
+
+#if ( configPOSIX_SWITCH_BACKEND == portSWITCH_CONDVAR ) && ( configPOSIX_THREAD_POOL_SIZE > 0 )
+#define portUSE_THREAD_POOL         1
+#else
+#define portUSE_THREAD_POOL         0
+#endif
+
+/* Interrupts held back while masked, see prvReplayInterrupts(). */
+#define portPENDING_TICK            ( 1U << 0 )
+#define portPENDING_YIELD           ( 1U << 1 )
+#define portPENDING_IRQ             ( 1U << 2 )
+
+#if ( configPOSIX_NUM_IRQS > 32 )
+#error The pending IRQ lines are kept in 32 bits
+#endif
+#if ( configMAX_SYSCALL_INTERRUPT_PRIORITY > portLOWEST_IRQ_PRIORITY )
+#error configMAX_SYSCALL_INTERRUPT_PRIORITY is beyond the least urgent IRQ priority
+#endif
+/* Priority of task code, below that of every IRQ line. */
+#define portTASK_IRQ_PRIORITY       ( portLOWEST_IRQ_PRIORITY + 1 )
+
+typedef struct IRQ_LINE {
+    xPortIrqHandler pxHandler;
+    void *pvParameter;
+    unsigned portBASE_TYPE uxPriority;
+} xIrqLine;
+
+#if ( configPOSIX_SWITCH_BACKEND == portSWITCH_CONDVAR )
+/* Reasons for waking up a parked thread. */
+#define portWAKE_RESUME             0
+#define portWAKE_EXIT               1
+#define portWAKE_RECYCLE            2
+
+/* Each thread parks on its own event while it is not the running task. The
+event is owned by the thread and outlives its task, as a thread that is told to
+exit still has to wake up and release it after the task's stack is gone. */
+typedef struct THREAD_EVENT {
+    pthread_mutex_t xMutex;
+    pthread_cond_t xCond;
+    portBASE_TYPE xResume;
+    portBASE_TYPE xExit;
+    pthread_t hThread;
+    struct THREAD_SUSPENSIONS *pxThread;    /* State at the bottom of the thread's stack. */
+    sigjmp_buf xReserveJump;                /* Back to the reserve, see prvWaitForStart(). */
+#if ( portUSE_THREAD_POOL == 1 )
+    portBASE_TYPE xRecycle;
+    portBASE_TYPE xStarted;                 /* Left the reserve for the current task. */
+    struct THREAD_EVENT *pxNextPooled;
+#endif
+} xThreadEvent;
+#endif
 
-/* Each task maintains its own interrupt status in the critical nesting variable. */
+/* Each task maintains its own interrupt status in the critical nesting variable.
+The state lives at the bottom of the mapping that holds the task's stack, see
+pvPortMallocStack(), and can be reached from the TCB without a search. */
 typedef struct THREAD_SUSPENSIONS {
     pthread_t hThread;
-    xTaskHandle hTask;
+    TaskHandle_t hTask;                     /* Set once the task first runs. */
+    size_t xMappingSize;
+    portSTACK_TYPE *pxStack;
+    size_t xStackSize;                      /* In bytes, as asked for by the task. */
+    pdTASK_CODE pxCode;
+    void *pvParams;
     unsigned portBASE_TYPE uxCriticalNesting;
+    BaseType_t xCoreID;                     /* Core the thread was last resumed on. */
+    ListItem_t xThreadListItem;
+#if ( configPOSIX_SWITCH_BACKEND == portSWITCH_CONDVAR )
+    xThreadEvent *pxEvent;
+#else
+    volatile portBASE_TYPE xExit;
+    sigjmp_buf xReserveJump;                /* Back to the reserve, see prvWaitForStart(). */
+#endif
+#if ( configPOSIX_TICK_SOURCE == portTICK_SOURCE_VIRTUAL )
+    portBASE_TYPE xAwaitingCleanUp;
+#endif
 } xThreadState;
 /*-----------------------------------------------------------*/
 
-static xThreadState *pxThreads;
+/* pxTopOfStack is the first member of the TCB and points just below the
+thread state. */
+#define prvGetThreadState( hTask ) \
+    ( ( xThreadState * ) ( *( portSTACK_TYPE ** ) ( hTask ) + 1 ) )
+/*-----------------------------------------------------------*/
+
+/* The mapping of each task's stack, from low to high addresses:
+ * | thread state, signal stack | guard page | task stack | thread reserve |
+ * The task runs on exactly the stack it asked for and faults on the guard page
+ * once it runs past its end. The overflow is reported on the signal stack. The
+ * thread starts out on its reserve, which holds the C library's thread control
+ * block and the frames the thread returns to once its task is gone. */
+#define prvStackThreadState( pvStack ) \
+    ( ( xThreadState * ) ( ( char * ) ( pvStack ) - xPageSize - xSignalStackSize ) )
+#define prvRoundUpToPage( xSize ) \
+    ( ( ( xSize ) + xPageSize - 1 ) & ~( xPageSize - 1 ) )
+
+static size_t xPageSize;
+static size_t xSignalStackSize;
+static size_t xThreadReserveSize;
+/*-----------------------------------------------------------*/
+
+/* Host scheduling of the task threads and the tick thread, read from the
+environment once the port is set up. */
+#define portENV_TASK_CPUS           "FREERTOS_TASK_CPUS"
+#define portENV_TICK_CPUS           "FREERTOS_TICK_CPUS"
+#define portENV_SCHED_FIFO          "FREERTOS_SCHED_FIFO"
+
+static cpu_set_t xTaskCpus;
+static cpu_set_t xTickCpus;
+static portBASE_TYPE xPinTaskThreads = pdFALSE;
+static portBASE_TYPE xPinTickThread = pdFALSE;
+static int iTaskFifoPriority = 0;   /* 0 leaves the threads on the default policy. */
+/*-----------------------------------------------------------*/
+
+static List_t xThreadList;
 static pthread_once_t hSigSetupThread = PTHREAD_ONCE_INIT;
-static pthread_attr_t xThreadAttributes;
+#if ( configPOSIX_SWITCH_BACKEND == portSWITCH_SIGNAL )
 static pthread_mutex_t xSuspendResumeThreadMutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_mutex_t xSingleThreadMutex = PTHREAD_MUTEX_INITIALIZER;
+#else
+static xThreadEvent xSchedulerEndEvent = {
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, pdFALSE, pdFALSE
+};
+static sigset_t xAllSignals;
+static volatile pthread_t hRunningThreads[configNUMBER_OF_CORES];
+#endif
+#if ( portUSE_THREAD_POOL == 1 )
+/* Stacks with a thread parked on the reserve, only touched within critical
+sections. The count includes threads prvExitThread() kept for the pool whose
+stack vPortFreeStack() has yet to add to the list. */
+static xThreadEvent *pxPooledThreads = NULL;
+static unsigned portBASE_TYPE uxPooledThreads = 0;
+#endif
 static pthread_t hMainThread = (pthread_t)NULL;
 /*-----------------------------------------------------------*/
 
+#if ( configPOSIX_SWITCH_BACKEND == portSWITCH_SIGNAL )
 static volatile portBASE_TYPE xSentinel = 0;
-static volatile portBASE_TYPE xSchedulerEnd = pdFALSE;
-static volatile portBASE_TYPE xInterruptsEnabled = pdTRUE;
+/* Posted by a new thread once it has parked for the first time. */
+static sem_t xThreadParked;
+static volatile portBASE_TYPE xThreadStarting = pdFALSE;
 static volatile portBASE_TYPE xServicingTick = pdFALSE;
-static volatile portBASE_TYPE xPendYield = pdFALSE;
-static volatile portLONG lIndexOfLastAddedTask = 0;
-static volatile unsigned portBASE_TYPE uxCriticalNesting;
+#endif
+#define portNANOSECONDS_PER_SECOND  ( 1000000000ULL )
+#if ( configPOSIX_TICK_SOURCE == portTICK_SOURCE_THREAD )
+#define portTICK_PERIOD_NANOSECONDS ( portNANOSECONDS_PER_SECOND / configTICK_RATE_HZ )
+/* Tick lateness is kept in a histogram of 1us buckets for the percentile, ticks
+later than the last bucket are counted in it. */
+#define portTICK_HISTOGRAM_BUCKETS  ( 2048 )
+#define portTICK_HISTOGRAM_WIDTH    ( 1000ULL )
+/* Longest the idle task sleeps for in one go, also bounds how late a lost
+wake up is noticed. */
+#define portMAX_SUPPRESSED_TICKS    ( ( TickType_t ) configTICK_RATE_HZ )
+
+static pthread_t hTickThread;
+/* Guards the deadline of the next tick, its suppression and the statistics. */
+static pthread_mutex_t xTickMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t xTickCond;
+static struct timespec xNextTickDeadline;
+static volatile portBASE_TYPE xTicksSuppressed = pdFALSE;
+#if ( configUSE_TICKLESS_IDLE != 0 )
+static pthread_cond_t xIdleWakeCond;
+static volatile portBASE_TYPE xIdleWake = pdFALSE;
+#endif
+static xPortTickStats xTickStats;
+static uint64_t ullTickLatenessTotal;
+static uint32_t ulTickHistogram[portTICK_HISTOGRAM_BUCKETS];
+#elif ( configPOSIX_TICK_SOURCE == portTICK_SOURCE_VIRTUAL )
+#if ( configUSE_TICKLESS_IDLE == 0 ) || ( INCLUDE_xTaskGetIdleTaskHandle != 1 )
+#error Virtual time needs configUSE_TICKLESS_IDLE and INCLUDE_xTaskGetIdleTaskHandle
+#endif
+/* Guards the idle task's sleep once every task is blocked for good. */
+static pthread_mutex_t xTickMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t xIdleWakeCond = PTHREAD_COND_INITIALIZER;
+static volatile portBASE_TYPE xTicksSuppressed = pdFALSE;
+static volatile portBASE_TYPE xIdleWake = pdFALSE;
+static volatile unsigned portBASE_TYPE uxThreadsAwaitingCleanUp = 0;
+#endif
+static volatile portBASE_TYPE xSchedulerEnd = pdFALSE;
+/* Interrupts that come in while masked set their bit in uxPendingInterrupts
+and are replayed once interrupts are enabled again. Both are written by signal
+handlers, which may run on another thread with the signal backend. */
+static portTHREAD_LOCAL _Atomic portBASE_TYPE xInterruptsEnabled = pdTRUE;
+static portTHREAD_LOCAL _Atomic unsigned portBASE_TYPE uxPendingInterrupts = 0;
+static portTHREAD_LOCAL volatile unsigned portBASE_TYPE uxCriticalNesting;
+/* Ticks raised by the tick source and taken by the kernel. The difference is
+pending, a tick signal takes every pending tick so none is ever dropped. */
+static _Atomic uint64_t ullTicksRaised = 0;
+static _Atomic uint64_t ullTicksTaken = 0;
+static _Atomic uint64_t ullTicksDeferred = 0;
+static _Atomic uint64_t ullTicksReplayed = 0;
+/* Readings at the last vPortResetInterruptStats(). */
+static xPortInterruptStats xInterruptStatsBase;
+/* Lines raised and not run yet. The ISR being run, or task code, sets the
+priority a line has to beat to preempt it. */
+static xIrqLine xIrqLines[configPOSIX_NUM_IRQS];
+static _Atomic uint32_t ulIrqsPending = 0;
+static portTHREAD_LOCAL unsigned portBASE_TYPE uxIrqPriority = portTASK_IRQ_PRIORITY;
+static portTHREAD_LOCAL unsigned portBASE_TYPE uxIrqNesting = 0;
+static sigset_t xIrqSignal;
+#if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 ) && ( configMAX_PRIORITIES > portREADY_WORD_BITS )
+/* Bitmap of the ready priorities with more than 32 of them, see
+portRECORD_READY_PRIORITY(). Only changed by the kernel with its data guarded. */
+volatile uint32_t ulPortReadyPriorities[ ( configMAX_PRIORITIES + portREADY_WORD_BITS - 1 ) / portREADY_WORD_BITS ];
+#endif
+#if ( configNUMBER_OF_CORES > 1 )
+/* Kernel data is shared by all cores and guarded by one lock, taken by critical
+sections and held while the scheduler is suspended. Each thread counts how often
+it holds the lock, and only takes or gives the mutex with its interrupts
+disabled so the tick handler never finds it half way. */
+static pthread_mutex_t xKernelLock = PTHREAD_MUTEX_INITIALIZER;
+static portTHREAD_LOCAL unsigned portBASE_TYPE uxKernelLockDepth = 0;
+/* State of the calling task thread, NULL on other threads. */
+static portTHREAD_LOCAL xThreadState *pxOwnThread = NULL;
+/* Set when a core is asked to switch tasks, cleared once it did. */
+static volatile portBASE_TYPE xCoreYieldPending[configNUMBER_OF_CORES];
+#endif
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+/* For each core the CPU time used by switched out tasks, plus the running
+thread's CPU clock and its reading when the thread was switched in. */
+static uint64_t ullRunTimeSwitchedOut[configNUMBER_OF_CORES];
+static uint64_t ullRunTimeSwitchedIn[configNUMBER_OF_CORES];
+static clockid_t xRunningCpuClock[configNUMBER_OF_CORES];
+static volatile portBASE_TYPE xRunTimeStarted[configNUMBER_OF_CORES];
+#endif
 /*-----------------------------------------------------------*/
 
 /*
  * Setup the timer to generate the tick interrupts.
  */
 static void prvSetupTimerInterrupt(void);
+#if ( configPOSIX_TICK_SOURCE == portTICK_SOURCE_THREAD )
+static void *prvTickThread(void *pvParams);
+static void prvRecordTickLateness(uint64_t ullLateness);
+static void prvAddNanoseconds(struct timespec *pxTime, uint64_t ullNanoseconds);
+static int64_t prvNanosecondsBetween(const struct timespec *pxFrom,
+                                     const struct timespec *pxTo);
+static void prvRaiseTick(void);
+#elif ( configPOSIX_TICK_SOURCE == portTICK_SOURCE_VIRTUAL )
+static void prvAdvanceVirtualTime(void);
+#endif
 static void *prvWaitForStart(void *pvParams);
+static int prvStartThread(xThreadState *pxThread, pthread_t *phThread,
+                          void *pvParams);
+static void prvSetSignalStack(xThreadState *pxThread);
+static void prvRunTask(xThreadState *pxThread);
+static void prvTaskEntry(void);
+static void prvStackOverflowHandler(int sig, siginfo_t *pxInfo, void *pvContext);
+static void prvFillSignalSet(sigset_t *pxSignals);
+static portBASE_TYPE prvReadCpuList(const char *pcName, cpu_set_t *pxCpus);
+static void prvReadHostScheduling(void);
+static void prvSetHostScheduling(pthread_attr_t *pxAttributes,
+                                 portBASE_TYPE xTickThread);
+static xThreadState *prvGetOwnThreadState(void);
+static void prvSetupSignalsAndSchedulerPolicy(void);
+static size_t prvStackMappingSize(size_t xSize);
+static xThreadState *prvMapStack(size_t xMappingSize);
+static void prvResumeThread(xThreadState *pxThread);
+static void prvExitThread(xThreadState *pxThread);
+#if ( configGENERATE_RUN_TIME_STATS == 1 ) || ( configUSE_QUEUE_STATS == 1 )
+static uint64_t prvReadCpuClock(clockid_t xClock);
+#endif
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+static void prvSwitchRunTime(xThreadState *pxThreadToResume);
+#endif
+#if ( configPOSIX_SWITCH_BACKEND == portSWITCH_SIGNAL )
+static void prvSuspendThread(xThreadState *pxThread);
+static void prvSwitchInHandler(xThreadState *pxThreadToSuspend);
+static void prvYieldFromHandler(void);
 static void prvSuspendSignalHandler(int sig);
 static void prvResumeSignalHandler(int sig);
-static void prvSetupSignalsAndSchedulerPolicy(void);
-static void prvSuspendThread(pthread_t xThreadId);
-static void prvResumeThread(pthread_t xThreadId);
-static pthread_t prvGetThreadHandle(xTaskHandle hTask);
-static portLONG prvGetFreeThreadState(void);
-static void prvSetTaskCriticalNesting(pthread_t xThreadId,
-                                      unsigned portBASE_TYPE uxNesting);
-static unsigned portBASE_TYPE prvGetTaskCriticalNesting(pthread_t xThreadId);
-static void prvDeleteThread(void *xThreadId);
+#else
+static xThreadEvent *prvCreateEvent(void);
+static void prvDestroyEvent(xThreadEvent *pxEvent);
+static void prvSignalEvent(xThreadEvent *pxEvent, portBASE_TYPE xWake);
+static portBASE_TYPE prvWaitEvent(xThreadEvent *pxEvent);
+static void prvParkThread(xThreadEvent *pxEvent);
+static xThreadEvent *prvCreateThread(xThreadState *pxThread);
+#endif
+#if ( portUSE_THREAD_POOL == 1 )
+static void prvFillThreadPool(void);
+#endif
+#if ( configNUMBER_OF_CORES > 1 )
+static void prvLockKernel(void);
+static void prvUnlockKernel(void);
+static void prvLockKernelForTask(void);
+static void prvSwitchCore(void);
+static void prvYieldCoreSignalHandler(int sig);
+#endif
+/*-----------------------------------------------------------*/
+
+#if ( configCHECK_FOR_STACK_OVERFLOW > 0 )
+extern void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName);
+#endif
 /*-----------------------------------------------------------*/
 
 /*
  * Exception handlers.
  */
 void vPortYield(void);
-void vPortSystemTickHandler(int sig);
+void vPortSystemTickHandler(int sig, siginfo_t *pxInfo, void *pvContext);
+
+/*
+ * Interrupt masking, see uxPendingInterrupts.
+ */
+static void prvCountRaisedTick(void);
+static void prvCountTimerTick(const siginfo_t *pxInfo);
+#if ( configNUMBER_OF_CORES == 1 )
+static void prvRestoreTaskInterrupts(void);
+#endif
+static unsigned portBASE_TYPE prvTakeTicks(void);
+static void prvPendInterrupt(unsigned portBASE_TYPE uxInterrupt);
+static void prvReplayInterrupts(void);
+static void prvRestoreInterrupts(portBASE_TYPE xEnabled);
+
+/*
+ * Interrupt controller.
+ */
+static pthread_t prvGetIrqThread(void);
+static void prvIrqSignalHandler(int sig);
+static void prvDispatchIrqs(void);
+static void prvCheckIrqs(void);
+static void prvWakeIdle(void);
 
 /*
  * Start first task is a separate function so it can be tested in isolation.
@@ -135,14 +431,45 @@ void vPortSystemTickHandler(int sig);
 void vPortStartFirstTask(void);
 /*-----------------------------------------------------------*/
 
+/*
+ * Binds the thread state below the task's stack to the new task. The thread,
+ * if the stack came with one, and the mapping are left alone.
+ */
+static xThreadState *prvInitialiseThreadState(portSTACK_TYPE *pxTopOfStack,
+        portSTACK_TYPE *pxEndOfStack, pdTASK_CODE pxCode, void *pvParameters)
+{
+    xThreadState *pxThread = prvStackThreadState(pxEndOfStack);
+
+    pxThread->pxStack = pxEndOfStack;
+    pxThread->xStackSize = (size_t)((char *)(pxTopOfStack + 1) -
+                                    (char *)pxEndOfStack);
+    pxThread->pxCode = pxCode;
+    pxThread->pvParams = pvParameters;
+    pxThread->uxCriticalNesting = 0;
+    pxThread->xCoreID = 0;
+#if ( configPOSIX_SWITCH_BACKEND == portSWITCH_SIGNAL )
+    pxThread->xExit = pdFALSE;
+#endif
+#if ( configPOSIX_TICK_SOURCE == portTICK_SOURCE_VIRTUAL )
+    pxThread->xAwaitingCleanUp = pdFALSE;
+#endif
+    vListInitialiseItem(&pxThread->xThreadListItem);
+    listSET_LIST_ITEM_OWNER(&pxThread->xThreadListItem, pxThread);
+
+    return pxThread;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configPOSIX_SWITCH_BACKEND == portSWITCH_SIGNAL )
+
 /*
  * See header file for description.
  */
 portSTACK_TYPE *pxPortInitialiseStack(portSTACK_TYPE *pxTopOfStack,
+                                      portSTACK_TYPE *pxEndOfStack,
                                       pdTASK_CODE pxCode, void *pvParameters)
 {
-    /* Should actually keep this struct on the stack. */
-    xParams *pxThisThreadParams = pvPortMalloc(sizeof(xParams));
+    xThreadState *pxThread;
 
     (void)pthread_once(&hSigSetupThread, prvSetupSignalsAndSchedulerPolicy);
 
@@ -150,51 +477,116 @@ portSTACK_TYPE *pxPortInitialiseStack(portSTACK_TYPE *pxTopOfStack,
         hMainThread = pthread_self();
     }
 
-    /* No need to join the threads. */
-    pthread_attr_init(&xThreadAttributes);
-    pthread_attr_setdetachstate(&xThreadAttributes,
-                                PTHREAD_CREATE_DETACHED);
-
     /* Add the task parameters. */
-    pxThisThreadParams->pxCode = pxCode;
-    pxThisThreadParams->pvParams = pvParameters;
+    pxThread = prvInitialiseThreadState(pxTopOfStack, pxEndOfStack, pxCode,
+                                        pvParameters);
+    pxThread->hThread = (pthread_t)NULL;
+    pxTopOfStack = (portSTACK_TYPE *)pxThread - 1;
 
     vPortEnterCritical();
 
-    lIndexOfLastAddedTask = prvGetFreeThreadState();
+    vListInsertEnd(&xThreadList, &pxThread->xThreadListItem);
 
     /* Create the new pThread. */
     if (0 == pthread_mutex_lock(&xSingleThreadMutex)) {
-        xSentinel = 0;
-        if (0 !=
-            pthread_create(&(pxThreads[lIndexOfLastAddedTask].hThread),
-                           &xThreadAttributes, prvWaitForStart,
-                           (void *)pxThisThreadParams)) {
+        xThreadStarting = pdTRUE;
+        if (0 != prvStartThread(pxThread, &pxThread->hThread,
+                                (void *)pxThread)) {
             /* Thread create failed, signal the failure */
+            (void)uxListRemove(&pxThread->xThreadListItem);
             pxTopOfStack = 0;
+            xThreadStarting = pdFALSE;
         }
 
-        /* Wait until the task suspends. */
         (void)pthread_mutex_unlock(&xSingleThreadMutex);
-        while (xSentinel == 0)
-            ;
+
+        /* Sleep until the task suspends, the new thread needs the CPU. The
+        flag can already be cleared again, the post is there all the same. */
+        if (0 != pxTopOfStack) {
+            while ((0 != sem_wait(&xThreadParked)) && (EINTR == errno))
+                ;
+        }
         vPortExitCritical();
     }
 
     return pxTopOfStack;
 }
+
+#else
+
+/*
+ * See header file for description.
+ */
+portSTACK_TYPE *pxPortInitialiseStack(portSTACK_TYPE *pxTopOfStack,
+                                      portSTACK_TYPE *pxEndOfStack,
+                                      pdTASK_CODE pxCode, void *pvParameters)
+{
+    xThreadState *pxThread;
+
+    (void)pthread_once(&hSigSetupThread, prvSetupSignalsAndSchedulerPolicy);
+
+    if ((pthread_t)NULL == hMainThread) {
+        hMainThread = pthread_self();
+    }
+
+    /* Add the task parameters. */
+    pxThread = prvInitialiseThreadState(pxTopOfStack, pxEndOfStack, pxCode,
+                                        pvParameters);
+    pxTopOfStack = (portSTACK_TYPE *)pxThread - 1;
+
+    vPortEnterCritical();
+
+    /* Stacks taken from the pool come with a thread parked on the reserve. */
+    if (NULL == pxThread->pxEvent) {
+        pxThread->pxEvent = prvCreateThread(pxThread);
+    }
+
+    if (NULL != pxThread->pxEvent) {
+        /* The thread is parked until it is first resumed, only then does it
+        pick up the task bound to its stack here. */
+        pxThread->hThread = pxThread->pxEvent->hThread;
+        vListInsertEnd(&xThreadList, &pxThread->xThreadListItem);
+    }
+    else {
+        /* Thread create failed, signal the failure */
+        pxTopOfStack = 0;
+    }
+
+    vPortExitCritical();
+
+    return pxTopOfStack;
+}
+
+#endif /* configPOSIX_SWITCH_BACKEND */
 /*-----------------------------------------------------------*/
 
 void vPortStartFirstTask(void)
 {
+#if ( configNUMBER_OF_CORES > 1 )
+    xThreadState *pxThread;
+    BaseType_t xCoreID;
+#endif
+
     /* Initialise the critical nesting count ready for the first task. */
     uxCriticalNesting = 0;
 
     /* Start the first task. */
     vPortEnableInterrupts();
 
+#if ( configNUMBER_OF_CORES > 1 )
+    /* Every core starts on the task the kernel handed it. The lock keeps the
+    first of them from switching before the others are running. */
+    prvLockKernel();
+    for (xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++) {
+        pxThread = prvGetThreadState(xTaskGetCurrentTaskHandleForCore(xCoreID));
+        pxThread->xCoreID = xCoreID;
+        prvResumeThread(pxThread);
+    }
+    prvUnlockKernel();
+#else
     /* Start the first task. */
-    prvResumeThread(prvGetThreadHandle(xTaskGetCurrentTaskHandle()));
+    prvResumeThread(prvGetThreadState(xTaskGetCurrentTaskHandle()));
+#endif
 }
 /*-----------------------------------------------------------*/
 
@@ -204,22 +596,19 @@ void vPortStartFirstTask(void)
 portBASE_TYPE xPortStartScheduler(void)
 {
     /** portBASE_TYPE xResult; */
+#if ( configPOSIX_SWITCH_BACKEND == portSWITCH_SIGNAL )
     int iSignal;
     sigset_t xSignals;
+#endif
     sigset_t xSignalToBlock;
     sigset_t xSignalsBlocked;
-    portLONG lIndex;
 
     /* Establish the signals to block before they are needed. */
-    sigfillset(&xSignalToBlock);
+    prvFillSignalSet(&xSignalToBlock);
 
     /* Block until the end */
     (void)pthread_sigmask(SIG_SETMASK, &xSignalToBlock, &xSignalsBlocked);
 
-    for (lIndex = 0; lIndex < MAX_NUMBER_OF_TASKS; lIndex++) {
-        pxThreads[lIndex].uxCriticalNesting = 0;
-    }
-
     /* Start the timer that generates the tick ISR.  Interrupts are disabled
     here already. */
     prvSetupTimerInterrupt();
@@ -227,6 +616,7 @@ portBASE_TYPE xPortStartScheduler(void)
     /* Start the first task. Will not return unless all threads are killed. */
     vPortStartFirstTask();
 
+#if ( configPOSIX_SWITCH_BACKEND == portSWITCH_SIGNAL )
     /* This is the end signal we are looking for. */
     sigemptyset(&xSignals);
     sigaddset(&xSignals, SIG_RESUME);
@@ -236,37 +626,94 @@ portBASE_TYPE xPortStartScheduler(void)
             printf("Main thread spurious signal: %d\n", iSignal);
         }
     }
+#else
+    while (pdTRUE != xSchedulerEnd) {
+        (void)prvWaitEvent(&xSchedulerEndEvent);
+    }
+#endif
 
     printf("Cleaning Up, Exiting.\n");
+#if ( configPOSIX_SWITCH_BACKEND == portSWITCH_SIGNAL )
     /* Cleanup the mutexes */
     /** xResult = pthread_mutex_destroy( &xSuspendResumeThreadMutex ); */
     pthread_mutex_destroy(&xSuspendResumeThreadMutex);
     /** xResult = pthread_mutex_destroy( &xSingleThreadMutex ); */
     pthread_mutex_destroy(&xSingleThreadMutex);
-    vPortFree((void *)pxThreads);
+#endif
 
     /* Should not get here! */
     return 0;
 }
 /*-----------------------------------------------------------*/
 
+#if ( configPOSIX_SWITCH_BACKEND == portSWITCH_SIGNAL )
+
 void vPortEndScheduler(void)
 {
-    portBASE_TYPE xNumberOfThreads;
+    xThreadState *pxThread;
     /** portBASE_TYPE xResult; */
-    for (xNumberOfThreads = 0; xNumberOfThreads < MAX_NUMBER_OF_TASKS;
-         xNumberOfThreads++) {
-        if ((pthread_t)NULL != pxThreads[xNumberOfThreads].hThread) {
-            /* Kill all of the threads, they are in the detached state. */
-            pthread_cancel(pxThreads[xNumberOfThreads].hThread);
-            /** xResult = pthread_cancel( pxThreads[ xNumberOfThreads ].hThread ); */
-        }
+    while (listCURRENT_LIST_LENGTH(&xThreadList) > 0) {
+        pxThread = listGET_OWNER_OF_HEAD_ENTRY(&xThreadList);
+        (void)uxListRemove(&pxThread->xThreadListItem);
+        /* Kill all of the threads, nothing waits for them to end. */
+        pthread_cancel(pxThread->hThread);
+        /** xResult = pthread_cancel( pxThread->hThread ); */
     }
 
     /* Signal the scheduler to exit its loop. */
     xSchedulerEnd = pdTRUE;
     (void)pthread_kill(hMainThread, SIG_RESUME);
 }
+
+#else
+
+void vPortEndScheduler(void)
+{
+    xThreadState *pxThread;
+    xThreadEvent *pxSelfEvent = NULL;
+#if ( portUSE_THREAD_POOL == 1 )
+    xThreadEvent *pxEvent;
+#endif
+
+    (void)pthread_sigmask(SIG_SETMASK, &xAllSignals, NULL);
+#if ( configNUMBER_OF_CORES > 1 )
+    /* Never given back, the other cores stop at their next critical section. */
+    prvLockKernel();
+#endif
+
+    while (listCURRENT_LIST_LENGTH(&xThreadList) > 0) {
+        pxThread = listGET_OWNER_OF_HEAD_ENTRY(&xThreadList);
+        if (pxThread->hThread == pthread_self()) {
+            (void)uxListRemove(&pxThread->xThreadListItem);
+            pxSelfEvent = pxThread->pxEvent;
+        }
+        else {
+            /* Parked threads wake up and exit by themselves. */
+            (void)uxListRemove(&pxThread->xThreadListItem);
+            prvSignalEvent(pxThread->pxEvent, portWAKE_EXIT);
+        }
+    }
+
+#if ( portUSE_THREAD_POOL == 1 )
+    while (NULL != pxPooledThreads) {
+        pxEvent = pxPooledThreads;
+        pxPooledThreads = pxEvent->pxNextPooled;
+        prvSignalEvent(pxEvent, portWAKE_EXIT);
+    }
+    uxPooledThreads = 0;
+#endif
+
+    /* Signal the scheduler to exit its loop. */
+    xSchedulerEnd = pdTRUE;
+    prvSignalEvent(&xSchedulerEndEvent, portWAKE_RESUME);
+
+    if (NULL != pxSelfEvent) {
+        /* Called from a task, which must not keep running on its own. */
+        siglongjmp(pxSelfEvent->xReserveJump, portWAKE_EXIT);
+    }
+}
+
+#endif /* configPOSIX_SWITCH_BACKEND */
 /*-----------------------------------------------------------*/
 
 void vPortYieldFromISR(void)
@@ -275,13 +722,43 @@ void vPortYieldFromISR(void)
      * xSingleThreadMutex is already owned by an original call to Yield. Therefore,
      * simply indicate that a yield is required soon.
      */
-    xPendYield = pdTRUE;
+#if ( configNUMBER_OF_CORES > 1 )
+    if (NULL == pxOwnThread) {
+        /* Nothing on this thread would notice the pended yield. */
+        vPortYieldCore(0);
+        return;
+    }
+#endif
+    prvPendInterrupt(portPENDING_YIELD);
+    prvWakeIdle();
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Like an interrupt waking the core. The tick mutex is not taken as this may
+ * run in a signal handler, a wake up lost to that only lasts until the idle
+ * task's deadline.
+ */
+void prvWakeIdle(void)
+{
+#if ( ( configPOSIX_TICK_SOURCE != portTICK_SOURCE_ITIMER ) && ( configUSE_TICKLESS_IDLE != 0 ) )
+    /* Pairs with the fence in vPortSuppressTicksAndSleep(), either this sees
+    the idle task asleep or it sees the pending IRQ. */
+    atomic_thread_fence(memory_order_seq_cst);
+    if (pdTRUE == xTicksSuppressed) {
+        xIdleWake = pdTRUE;
+        (void)pthread_cond_signal(&xIdleWakeCond);
+    }
+#endif
 }
 /*-----------------------------------------------------------*/
 
 void vPortEnterCritical(void)
 {
     vPortDisableInterrupts();
+#if ( configNUMBER_OF_CORES > 1 )
+    prvLockKernelForTask();
+#endif
     uxCriticalNesting++;
 }
 /*-----------------------------------------------------------*/
@@ -291,229 +768,1537 @@ void vPortExitCritical(void)
     /* Check for unmatched exits. */
     if (uxCriticalNesting > 0) {
         uxCriticalNesting--;
+#if ( configNUMBER_OF_CORES > 1 )
+        prvUnlockKernel();
+#endif
     }
 
-    /* If we have reached 0 then re-enable the interrupts. */
+    /* If we have reached 0 then re-enable the interrupts, which replays those
+    that came in meanwhile. */
     if (uxCriticalNesting == 0) {
-        /* Have we missed ticks? This is the equivalent of pending an interrupt. */
-        if (pdTRUE == xPendYield) {
-            xPendYield = pdFALSE;
-            vPortYield();
-        }
         vPortEnableInterrupts();
     }
 }
 /*-----------------------------------------------------------*/
 
+#if ( configPOSIX_SWITCH_BACKEND == portSWITCH_SIGNAL )
+
 void vPortYield(void)
 {
-    pthread_t xTaskToSuspend;
-    pthread_t xTaskToResume = 0;
+    xThreadState *pxThreadToSuspend;
+    xThreadState *pxThreadToResume;
+    sigset_t xSavedSignals;
+
+    /* An ISR must not see the kernel half way through the switch, nor get
+    stuck at a yield it asks for while the mutex is held. It runs once the
+    task is back. */
+    (void)pthread_sigmask(SIG_BLOCK, &xIrqSignal, &xSavedSignals);
 
     if (0 == pthread_mutex_lock(&xSingleThreadMutex)) {
-        xTaskToSuspend =
-            prvGetThreadHandle(xTaskGetCurrentTaskHandle());
+        pxThreadToSuspend = prvGetThreadState(xTaskGetCurrentTaskHandle());
 
         vTaskSwitchContext();
+#if ( configPOSIX_TICK_SOURCE == portTICK_SOURCE_VIRTUAL )
+        prvAdvanceVirtualTime();
+#endif
 
-        TaskHandle_t task_handle = xTaskGetCurrentTaskHandle();
-        xTaskToResume = prvGetThreadHandle(task_handle);
-        /** xTaskToResume = prvGetThreadHandle( xTaskGetCurrentTaskHandle() ); */
-        if (xTaskToSuspend != xTaskToResume && xTaskToResume) {
+        pxThreadToResume = prvGetThreadState(xTaskGetCurrentTaskHandle());
+        if (pxThreadToSuspend != pxThreadToResume) {
             /* Remember and switch the critical nesting. */
-            prvSetTaskCriticalNesting(xTaskToSuspend,
-                                      uxCriticalNesting);
-            uxCriticalNesting =
-                prvGetTaskCriticalNesting(xTaskToResume);
+            pxThreadToSuspend->uxCriticalNesting = uxCriticalNesting;
+            uxCriticalNesting = pxThreadToResume->uxCriticalNesting;
             /* Switch tasks. */
-            prvResumeThread(xTaskToResume);
-            prvSuspendThread(xTaskToSuspend);
+            prvResumeThread(pxThreadToResume);
+            prvSuspendThread(pxThreadToSuspend);
+            prvRestoreTaskInterrupts();
         }
         else {
             /* Yielding to self */
             (void)pthread_mutex_unlock(&xSingleThreadMutex);
         }
     }
+
+    (void)pthread_sigmask(SIG_SETMASK, &xSavedSignals, NULL);
 }
-/*-----------------------------------------------------------*/
 
-void vPortDisableInterrupts(void)
+#elif ( configNUMBER_OF_CORES > 1 )
+
+void vPortYield(void)
 {
-    xInterruptsEnabled = pdFALSE;
+    sigset_t xSavedSignals;
+
+    /* Only task threads have a core to switch. */
+    if (NULL == pxOwnThread) {
+        return;
+    }
+
+    (void)pthread_sigmask(SIG_SETMASK, &xAllSignals, &xSavedSignals);
+    prvLockKernel();
+    prvSwitchCore();
+    prvUnlockKernel();
+    (void)pthread_sigmask(SIG_SETMASK, &xSavedSignals, NULL);
 }
 /*-----------------------------------------------------------*/
 
-void vPortEnableInterrupts(void)
+/*
+ * Switches the calling thread's core to the task the kernel selects for it.
+ * Called with the kernel lock held and every signal blocked. The lock is given
+ * up while the thread is parked, and taken again once it is resumed on
+ * whichever core that is.
+ */
+void prvSwitchCore(void)
 {
-    xInterruptsEnabled = pdTRUE;
+    BaseType_t xCoreID;
+    xThreadState *pxThreadToResume;
+    xThreadEvent *pxEventToPark;
+    unsigned portBASE_TYPE uxLockDepth;
+
+    do {
+        xCoreID = pxOwnThread->xCoreID;
+
+        if (0 == xCoreID) {
+            (void)prvTakeTicks();
+        }
+
+        vTaskSwitchContext();
+        xCoreYieldPending[xCoreID] = pdFALSE;
+
+        pxThreadToResume =
+            prvGetThreadState(xTaskGetCurrentTaskHandleForCore(xCoreID));
+        if (pxOwnThread == pxThreadToResume) {
+            break;
+        }
+
+        /* Once the lock is given up another core may delete this task, the
+        event is looked up beforehand. */
+        pxEventToPark = pxOwnThread->pxEvent;
+        pxThreadToResume->xCoreID = xCoreID;
+        prvResumeThread(pxThreadToResume);
+
+        uxLockDepth = uxKernelLockDepth;
+        uxKernelLockDepth = 0;
+        (void)pthread_mutex_unlock(&xKernelLock);
+
+        prvParkThread(pxEventToPark);
+
+        (void)pthread_mutex_lock(&xKernelLock);
+        uxKernelLockDepth = uxLockDepth;
+
+        /* The core it was resumed on may have been asked to switch again
+        before this thread got the lock. */
+    } while (pdTRUE == xCoreYieldPending[pxOwnThread->xCoreID]);
 }
 /*-----------------------------------------------------------*/
 
-portBASE_TYPE xPortSetInterruptMask(void)
+void prvLockKernel(void)
 {
-    portBASE_TYPE xReturn = xInterruptsEnabled;
-    xInterruptsEnabled = pdFALSE;
-    return xReturn;
+    if (0 == uxKernelLockDepth) {
+        (void)pthread_mutex_lock(&xKernelLock);
+    }
+    uxKernelLockDepth++;
 }
 /*-----------------------------------------------------------*/
 
-void vPortClearInterruptMask(portBASE_TYPE xMask)
+void prvUnlockKernel(void)
 {
-    xInterruptsEnabled = xMask;
+    if ((uxKernelLockDepth > 0) && (0 == --uxKernelLockDepth)) {
+        (void)pthread_mutex_unlock(&xKernelLock);
+    }
 }
 /*-----------------------------------------------------------*/
 
 /*
- * Setup the systick timer to generate the tick interrupts at the required
- * frequency.
+ * Takes the lock on behalf of the kernel API, with interrupts disabled. While
+ * the task waited for it another core may have deleted, suspended or preempted
+ * the task and asked this core to switch. The task must not carry on into the
+ * kernel, so the switch is done first.
  */
-void prvSetupTimerInterrupt(void)
+void prvLockKernelForTask(void)
 {
-    struct itimerval itimer, oitimer;
-    portTickType xMicroSeconds = portTICK_RATE_MICROSECONDS;
-
-    /* Initialise the structure with the current timer information. */
-    if (0 == getitimer(TIMER_TYPE, &itimer)) {
-        /* Set the interval between timer events. */
-        itimer.it_interval.tv_sec = 0;
-        itimer.it_interval.tv_usec = xMicroSeconds;
+    sigset_t xSavedSignals;
 
-        /* Set the current count-down. */
-        itimer.it_value.tv_sec = 0;
-        itimer.it_value.tv_usec = xMicroSeconds;
+    prvLockKernel();
 
-        /* Set-up the timer interrupt. */
-        if (0 != setitimer(TIMER_TYPE, &itimer, &oitimer)) {
-            printf("Set Timer problem.\n");
-        }
-    }
-    else {
-        printf("Get Timer problem.\n");
+    if ((1 == uxKernelLockDepth) && (NULL != pxOwnThread) && (0 == uxIrqNesting) &&
+        (pdTRUE == xCoreYieldPending[pxOwnThread->xCoreID])) {
+        (void)pthread_sigmask(SIG_SETMASK, &xAllSignals, &xSavedSignals);
+        prvSwitchCore();
+        (void)pthread_sigmask(SIG_SETMASK, &xSavedSignals, NULL);
     }
 }
 /*-----------------------------------------------------------*/
 
-void vPortSystemTickHandler(int sig)
+/*
+ * portGET_TASK_LOCK() and portRELEASE_TASK_LOCK() bracket the scheduler being
+ * suspended. Interrupts stay enabled, the tick handler takes the lock again
+ * should it come in meanwhile.
+ */
+void vPortTakeKernelLock(void)
 {
-    pthread_t xTaskToSuspend;
-    pthread_t xTaskToResume;
-
-    if ((pdTRUE == xInterruptsEnabled) && (pdTRUE != xServicingTick)) {
-        if (0 == pthread_mutex_trylock(&xSingleThreadMutex)) {
-            xServicingTick = pdTRUE;
+    portBASE_TYPE xEnabled = xInterruptsEnabled;
 
-            xTaskToSuspend =
-                prvGetThreadHandle(xTaskGetCurrentTaskHandle());
-            /* Tick Increment. */
-            xTaskIncrementTick();
-
-            /* Select Next Task. */
-#if (configUSE_PREEMPTION == 1)
-            vTaskSwitchContext();
-#endif
-            xTaskToResume =
-                prvGetThreadHandle(xTaskGetCurrentTaskHandle());
-
-            /* The only thread that can process this tick is the running thread. */
-            if (xTaskToSuspend != xTaskToResume) {
-                /* Remember and switch the critical nesting. */
-                prvSetTaskCriticalNesting(xTaskToSuspend,
-                                          uxCriticalNesting);
-                uxCriticalNesting = prvGetTaskCriticalNesting(
-                                        xTaskToResume);
-                /* Resume next task. */
-                prvResumeThread(xTaskToResume);
-                /* Suspend the current task. */
-                prvSuspendThread(xTaskToSuspend);
-            }
-            else {
-                /* Release the lock as we are Resuming. */
-                (void)pthread_mutex_unlock(&xSingleThreadMutex);
-            }
-            xServicingTick = pdFALSE;
-        }
-        else {
-            xPendYield = pdTRUE;
-        }
-    }
-    else {
-        xPendYield = pdTRUE;
-    }
+    vPortDisableInterrupts();
+    prvLockKernelForTask();
+    prvRestoreInterrupts(xEnabled);
 }
 /*-----------------------------------------------------------*/
 
-void vPortForciblyEndThread(void *pxTaskToDelete)
+void vPortGiveKernelLock(void)
 {
-    xTaskHandle hTaskToDelete = (xTaskHandle)pxTaskToDelete;
-    pthread_t xTaskToDelete;
-    pthread_t xTaskToResume;
-    /** portBASE_TYPE xResult; */
+    portBASE_TYPE xEnabled = xInterruptsEnabled;
 
-    if (0 == pthread_mutex_lock(&xSingleThreadMutex)) {
-        xTaskToDelete = prvGetThreadHandle(hTaskToDelete);
-        xTaskToResume = prvGetThreadHandle(xTaskGetCurrentTaskHandle());
-
-        if (xTaskToResume == xTaskToDelete) {
-            /* This is a suicidal thread, need to select a different task to run. */
-            vTaskSwitchContext();
-            xTaskToResume =
-                prvGetThreadHandle(xTaskGetCurrentTaskHandle());
-        }
-
-        if (pthread_self() != xTaskToDelete) {
-            /* Cancelling a thread that is not me. */
-            if (xTaskToDelete != (pthread_t)NULL) {
-                /* Send a signal to wake the task so that it definitely cancels. */
-                pthread_testcancel();
-                pthread_cancel(xTaskToDelete);
-                /** xResult = pthread_cancel( xTaskToDelete ); */
-                /* Pthread Clean-up function will note the cancellation. */
-            }
-            (void)pthread_mutex_unlock(&xSingleThreadMutex);
-        }
-        else {
-            /* Resume the other thread. */
-            prvResumeThread(xTaskToResume);
-            /* Pthread Clean-up function will note the cancellation. */
-            /* Release the execution. */
-            uxCriticalNesting = 0;
-            vPortEnableInterrupts();
-            (void)pthread_mutex_unlock(&xSingleThreadMutex);
-            /* Commit suicide */
-            pthread_exit((void *)1);
-        }
-    }
+    vPortDisableInterrupts();
+    prvUnlockKernel();
+    prvRestoreInterrupts(xEnabled);
 }
 /*-----------------------------------------------------------*/
 
-void *prvWaitForStart(void *pvParams)
+BaseType_t xPortGetCoreID(void)
 {
-    xParams *pxParams = (xParams *)pvParams;
-    pdTASK_CODE pvCode = pxParams->pxCode;
-    void *pParams = pxParams->pvParams;
-    vPortFree(pvParams);
+    return (NULL != pxOwnThread) ? pxOwnThread->xCoreID : 0;
+}
+/*-----------------------------------------------------------*/
 
-    pthread_cleanup_push(prvDeleteThread, (void *)pthread_self());
+/*
+ * Called by the kernel with the lock held. A core that switches tasks before
+ * the signal arrives has done what was asked, its handler finds nothing pending.
+ */
+void vPortYieldCore(BaseType_t xCoreID)
+{
+    pthread_t hThread = hRunningThreads[xCoreID];
 
-    if (0 == pthread_mutex_lock(&xSingleThreadMutex)) {
-        prvSuspendThread(pthread_self());
+    xCoreYieldPending[xCoreID] = pdTRUE;
+    if ((pthread_t)NULL != hThread) {
+        (void)pthread_kill(hThread, SIG_YIELD_CORE);
     }
-
-    pvCode(pParams);
-
-    pthread_cleanup_pop(1);
-    return (void *)NULL;
 }
 /*-----------------------------------------------------------*/
 
-void prvSuspendSignalHandler(int sig)
+void prvYieldCoreSignalHandler(int sig)
 {
-    sigset_t xSignals;
+    (void)sig;
 
-    /* Only interested in the resume signal. */
-    sigemptyset(&xSignals);
-    sigaddset(&xSignals, SIG_RESUME);
-    xSentinel = 1;
+    if (NULL == pxOwnThread) {
+        return;
+    }
+
+    if (pdTRUE == xInterruptsEnabled) {
+        vPortDisableInterrupts();
+        prvLockKernel();
+        if (pdTRUE == xCoreYieldPending[pxOwnThread->xCoreID]) {
+            prvSwitchCore();
+        }
+        prvUnlockKernel();
+        vPortEnableInterrupts();
+    }
+    else {
+        prvPendInterrupt(portPENDING_YIELD);
+    }
+}
+
+#else
+
+void vPortYield(void)
+{
+    xThreadState *pxThreadToSuspend;
+    xThreadState *pxThreadToResume;
+    xThreadEvent *pxEventToPark;
+    sigset_t xSavedSignals;
+
+    /* Blocking the tick keeps this thread from being preempted while it
+    switches, and keeps it from taking ticks while it is parked. */
+    (void)pthread_sigmask(SIG_SETMASK, &xAllSignals, &xSavedSignals);
+
+    pxThreadToSuspend = prvGetThreadState(xTaskGetCurrentTaskHandle());
+
+    vTaskSwitchContext();
+#if ( configPOSIX_TICK_SOURCE == portTICK_SOURCE_VIRTUAL )
+    prvAdvanceVirtualTime();
+#endif
+
+    pxThreadToResume = prvGetThreadState(xTaskGetCurrentTaskHandle());
+    if (pxThreadToSuspend != pxThreadToResume) {
+        /* Remember and switch the critical nesting. */
+        pxThreadToSuspend->uxCriticalNesting = uxCriticalNesting;
+        uxCriticalNesting = pxThreadToResume->uxCriticalNesting;
+        /* Switch tasks. Once the next task runs it may delete this one and
+        free its stack, so the event is looked up beforehand. */
+        pxEventToPark = pxThreadToSuspend->pxEvent;
+        prvResumeThread(pxThreadToResume);
+        prvParkThread(pxEventToPark);
+        prvRestoreTaskInterrupts();
+    }
+
+    (void)pthread_sigmask(SIG_SETMASK, &xSavedSignals, NULL);
+}
+
+#endif /* configPOSIX_SWITCH_BACKEND */
+/*-----------------------------------------------------------*/
+
+void vPortDisableInterrupts(void)
+{
+    atomic_store(&xInterruptsEnabled, pdFALSE);
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnableInterrupts(void)
+{
+    atomic_store(&xInterruptsEnabled, pdTRUE);
+
+    /* An interrupt that came in before the store is pending, one that comes in
+    after it is taken by its handler. An ISR leaves them to prvDispatchIrqs(). */
+    if ((0 != atomic_load(&uxPendingInterrupts)) && (0 == uxIrqNesting)) {
+        prvReplayInterrupts();
+    }
+}
+/*-----------------------------------------------------------*/
+
+portBASE_TYPE xPortSetInterruptMask(void)
+{
+    portBASE_TYPE xReturn = atomic_exchange(&xInterruptsEnabled, pdFALSE);
+#if ( configNUMBER_OF_CORES > 1 )
+    prvLockKernelForTask();
+#endif
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortClearInterruptMask(portBASE_TYPE xMask)
+{
+#if ( configNUMBER_OF_CORES > 1 )
+    prvUnlockKernel();
+#endif
+    prvRestoreInterrupts(xMask);
+}
+/*-----------------------------------------------------------*/
+
+void prvRestoreInterrupts(portBASE_TYPE xEnabled)
+{
+    if (pdFALSE != xEnabled) {
+        vPortEnableInterrupts();
+    }
+    else {
+        vPortDisableInterrupts();
+    }
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Tick sources count each tick before raising its signal. The tick is pending
+ * until taken, whichever tick signal gets there first takes it.
+ */
+void prvCountRaisedTick(void)
+{
+    (void)atomic_fetch_add(&ullTicksRaised, 1);
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * With the itimer the kernel raises the tick, the port only passes the signal
+ * on or replays it.
+ */
+void prvCountTimerTick(const siginfo_t *pxInfo)
+{
+#if ( configPOSIX_TICK_SOURCE == portTICK_SOURCE_ITIMER )
+    if (SI_KERNEL == pxInfo->si_code) {
+        prvCountRaisedTick();
+    }
+#else
+    (void)pxInfo;
+#endif
+}
+/*-----------------------------------------------------------*/
+
+#if ( configNUMBER_OF_CORES == 1 )
+
+/*
+ * A task resumed where it was switched out gets its own interrupt state back,
+ * which is all it takes as nested critical sections only mask interrupts. With
+ * more than one core the state stays with the thread anyway.
+ */
+void prvRestoreTaskInterrupts(void)
+{
+    atomic_store(&xInterruptsEnabled, (0 == uxCriticalNesting) ? pdTRUE : pdFALSE);
+}
+
+#endif
+/*-----------------------------------------------------------*/
+
+/*
+ * Hands every pending tick to the kernel and returns how many there were. Only
+ * one thread at a time gets here: the running task's, core 0's with the kernel
+ * lock held, or with the signal backend whichever holds its mutex.
+ */
+unsigned portBASE_TYPE prvTakeTicks(void)
+{
+    uint64_t ullRaised = atomic_load(&ullTicksRaised);
+    uint64_t ullTaken = atomic_load(&ullTicksTaken);
+    unsigned portBASE_TYPE uxTicks = (unsigned portBASE_TYPE)(ullRaised - ullTaken);
+
+    for (; ullTaken != ullRaised; ullTaken++) {
+        (void)xTaskIncrementTick();
+    }
+    atomic_store(&ullTicksTaken, ullRaised);
+
+    return uxTicks;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Called by handlers that find interrupts masked, and for yields asked for from
+ * an ISR.
+ */
+void prvPendInterrupt(unsigned portBASE_TYPE uxInterrupt)
+{
+    if (portPENDING_TICK == uxInterrupt) {
+        (void)atomic_fetch_add(&ullTicksDeferred, 1);
+    }
+    (void)atomic_fetch_or(&uxPendingInterrupts, uxInterrupt);
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Called once interrupts are enabled again. Ticks and IRQs are raised at the
+ * calling thread, so their handlers take them with the same locking as ever.
+ */
+void prvReplayInterrupts(void)
+{
+    unsigned portBASE_TYPE uxPending = atomic_exchange(&uxPendingInterrupts, 0);
+
+    if (0 != (uxPending & portPENDING_TICK)) {
+        (void)atomic_fetch_add(&ullTicksReplayed, 1);
+        (void)pthread_kill(pthread_self(), SIG_TICK);
+    }
+    if (0 != (uxPending & portPENDING_IRQ)) {
+        (void)pthread_kill(pthread_self(), SIG_IRQ);
+    }
+    if (0 != (uxPending & portPENDING_YIELD)) {
+        vPortYield();
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetInterruptStats(xPortInterruptStats *pxStats)
+{
+    uint64_t ullTaken = atomic_load(&ullTicksTaken);
+    uint64_t ullRaised = atomic_load(&ullTicksRaised);
+
+    pxStats->ullTicksRaised = ullRaised - xInterruptStatsBase.ullTicksRaised;
+    pxStats->ullTicksTaken = ullTaken - xInterruptStatsBase.ullTicksTaken;
+    pxStats->ullTicksPending = ullRaised - ullTaken;
+    pxStats->ullTicksDeferred = atomic_load(&ullTicksDeferred) -
+                                xInterruptStatsBase.ullTicksDeferred;
+    pxStats->ullTicksReplayed = atomic_load(&ullTicksReplayed) -
+                                xInterruptStatsBase.ullTicksReplayed;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * The counters keep running, tick sources and handlers never see the reset.
+ */
+void vPortResetInterruptStats(void)
+{
+    xInterruptStatsBase.ullTicksRaised = atomic_load(&ullTicksRaised);
+    xInterruptStatsBase.ullTicksTaken = atomic_load(&ullTicksTaken);
+    xInterruptStatsBase.ullTicksDeferred = atomic_load(&ullTicksDeferred);
+    xInterruptStatsBase.ullTicksReplayed = atomic_load(&ullTicksReplayed);
+}
+/*-----------------------------------------------------------*/
+
+portBASE_TYPE xPortInstallIrqHandler(unsigned portBASE_TYPE uxIrq,
+                                     xPortIrqHandler pxHandler, void *pvParameter,
+                                     unsigned portBASE_TYPE uxPriority)
+{
+    sigset_t xSavedSignals;
+
+    if ((uxIrq >= configPOSIX_NUM_IRQS) || (uxPriority > portLOWEST_IRQ_PRIORITY)) {
+        return pdFAIL;
+    }
+
+    /* Masking interrupts would leave the lines more urgent than
+    configMAX_SYSCALL_INTERRUPT_PRIORITY running. */
+    (void)pthread_once(&hSigSetupThread, prvSetupSignalsAndSchedulerPolicy);
+    (void)pthread_sigmask(SIG_BLOCK, &xIrqSignal, &xSavedSignals);
+    xIrqLines[uxIrq].pxHandler = NULL;
+    xIrqLines[uxIrq].pvParameter = pvParameter;
+    xIrqLines[uxIrq].uxPriority = uxPriority;
+    atomic_thread_fence(memory_order_release);
+    xIrqLines[uxIrq].pxHandler = pxHandler;
+    (void)pthread_sigmask(SIG_SETMASK, &xSavedSignals, NULL);
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Safe to call from any thread, including signal handlers. A line raised again
+ * before its ISR ran runs once.
+ */
+portBASE_TYPE xPortRaiseIrq(unsigned portBASE_TYPE uxIrq)
+{
+    pthread_t hThread;
+
+    if ((uxIrq >= configPOSIX_NUM_IRQS) || (NULL == xIrqLines[uxIrq].pxHandler)) {
+        return pdFAIL;
+    }
+
+    (void)atomic_fetch_or(&ulIrqsPending, 1UL << uxIrq);
+
+    /* Without a running task yet, the first one takes it when it starts. */
+    hThread = prvGetIrqThread();
+    if ((pthread_t)NULL != hThread) {
+        (void)pthread_kill(hThread, SIG_IRQ);
+    }
+    /* The idle task sleeps with every signal blocked. */
+    prvWakeIdle();
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortIsInsideInterrupt(void)
+{
+    return (uxIrqNesting > 0) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Called by the ...FromISR() API, which more urgent lines must not use.
+ */
+void vPortValidateInterruptPriority(void)
+{
+    if (uxIrqNesting > 0) {
+        configASSERT(uxIrqPriority >= configMAX_SYSCALL_INTERRUPT_PRIORITY);
+    }
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * The thread ISRs run on, the running task's. With more than one core that is
+ * core 0's.
+ */
+pthread_t prvGetIrqThread(void)
+{
+#if ( configPOSIX_SWITCH_BACKEND == portSWITCH_SIGNAL )
+    TaskHandle_t xTask = xTaskGetCurrentTaskHandle();
+
+    return (NULL != xTask) ? prvGetThreadState(xTask)->hThread : (pthread_t)NULL;
+#else
+    return hRunningThreads[0];
+#endif
+}
+/*-----------------------------------------------------------*/
+
+void prvIrqSignalHandler(int sig)
+{
+    pthread_t hThread = prvGetIrqThread();
+
+    (void)sig;
+
+    /* Passed on like the tick, every signal is blocked in the handler. */
+#if ( configNUMBER_OF_CORES > 1 )
+    if ((NULL == pxOwnThread) || (0 != pxOwnThread->xCoreID)) {
+#else
+    if (pthread_self() != hThread) {
+#endif
+        if ((pthread_t)NULL != hThread) {
+            (void)pthread_kill(hThread, SIG_IRQ);
+        }
+        return;
+    }
+
+    prvDispatchIrqs();
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Runs the pending lines more urgent than what the thread was running, the most
+ * urgent first, and each with its priority as the one to beat. Masked interrupts
+ * hold back the lines that may call the kernel, like BASEPRI on a Cortex-M.
+ * Called from the SIG_IRQ handler with every signal blocked, SIG_IRQ is let in
+ * while an ISR runs so it can be preempted.
+ */
+void prvDispatchIrqs(void)
+{
+    unsigned portBASE_TYPE uxPreempted = uxIrqPriority;
+    unsigned portBASE_TYPE uxThreshold, uxIrq, uxSelected;
+    uint32_t ulPending;
+    xIrqLine *pxLine;
+
+    for (;;) {
+        uxThreshold = uxPreempted;
+        if ((pdTRUE != xInterruptsEnabled) &&
+            (uxThreshold > configMAX_SYSCALL_INTERRUPT_PRIORITY)) {
+            uxThreshold = configMAX_SYSCALL_INTERRUPT_PRIORITY;
+        }
+
+        ulPending = atomic_load(&ulIrqsPending);
+        uxSelected = configPOSIX_NUM_IRQS;
+        for (uxIrq = 0; uxIrq < configPOSIX_NUM_IRQS; uxIrq++) {
+            if ((0 != (ulPending & (1UL << uxIrq))) &&
+                (xIrqLines[uxIrq].uxPriority < uxThreshold) &&
+                ((configPOSIX_NUM_IRQS == uxSelected) ||
+                 (xIrqLines[uxIrq].uxPriority < xIrqLines[uxSelected].uxPriority))) {
+                uxSelected = uxIrq;
+            }
+        }
+        if (configPOSIX_NUM_IRQS == uxSelected) {
+            break;
+        }
+
+        (void)atomic_fetch_and(&ulIrqsPending, ~(1UL << uxSelected));
+        atomic_thread_fence(memory_order_acquire);
+        pxLine = &xIrqLines[uxSelected];
+
+        uxIrqPriority = pxLine->uxPriority;
+        uxIrqNesting++;
+        (void)pthread_sigmask(SIG_UNBLOCK, &xIrqSignal, NULL);
+        pxLine->pxHandler(pxLine->pvParameter);
+        (void)pthread_sigmask(SIG_BLOCK, &xIrqSignal, NULL);
+        uxIrqNesting--;
+        uxIrqPriority = uxPreempted;
+    }
+
+    if (0 != uxIrqNesting) {
+        return;
+    }
+
+    if (pdTRUE != xInterruptsEnabled) {
+        /* Held back lines run once interrupts are enabled again. */
+        if (0 != atomic_load(&ulIrqsPending)) {
+            prvPendInterrupt(portPENDING_IRQ);
+        }
+    }
+#if ( configPOSIX_SWITCH_BACKEND == portSWITCH_CONDVAR )
+    else if (0 != atomic_load(&uxPendingInterrupts)) {
+        /* Back to task code, which is where a yield asked for by an ISR
+        happens. */
+        prvReplayInterrupts();
+    }
+#else
+    else if (0 != (atomic_load(&uxPendingInterrupts) & portPENDING_YIELD)) {
+        prvYieldFromHandler();
+    }
+#endif
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Called by a thread that just became the running task. An IRQ raised at the
+ * thread it took over from waits there until that thread runs again.
+ */
+void prvCheckIrqs(void)
+{
+    if (0 != atomic_load(&ulIrqsPending)) {
+        (void)pthread_kill(pthread_self(), SIG_IRQ);
+    }
+}
+/*-----------------------------------------------------------*/
+
+#if ( configPOSIX_TICK_SOURCE == portTICK_SOURCE_ITIMER )
+
+/*
+ * Setup the systick timer to generate the tick interrupts at the required
+ * frequency.
+ */
+void prvSetupTimerInterrupt(void)
+{
+    struct itimerval itimer, oitimer;
+    portTickType xMicroSeconds = portTICK_RATE_MICROSECONDS;
+
+    /* Initialise the structure with the current timer information. */
+    if (0 == getitimer(TIMER_TYPE, &itimer)) {
+        /* Set the interval between timer events. */
+        itimer.it_interval.tv_sec = 0;
+        itimer.it_interval.tv_usec = xMicroSeconds;
+
+        /* Set the current count-down. */
+        itimer.it_value.tv_sec = 0;
+        itimer.it_value.tv_usec = xMicroSeconds;
+
+        /* Set-up the timer interrupt. */
+        if (0 != setitimer(TIMER_TYPE, &itimer, &oitimer)) {
+            printf("Set Timer problem.\n");
+        }
+    }
+    else {
+        printf("Get Timer problem.\n");
+    }
+}
+/*-----------------------------------------------------------*/
+
+#elif ( configPOSIX_TICK_SOURCE == portTICK_SOURCE_VIRTUAL )
+
+/*
+ * There is no timer, time only moves on in prvAdvanceVirtualTime().
+ */
+void prvSetupTimerInterrupt(void)
+{
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Called from vPortYield() with the next task selected. The idle task is only
+ * selected once every other task is blocked, which is when virtual time moves
+ * on: ticks are taken straight away until one of them unblocks a task. Time
+ * holds still while the idle task has deleted tasks to free, and while a task
+ * readied by an ISR waits for the scheduler to be resumed. Going through
+ * xTaskIncrementTick() keeps tick hooks, time slicing and software timers as
+ * they are with a real tick.
+ */
+void prvAdvanceVirtualTime(void)
+{
+    TaskHandle_t xIdleTask = xTaskGetIdleTaskHandle();
+
+    while ((xTaskGetCurrentTaskHandle() == xIdleTask) &&
+           (0 == uxThreadsAwaitingCleanUp) &&
+           (eStandardSleep == eTaskConfirmSleepModeStatus())) {
+        if (pdFALSE != xTaskIncrementTick()) {
+            vTaskSwitchContext();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * The idle task only gets to run once every task is blocked without a timeout,
+ * from then on nothing but an interrupt can make one ready again.
+ */
+void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime)
+{
+    sigset_t xSignals, xSavedSignals;
+    eSleepModeStatus eSleepStatus;
+
+    prvFillSignalSet(&xSignals);
+    (void)pthread_sigmask(SIG_SETMASK, &xSignals, &xSavedSignals);
+
+    pthread_mutex_lock(&xTickMutex);
+    eSleepStatus = eTaskConfirmSleepModeStatus();
+
+    if (eNoTasksWaitingTimeout == eSleepStatus) {
+        xTicksSuppressed = pdTRUE;
+        xIdleWake = pdFALSE;
+        atomic_thread_fence(memory_order_seq_cst);
+        if (0 != atomic_load(&ulIrqsPending)) {
+            xIdleWake = pdTRUE;
+        }
+
+        while (pdFALSE == xIdleWake) {
+            pthread_cond_wait(&xIdleWakeCond, &xTickMutex);
+        }
+
+        xTicksSuppressed = pdFALSE;
+    }
+    else if (eStandardSleep == eSleepStatus) {
+        /* Only if a task was delayed without passing through vPortYield(),
+        jump to the tick that unblocks it. */
+        vTaskStepTick(xExpectedIdleTime - 1);
+        prvCountRaisedTick();
+        (void)pthread_kill(pthread_self(), SIG_TICK);
+    }
+
+    pthread_mutex_unlock(&xTickMutex);
+
+    (void)pthread_sigmask(SIG_SETMASK, &xSavedSignals, NULL);
+}
+
+#endif /* configPOSIX_TICK_SOURCE */
+/*-----------------------------------------------------------*/
+
+#if ( configPOSIX_TICK_SOURCE != portTICK_SOURCE_THREAD )
+
+portBASE_TYPE xPortGetTickStats(xPortTickStats *pxStats)
+{
+    (void)pxStats;
+
+    return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortResetTickStats(void)
+{
+}
+
+#else
+
+/*
+ * Start the thread that generates the tick interrupts at the required
+ * frequency. It inherits the scheduler's blocked signals and never takes one.
+ */
+void prvSetupTimerInterrupt(void)
+{
+    pthread_attr_t xTickThreadAttributes;
+    pthread_condattr_t xMonotonicCondAttributes;
+
+    /* Deadlines are all taken on CLOCK_MONOTONIC. */
+    pthread_condattr_init(&xMonotonicCondAttributes);
+    pthread_condattr_setclock(&xMonotonicCondAttributes, CLOCK_MONOTONIC);
+    pthread_cond_init(&xTickCond, &xMonotonicCondAttributes);
+#if ( configUSE_TICKLESS_IDLE != 0 )
+    pthread_cond_init(&xIdleWakeCond, &xMonotonicCondAttributes);
+#endif
+    pthread_condattr_destroy(&xMonotonicCondAttributes);
+
+    /* Set before the idle task can sleep on it. */
+    (void)clock_gettime(CLOCK_MONOTONIC, &xNextTickDeadline);
+    prvAddNanoseconds(&xNextTickDeadline, portTICK_PERIOD_NANOSECONDS);
+
+    pthread_attr_init(&xTickThreadAttributes);
+    pthread_attr_setdetachstate(&xTickThreadAttributes,
+                                PTHREAD_CREATE_DETACHED);
+    prvSetHostScheduling(&xTickThreadAttributes, pdTRUE);
+
+    if (0 != pthread_create(&hTickThread, &xTickThreadAttributes,
+                            prvTickThread, NULL)) {
+        printf("Tick thread problem.\n");
+    }
+
+    pthread_attr_destroy(&xTickThreadAttributes);
+}
+/*-----------------------------------------------------------*/
+
+void *prvTickThread(void *pvParams)
+{
+    struct timespec xDeadline, xNow;
+    int64_t llLateness;
+
+#ifdef PR_SET_TIMERSLACK
+    /* Linux delays timer wake ups by 50us by default to batch them. */
+    (void)prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+#endif
+
+    pthread_mutex_lock(&xTickMutex);
+
+    while (pdTRUE != xSchedulerEnd) {
+        /* The idle task accounts for the ticks while they are suppressed. */
+        while (pdTRUE == xTicksSuppressed) {
+            pthread_cond_wait(&xTickCond, &xTickMutex);
+        }
+
+        /* Deadlines are absolute, so time spent raising the tick does not add
+        up. A late tick is followed by the ticks it overran straight away. */
+        xDeadline = xNextTickDeadline;
+        pthread_mutex_unlock(&xTickMutex);
+
+        while (EINTR == clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME,
+                                        &xDeadline, NULL))
+            ;
+
+        pthread_mutex_lock(&xTickMutex);
+        /* The tick was suppressed, or stepped over, while sleeping. */
+        if ((pdTRUE == xTicksSuppressed) ||
+            (0 != prvNanosecondsBetween(&xDeadline, &xNextTickDeadline))) {
+            continue;
+        }
+
+        (void)clock_gettime(CLOCK_MONOTONIC, &xNow);
+        llLateness = prvNanosecondsBetween(&xNextTickDeadline, &xNow);
+        prvRecordTickLateness(llLateness > 0 ? (uint64_t)llLateness : 0);
+
+        prvRaiseTick();
+        prvAddNanoseconds(&xNextTickDeadline, portTICK_PERIOD_NANOSECONDS);
+    }
+
+    pthread_mutex_unlock(&xTickMutex);
+
+    return (void *)NULL;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TICKLESS_IDLE != 0 )
+
+/*
+ * Called by the idle task with the scheduler suspended. The tick thread stops
+ * raising ticks while the idle task sleeps until the tick that unblocks the
+ * next task is due. On wake up the ticks that passed are stepped over, bar
+ * the last one, which has to be a real tick to unblock the task.
+ */
+void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime)
+{
+    struct timespec xWakeTime, xNow;
+    sigset_t xSignals, xSavedSignals;
+    TickType_t xElapsedTicks;
+    int64_t llSlept;
+
+#ifdef PR_SET_TIMERSLACK
+    (void)prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+#endif
+
+    /* A tick taken while sleeping would be counted again when stepping. Ticks
+    raised before are held back until the scheduler is resumed. */
+    prvFillSignalSet(&xSignals);
+    (void)pthread_sigmask(SIG_SETMASK, &xSignals, &xSavedSignals);
+
+    if (xExpectedIdleTime > portMAX_SUPPRESSED_TICKS) {
+        xExpectedIdleTime = portMAX_SUPPRESSED_TICKS;
+    }
+
+    pthread_mutex_lock(&xTickMutex);
+
+    if (eAbortSleep != eTaskConfirmSleepModeStatus()) {
+        xTicksSuppressed = pdTRUE;
+        xIdleWake = pdFALSE;
+        atomic_thread_fence(memory_order_seq_cst);
+        if (0 != atomic_load(&ulIrqsPending)) {
+            xIdleWake = pdTRUE;
+        }
+
+        xWakeTime = xNextTickDeadline;
+        prvAddNanoseconds(&xWakeTime, (uint64_t)(xExpectedIdleTime - 1) *
+                          portTICK_PERIOD_NANOSECONDS);
+
+        while ((pdFALSE == xIdleWake) &&
+               (ETIMEDOUT != pthread_cond_timedwait(&xIdleWakeCond, &xTickMutex,
+                                                    &xWakeTime)))
+            ;
+
+        /* Count the ticks whose deadline has passed. */
+        (void)clock_gettime(CLOCK_MONOTONIC, &xNow);
+        llSlept = prvNanosecondsBetween(&xNextTickDeadline, &xNow);
+        xElapsedTicks = (llSlept < 0) ? 0 :
+                        (TickType_t)(llSlept / portTICK_PERIOD_NANOSECONDS) + 1;
+
+        if (xElapsedTicks >= xExpectedIdleTime) {
+            xElapsedTicks = xExpectedIdleTime - 1;
+            prvAddNanoseconds(&xNextTickDeadline, (uint64_t)xElapsedTicks *
+                              portTICK_PERIOD_NANOSECONDS);
+
+            /* Raise the due tick at ourselves, it is taken once the signals
+            are unblocked again. Handing it to the tick thread would leave this
+            thread spinning until the host gets round to waking it. */
+            llSlept = prvNanosecondsBetween(&xNextTickDeadline, &xNow);
+            prvRecordTickLateness((uint64_t)llSlept);
+            prvCountRaisedTick();
+            (void)pthread_kill(pthread_self(), SIG_TICK);
+            prvAddNanoseconds(&xNextTickDeadline, portTICK_PERIOD_NANOSECONDS);
+        }
+        else {
+            prvAddNanoseconds(&xNextTickDeadline, (uint64_t)xElapsedTicks *
+                              portTICK_PERIOD_NANOSECONDS);
+        }
+
+        xTicksSuppressed = pdFALSE;
+        pthread_cond_signal(&xTickCond);
+        pthread_mutex_unlock(&xTickMutex);
+
+        vTaskStepTick(xElapsedTicks);
+    }
+    else {
+        pthread_mutex_unlock(&xTickMutex);
+    }
+
+    (void)pthread_sigmask(SIG_SETMASK, &xSavedSignals, NULL);
+}
+
+#endif /* configUSE_TICKLESS_IDLE */
+/*-----------------------------------------------------------*/
+
+void prvAddNanoseconds(struct timespec *pxTime, uint64_t ullNanoseconds)
+{
+    pxTime->tv_sec += ullNanoseconds / portNANOSECONDS_PER_SECOND;
+    pxTime->tv_nsec += ullNanoseconds % portNANOSECONDS_PER_SECOND;
+    if (pxTime->tv_nsec >= (long)portNANOSECONDS_PER_SECOND) {
+        pxTime->tv_nsec -= portNANOSECONDS_PER_SECOND;
+        pxTime->tv_sec++;
+    }
+}
+/*-----------------------------------------------------------*/
+
+int64_t prvNanosecondsBetween(const struct timespec *pxFrom,
+                              const struct timespec *pxTo)
+{
+    return (int64_t)(pxTo->tv_sec - pxFrom->tv_sec) *
+           (int64_t)portNANOSECONDS_PER_SECOND +
+           (pxTo->tv_nsec - pxFrom->tv_nsec);
+}
+/*-----------------------------------------------------------*/
+
+void prvRaiseTick(void)
+{
+    prvCountRaisedTick();
+
+#if ( configPOSIX_SWITCH_BACKEND == portSWITCH_CONDVAR )
+    pthread_t hThread = hRunningThreads[0];
+
+    /* Straight to the running task, saves the tick handler forwarding it. */
+    if ((pthread_t)NULL != hThread) {
+        (void)pthread_kill(hThread, SIG_TICK);
+    }
+#else
+    /* Parked threads block the tick in their suspend handler, the process
+    directed signal ends up with the running task. */
+    (void)kill(getpid(), SIG_TICK);
+#endif
+}
+/*-----------------------------------------------------------*/
+
+void prvRecordTickLateness(uint64_t ullLateness)
+{
+    uint64_t ullBucket = ullLateness / portTICK_HISTOGRAM_WIDTH;
+
+    if (ullBucket >= portTICK_HISTOGRAM_BUCKETS) {
+        ullBucket = portTICK_HISTOGRAM_BUCKETS - 1;
+    }
+
+    if ((0 == xTickStats.ullTicks) || (ullLateness < xTickStats.ullMinLateness)) {
+        xTickStats.ullMinLateness = ullLateness;
+    }
+    if (ullLateness > xTickStats.ullMaxLateness) {
+        xTickStats.ullMaxLateness = ullLateness;
+    }
+    if (ullLateness >= portTICK_PERIOD_NANOSECONDS) {
+        xTickStats.ullMissed++;
+    }
+    xTickStats.ullTicks++;
+    ullTickLatenessTotal += ullLateness;
+    ulTickHistogram[ullBucket]++;
+}
+/*-----------------------------------------------------------*/
+
+portBASE_TYPE xPortGetTickStats(xPortTickStats *pxStats)
+{
+    uint64_t ullRank, ullSeen = 0;
+    unsigned int i;
+
+    pthread_mutex_lock(&xTickMutex);
+    *pxStats = xTickStats;
+
+    if (0 != xTickStats.ullTicks) {
+        pxStats->ullAvgLateness = ullTickLatenessTotal / xTickStats.ullTicks;
+
+        /* Upper edge of the bucket holding the 99th percentile. */
+        ullRank = (xTickStats.ullTicks * 99 + 99) / 100;
+        for (i = 0; i < portTICK_HISTOGRAM_BUCKETS; i++) {
+            ullSeen += ulTickHistogram[i];
+            if (ullSeen >= ullRank) {
+                break;
+            }
+        }
+        pxStats->ullP99Lateness = (i + 1) * portTICK_HISTOGRAM_WIDTH;
+        if (pxStats->ullP99Lateness > xTickStats.ullMaxLateness) {
+            pxStats->ullP99Lateness = xTickStats.ullMaxLateness;
+        }
+    }
+    pthread_mutex_unlock(&xTickMutex);
+
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortResetTickStats(void)
+{
+    pthread_mutex_lock(&xTickMutex);
+    memset(&xTickStats, 0, sizeof(xTickStats));
+    memset(ulTickHistogram, 0, sizeof(ulTickHistogram));
+    ullTickLatenessTotal = 0;
+    pthread_mutex_unlock(&xTickMutex);
+}
+
+#endif /* configPOSIX_TICK_SOURCE */
+/*-----------------------------------------------------------*/
+
+#if ( configPOSIX_SWITCH_BACKEND == portSWITCH_SIGNAL )
+
+void vPortSystemTickHandler(int sig, siginfo_t *pxInfo, void *pvContext)
+{
+    xThreadState *pxThreadToSuspend;
+
+    prvCountTimerTick(pxInfo);
+
+    if ((pdTRUE == xInterruptsEnabled) && (pdTRUE != xServicingTick)) {
+        if (0 == pthread_mutex_trylock(&xSingleThreadMutex)) {
+            xServicingTick = pdTRUE;
+
+            pxThreadToSuspend =
+                prvGetThreadState(xTaskGetCurrentTaskHandle());
+            /* Tick Increment, nothing to do if an earlier signal took it. */
+            if (0 == prvTakeTicks()) {
+                (void)pthread_mutex_unlock(&xSingleThreadMutex);
+                xServicingTick = pdFALSE;
+                return;
+            }
+
+            /* Select Next Task. */
+#if (configUSE_PREEMPTION == 1)
+            vTaskSwitchContext();
+#endif
+            prvSwitchInHandler(pxThreadToSuspend);
+            xServicingTick = pdFALSE;
+        }
+        else {
+            /* A task is half way through switching, the tick is replayed
+            once it enables interrupts again. */
+            prvPendInterrupt(portPENDING_TICK);
+        }
+    }
+    else {
+        prvPendInterrupt(portPENDING_TICK);
+    }
+}
+
+/*
+ * Called from a handler with xSingleThreadMutex held and the next task selected.
+ * The only thread that can switch away is the running thread.
+ */
+void prvSwitchInHandler(xThreadState *pxThreadToSuspend)
+{
+    xThreadState *pxThreadToResume = prvGetThreadState(xTaskGetCurrentTaskHandle());
+
+    if (pxThreadToSuspend != pxThreadToResume) {
+        /* Remember and switch the critical nesting. */
+        pxThreadToSuspend->uxCriticalNesting = uxCriticalNesting;
+        uxCriticalNesting = pxThreadToResume->uxCriticalNesting;
+        /* Resume next task. */
+        prvResumeThread(pxThreadToResume);
+        /* Suspend the current task. */
+        prvSuspendThread(pxThreadToSuspend);
+        prvRestoreTaskInterrupts();
+    }
+    else {
+        /* Release the lock as we are Resuming. */
+        (void)pthread_mutex_unlock(&xSingleThreadMutex);
+    }
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Performs a yield an ISR asked for, the same way a tick would. Unlike the tick
+ * this waits for the mutex, which the thread that switched to this one may not
+ * have let go of yet. This thread never holds it with SIG_IRQ unblocked.
+ */
+void prvYieldFromHandler(void)
+{
+    xThreadState *pxThreadToSuspend;
+
+    if ((pdTRUE == xServicingTick) ||
+        (0 != pthread_mutex_lock(&xSingleThreadMutex))) {
+        return;
+    }
+
+    xServicingTick = pdTRUE;
+    (void)atomic_fetch_and(&uxPendingInterrupts, ~portPENDING_YIELD);
+    pxThreadToSuspend = prvGetThreadState(xTaskGetCurrentTaskHandle());
+    vTaskSwitchContext();
+    prvSwitchInHandler(pxThreadToSuspend);
+    xServicingTick = pdFALSE;
+}
+
+#elif ( configNUMBER_OF_CORES > 1 )
+
+void vPortSystemTickHandler(int sig, siginfo_t *pxInfo, void *pvContext)
+{
+    pthread_t hThread;
+
+    prvCountTimerTick(pxInfo);
+
+    /* Core 0 takes the tick, it gets passed on by any other thread. Every
+    signal is blocked in the handler so this cannot recurse. */
+    if ((NULL == pxOwnThread) || (0 != pxOwnThread->xCoreID)) {
+        hThread = hRunningThreads[0];
+        if ((pthread_t)NULL != hThread) {
+            (void)pthread_kill(hThread, SIG_TICK);
+        }
+        return;
+    }
+
+    if (pdTRUE == xInterruptsEnabled) {
+        vPortDisableInterrupts();
+        prvLockKernel();
+        /* Tick Increment, which also has the other cores take turns. Nothing
+        to do if an earlier signal or switch of core 0 took the tick. */
+        if (0 != prvTakeTicks()) {
+            /* Select Next Task. */
+#if (configUSE_PREEMPTION == 1)
+            prvSwitchCore();
+#endif
+        }
+        prvUnlockKernel();
+        vPortEnableInterrupts();
+    }
+    else {
+        /* Also taken on the next switch of core 0. */
+        prvPendInterrupt(portPENDING_TICK);
+    }
+}
+
+#else
+
+void vPortSystemTickHandler(int sig, siginfo_t *pxInfo, void *pvContext)
+{
+    xThreadState *pxThreadToSuspend;
+    xThreadState *pxThreadToResume;
+    xThreadEvent *pxEventToPark;
+
+    prvCountTimerTick(pxInfo);
+
+    /* The tick is a process wide signal, so threads that were not created by
+    the scheduler (SDL, AsyncIO) can take it. Pass it on to the running task,
+    every signal is blocked in the handler so this cannot recurse. */
+    if (pthread_self() != hRunningThreads[0]) {
+        if ((pthread_t)NULL != hRunningThreads[0]) {
+            (void)pthread_kill(hRunningThreads[0], SIG_TICK);
+        }
+        return;
+    }
+
+    if (pdTRUE == xInterruptsEnabled) {
+        pxThreadToSuspend = prvGetThreadState(xTaskGetCurrentTaskHandle());
+        /* Tick Increment, nothing to do if an earlier signal took it. */
+        if (0 == prvTakeTicks()) {
+            return;
+        }
+
+        /* Select Next Task. */
+#if (configUSE_PREEMPTION == 1)
+        vTaskSwitchContext();
+#endif
+        pxThreadToResume = prvGetThreadState(xTaskGetCurrentTaskHandle());
+
+        /* The only thread that can process this tick is the running thread. */
+        if (pxThreadToSuspend != pxThreadToResume) {
+            /* Remember and switch the critical nesting. */
+            pxThreadToSuspend->uxCriticalNesting = uxCriticalNesting;
+            uxCriticalNesting = pxThreadToResume->uxCriticalNesting;
+            /* Resume next task. */
+            pxEventToPark = pxThreadToSuspend->pxEvent;
+            prvResumeThread(pxThreadToResume);
+            /* Park inside the handler, the signal mask is restored once this
+            task is resumed and the handler returns. */
+            prvParkThread(pxEventToPark);
+            prvRestoreTaskInterrupts();
+        }
+    }
+    else {
+        prvPendInterrupt(portPENDING_TICK);
+    }
+}
+
+#endif /* configPOSIX_SWITCH_BACKEND */
+/*-----------------------------------------------------------*/
+
+/*
+ * Called through portCLEAN_UP_TCB() right before the kernel frees the task's
+ * TCB and stack. A task deleting itself has already switched away and is parked
+ * by now, so the thread is never the calling one.
+ */
+void vPortForciblyEndThread(void *pxTaskToDelete)
+{
+    xThreadState *pxThreadToDelete = prvGetThreadState(pxTaskToDelete);
+#if ( configPOSIX_TICK_SOURCE == portTICK_SOURCE_VIRTUAL )
+    portBASE_TYPE xAwaitedCleanUp = pxThreadToDelete->xAwaitingCleanUp;
+
+    if (pdTRUE == xAwaitedCleanUp) {
+        uxThreadsAwaitingCleanUp--;
+    }
+#endif
+
+    prvExitThread(pxThreadToDelete);
+
+#if ( configPOSIX_TICK_SOURCE == portTICK_SOURCE_VIRTUAL )
+    /* The idle task is done cleaning up, let time move on again. */
+    if ((pdTRUE == xAwaitedCleanUp) && (0 == uxThreadsAwaitingCleanUp)) {
+        vPortYield();
+    }
+#endif
+}
+/*-----------------------------------------------------------*/
+
+#if ( configPOSIX_TICK_SOURCE == portTICK_SOURCE_VIRTUAL )
+
+/*
+ * Called through portPRE_TASK_DELETE_HOOK() when a task deletes itself. Its
+ * TCB stays around until the idle task frees it, and until then the kernel
+ * cannot tell that every remaining task may be blocked for good.
+ */
+void vPortPreDeleteThread(void *pxTaskToDelete)
+{
+    prvGetThreadState(pxTaskToDelete)->xAwaitingCleanUp = pdTRUE;
+    uxThreadsAwaitingCleanUp++;
+}
+
+#endif /* configPOSIX_TICK_SOURCE */
+/*-----------------------------------------------------------*/
+
+/*
+ * See the layout above prvStackThreadState(). The task's stack starts out
+ * filled by the kernel, the rest of the mapping is left untouched until a
+ * thread gets to use it.
+ */
+void *pvPortMallocStack(size_t xSize)
+{
+    xThreadState *pxThread;
+    size_t xMappingSize;
+#if ( portUSE_THREAD_POOL == 1 )
+    xThreadEvent **ppxEvent;
+#endif
+
+    (void)pthread_once(&hSigSetupThread, prvSetupSignalsAndSchedulerPolicy);
+
+    xMappingSize = prvStackMappingSize(xSize);
+
+#if ( portUSE_THREAD_POOL == 1 )
+    vPortEnterCritical();
+    for (ppxEvent = &pxPooledThreads; NULL != *ppxEvent;
+         ppxEvent = &(*ppxEvent)->pxNextPooled) {
+        pxThread = (*ppxEvent)->pxThread;
+        if (pxThread->xMappingSize == xMappingSize) {
+            *ppxEvent = (*ppxEvent)->pxNextPooled;
+            uxPooledThreads--;
+            vPortExitCritical();
+            return (char *)pxThread + xSignalStackSize + xPageSize;
+        }
+    }
+    vPortExitCritical();
+#endif
+
+    pxThread = prvMapStack(xMappingSize);
+    if (NULL == pxThread) {
+        return NULL;
+    }
+
+    return (char *)pxThread + xSignalStackSize + xPageSize;
+}
+/*-----------------------------------------------------------*/
+
+size_t prvStackMappingSize(size_t xSize)
+{
+    return xSignalStackSize + xPageSize + prvRoundUpToPage(xSize) +
+           xThreadReserveSize;
+}
+/*-----------------------------------------------------------*/
+
+xThreadState *prvMapStack(size_t xMappingSize)
+{
+    xThreadState *pxThread;
+    char *pcMapping;
+
+    pcMapping = mmap(NULL, xMappingSize, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+    if (MAP_FAILED == pcMapping) {
+        return NULL;
+    }
+    if (0 != mprotect(pcMapping + xSignalStackSize, xPageSize, PROT_NONE)) {
+        (void)munmap(pcMapping, xMappingSize);
+        return NULL;
+    }
+
+    pxThread = (xThreadState *)pcMapping;
+    pxThread->xMappingSize = xMappingSize;
+
+    return pxThread;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFreeStack(void *pv)
+{
+    xThreadState *pxThread;
+
+    if (NULL == pv) {
+        return;
+    }
+
+    pxThread = prvStackThreadState(pv);
+
+#if ( portUSE_THREAD_POOL == 1 )
+    /* Still has a thread parked on its reserve, prvExitThread() already
+    counted it into the pool. */
+    if (NULL != pxThread->pxEvent) {
+        vPortEnterCritical();
+        pxThread->pxEvent->pxNextPooled = pxPooledThreads;
+        pxPooledThreads = pxThread->pxEvent;
+        vPortExitCritical();
+        return;
+    }
+#endif
+
+    (void)munmap(pxThread, pxThread->xMappingSize);
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Starts the thread for the stack on its reserve, where it stays until it runs
+ * a task.
+ */
+int prvStartThread(xThreadState *pxThread, pthread_t *phThread,
+                   void *pvParams)
+{
+    pthread_attr_t xAttributes;
+    int iResult;
+
+    pthread_attr_init(&xAttributes);
+    pthread_attr_setstack(&xAttributes, (char *)pxThread +
+                          pxThread->xMappingSize - xThreadReserveSize,
+                          xThreadReserveSize);
+    prvSetHostScheduling(&xAttributes, pdFALSE);
+    iResult = pthread_create(phThread, &xAttributes, prvWaitForStart,
+                             pvParams);
+    pthread_attr_destroy(&xAttributes);
+
+    return iResult;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * The signal stack sits right above the thread state, which is how handlers
+ * find the state of the thread they interrupted.
+ */
+void prvSetSignalStack(xThreadState *pxThread)
+{
+    stack_t xSignalStack;
+
+    xSignalStack.ss_sp = pxThread + 1;
+    xSignalStack.ss_size = xSignalStackSize - sizeof(xThreadState);
+    xSignalStack.ss_flags = 0;
+    (void)sigaltstack(&xSignalStack, NULL);
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Switches from the reserve to the task's own stack. Should the task function
+ * return, the thread continues on the reserve and ends.
+ */
+void prvRunTask(xThreadState *pxThread)
+{
+    ucontext_t xThreadContext;
+    ucontext_t xTaskContext;
+
+    (void)getcontext(&xTaskContext);
+    xTaskContext.uc_stack.ss_sp = pxThread->pxStack;
+    xTaskContext.uc_stack.ss_size = pxThread->xStackSize;
+    xTaskContext.uc_link = &xThreadContext;
+    makecontext(&xTaskContext, prvTaskEntry, 0);
+
+    (void)swapcontext(&xThreadContext, &xTaskContext);
+}
+/*-----------------------------------------------------------*/
+
+void prvTaskEntry(void)
+{
+    /* Only the running task gets to leave its reserve. */
+    TaskHandle_t hTask = xTaskGetCurrentTaskHandle();
+    xThreadState *pxThread = prvGetThreadState(hTask);
+
+    pxThread->hTask = hTask;
+    pxThread->pxCode(pxThread->pvParams);
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * The state of the calling task thread, found through its signal stack. NULL on
+ * threads that do not run tasks.
+ */
+xThreadState *prvGetOwnThreadState(void)
+{
+    stack_t xSignalStack;
+
+    if ((0 != sigaltstack(NULL, &xSignalStack)) ||
+        (xSignalStack.ss_flags & SS_DISABLE)) {
+        return NULL;
+    }
+
+    return (xThreadState *)xSignalStack.ss_sp - 1;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * A fault on the guard page below the stack of the faulting thread's task is an
+ * overflow, anything else is left to the default action once this handler
+ * returns. The faulting thread may no longer be the running task while it parks.
+ */
+void prvStackOverflowHandler(int sig, siginfo_t *pxInfo, void *pvContext)
+{
+    xThreadState *pxThread = prvGetOwnThreadState();
+    char *pcGuard;
+
+    (void)pvContext;
+
+    if (NULL != pxThread) {
+        pcGuard = (char *)pxThread->pxStack - xPageSize;
+
+        if (((char *)pxInfo->si_addr >= pcGuard) &&
+            ((char *)pxInfo->si_addr < (char *)pxThread->pxStack)) {
+#if ( configCHECK_FOR_STACK_OVERFLOW > 0 )
+            vApplicationStackOverflowHook(pxThread->hTask,
+                                          pcTaskGetName(pxThread->hTask));
+#else
+            printf("Task %s overflowed its stack\n",
+                   pcTaskGetName(pxThread->hTask));
+#endif
+            /* Returning would only fault again. */
+            abort();
+        }
+    }
+
+    signal(sig, SIG_DFL);
+}
+/*-----------------------------------------------------------*/
+
+#if ( configPOSIX_SWITCH_BACKEND == portSWITCH_SIGNAL )
+
+void prvExitThread(xThreadState *pxThread)
+{
+    /** portBASE_TYPE xResult; */
+    sigset_t xSavedSignals;
+
+    /* Kept from an ISR that would wait for the mutex, see prvYieldFromHandler(). */
+    (void)pthread_sigmask(SIG_BLOCK, &xIrqSignal, &xSavedSignals);
+    if (0 == pthread_mutex_lock(&xSingleThreadMutex)) {
+        (void)uxListRemove(&pxThread->xThreadListItem);
+        /* Cancelling would unwind on the task's stack, which may be too small
+        for it. The thread leaves through its reserve once woken instead. */
+        pxThread->xExit = pdTRUE;
+        (void)pthread_kill(pxThread->hThread, SIG_RESUME);
+        (void)pthread_mutex_unlock(&xSingleThreadMutex);
+        (void)pthread_sigmask(SIG_SETMASK, &xSavedSignals, NULL);
+
+        /* The stack is unmapped next, the thread must be gone by then. */
+        (void)pthread_join(pxThread->hThread, NULL);
+    }
+}
+/*-----------------------------------------------------------*/
+
+void *prvWaitForStart(void *pvParams)
+{
+    xThreadState *pxThread = (xThreadState *)pvParams;
+
+    /* pthread_create() may not have stored the handle yet. */
+    pxThread->hThread = pthread_self();
+
+    prvSetSignalStack(pxThread);
+
+    /* The suspend handler comes back here once the task was deleted, with
+    every signal still blocked. */
+    if (0 != sigsetjmp(pxThread->xReserveJump, 0)) {
+        return (void *)NULL;
+    }
+
+    if (0 == pthread_mutex_lock(&xSingleThreadMutex)) {
+        prvSuspendThread(pxThread);
+    }
+
+    prvRunTask(pxThread);
+
+    return (void *)NULL;
+}
+/*-----------------------------------------------------------*/
+
+void prvSuspendSignalHandler(int sig)
+{
+    xThreadState *pxThread;
+    sigset_t xSignals;
+
+    /* Only interested in the resume signal. */
+    sigemptyset(&xSignals);
+    sigaddset(&xSignals, SIG_RESUME);
+    xSentinel = 1;
+
+    /* A new thread parking for the first time lets its creator go on. This
+    has to happen while the mutex is held, a thread that was switched out can
+    get here late, after the mutex was taken again to create the next task. */
+    if (pdTRUE == xThreadStarting) {
+        xThreadStarting = pdFALSE;
+        (void)sem_post(&xThreadParked);
+    }
 
     /* Unlock the Single thread mutex to allow the resumed task to continue. */
     if (0 != pthread_mutex_unlock(&xSingleThreadMutex)) {
@@ -524,6 +2309,12 @@ void prvSuspendSignalHandler(int sig)
     if (0 != sigwait(&xSignals, &sig)) {
         printf("SSH: Sw %d\n", sig);
     }
+    prvCheckIrqs();
+
+    pxThread = prvGetOwnThreadState();
+    if ((NULL != pxThread) && (pdTRUE == pxThread->xExit)) {
+        siglongjmp(pxThread->xReserveJump, 1);
+    }
 
     /* Will resume here when the SIG_RESUME signal is received. */
     /* Need to set the interrupts based on the task's critical nesting. */
@@ -536,14 +2327,14 @@ void prvSuspendSignalHandler(int sig)
 }
 /*-----------------------------------------------------------*/
 
-void prvSuspendThread(pthread_t xThreadId)
+void prvSuspendThread(xThreadState *pxThread)
 {
     portBASE_TYPE xResult = pthread_mutex_lock(&xSuspendResumeThreadMutex);
     if (0 == xResult) {
         /* Set-up for the Suspend Signal handler? */
         xSentinel = 0;
         xResult = pthread_mutex_unlock(&xSuspendResumeThreadMutex);
-        xResult = pthread_kill(xThreadId, SIG_SUSPEND);
+        xResult = pthread_kill(pxThread->hThread, SIG_SUSPEND);
         while ((xSentinel == 0) && (pdTRUE != xServicingTick)) {
             sched_yield();
         }
@@ -560,185 +2351,618 @@ void prvResumeSignalHandler(int sig)
 }
 /*-----------------------------------------------------------*/
 
-void prvResumeThread(pthread_t xThreadId)
+void prvResumeThread(xThreadState *pxThread)
 {
     /** portBASE_TYPE xResult; */
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+    prvSwitchRunTime(pxThread);
+#endif
     if (0 == pthread_mutex_lock(&xSuspendResumeThreadMutex)) {
-        if (pthread_self() != xThreadId) {
-            pthread_kill(xThreadId, SIG_RESUME);
-            /** xResult = pthread_kill( xThreadId, SIG_RESUME ); */
+        if (pthread_self() != pxThread->hThread) {
+            pthread_kill(pxThread->hThread, SIG_RESUME);
+            /** xResult = pthread_kill( pxThread->hThread, SIG_RESUME ); */
         }
         pthread_mutex_unlock(&xSuspendResumeThreadMutex);
         /** xResult = pthread_mutex_unlock( &xSuspendResumeThreadMutex ); */
     }
 }
-/*-----------------------------------------------------------*/
 
-void prvSetupSignalsAndSchedulerPolicy(void)
+#else
+
+void *prvWaitForStart(void *pvParams)
 {
-    /* The following code would allow for configuring the scheduling of this task as a Real-time task.
-    * The process would then need to be run with higher privileges for it to take affect.
-    int iPolicy;
-    int iResult;
-    int iSchedulerPriority;
-    iResult = pthread_getschedparam( pthread_self(), &iPolicy, &iSchedulerPriority );
-    iResult = pthread_attr_setschedpolicy( &xThreadAttributes, SCHED_FIFO );
-    iPolicy = SCHED_FIFO;
-    iResult = pthread_setschedparam( pthread_self(), iPolicy, &iSchedulerPriority );        */
+    xThreadEvent *pxEvent = (xThreadEvent *)pvParams;
+    xThreadState *pxThread = pxEvent->pxThread;
+    sigset_t xSignals;
 
-    struct sigaction sigsuspendself, sigresume, sigtick;
-    portLONG lIndex;
+    prvSetSignalStack(pxThread);
+#if ( configNUMBER_OF_CORES > 1 )
+    pxOwnThread = pxThread;
+#endif
 
-    pxThreads = (xThreadState *)pvPortMalloc(sizeof(xThreadState) *
-                MAX_NUMBER_OF_TASKS);
-    for (lIndex = 0; lIndex < MAX_NUMBER_OF_TASKS; lIndex++) {
-        pxThreads[lIndex].hThread = (pthread_t)NULL;
-        pxThreads[lIndex].hTask = (xTaskHandle)NULL;
-        pxThreads[lIndex].uxCriticalNesting = 0;
+    /* Threads whose task was deleted come back here with every signal blocked,
+    unwinding on the task's stack could overrun it. They either end, or wait to
+    be resumed for the next task bound to their stack. Until they are back the
+    stack cannot be handed out again, the next task refills it. */
+    switch (sigsetjmp(pxEvent->xReserveJump, 1)) {
+#if ( portUSE_THREAD_POOL == 1 )
+        case portWAKE_RECYCLE:
+            pthread_mutex_lock(&pxEvent->xMutex);
+            pxEvent->xStarted = pdFALSE;
+            pxEvent->xRecycle = pdFALSE;
+            pthread_cond_broadcast(&pxEvent->xCond);
+            pthread_mutex_unlock(&pxEvent->xMutex);
+            break;
+#endif
+        case portWAKE_EXIT:
+            prvDestroyEvent(pxEvent);
+            return (void *)NULL;
+        default:
+            break;
     }
 
-    sigsuspendself.sa_flags = 0;
-    sigsuspendself.sa_handler = prvSuspendSignalHandler;
-    sigfillset(&sigsuspendself.sa_mask);
-
-    sigresume.sa_flags = 0;
-    sigresume.sa_handler = prvResumeSignalHandler;
-    sigfillset(&sigresume.sa_mask);
+#if ( configNUMBER_OF_CORES > 1 )
+    /* The deleted task may have been parked within a critical section, the
+    kernel lock itself was given up when it parked. Its pending interrupts are
+    for a core that has long moved on. */
+    uxCriticalNesting = 0;
+    uxKernelLockDepth = 0;
+    atomic_store(&uxPendingInterrupts, 0);
+#endif
 
-    sigtick.sa_flags = 0;
-    sigtick.sa_handler = vPortSystemTickHandler;
-    sigfillset(&sigtick.sa_mask);
+    /* Nothing may be touched before this thread is resumed for the first time
+    as it is not the running task yet. */
+    prvParkThread(pxEvent);
 
-    if (0 != sigaction(SIG_SUSPEND, &sigsuspendself, NULL)) {
-        printf("Problem installing SIG_SUSPEND_SELF\n");
-    }
-    if (0 != sigaction(SIG_RESUME, &sigresume, NULL)) {
-        printf("Problem installing SIG_RESUME\n");
+    /* Need to set the interrupts based on the task's critical nesting. */
+    if (uxCriticalNesting == 0) {
+        vPortEnableInterrupts();
     }
-    if (0 != sigaction(SIG_TICK, &sigtick, NULL)) {
-        printf("Problem installing SIG_TICK\n");
+    else {
+        vPortDisableInterrupts();
     }
-    printf("Running as PID: %d\n", getpid());
+
+    sigemptyset(&xSignals);
+    (void)pthread_sigmask(SIG_SETMASK, &xSignals, NULL);
+
+#if ( portUSE_THREAD_POOL == 1 )
+    pxEvent->xStarted = pdTRUE;
+#endif
+    prvRunTask(pxThread);
+
+    return (void *)NULL;
 }
 /*-----------------------------------------------------------*/
 
-pthread_t prvGetThreadHandle(xTaskHandle hTask)
+/*
+ * Only the calling thread can be parked. It returns once resumed, or leaves the
+ * task's code behind for good if the task was deleted in the meantime.
+ */
+void prvParkThread(xThreadEvent *pxEvent)
 {
-    pthread_t hThread = (pthread_t)NULL;
-    portLONG lIndex;
-    for (lIndex = 0; lIndex < MAX_NUMBER_OF_TASKS; lIndex++) {
-        if (pxThreads[lIndex].hTask == hTask) {
-            hThread = pxThreads[lIndex].hThread;
+    portBASE_TYPE xWake = prvWaitEvent(pxEvent);
+
+    switch (xWake) {
+#if ( portUSE_THREAD_POOL == 1 )
+        case portWAKE_RECYCLE:
+#endif
+        case portWAKE_EXIT:
+            /* Drops the deleted task's frames, including signal handlers. */
+            siglongjmp(pxEvent->xReserveJump, (int)xWake);
+            break;
+        default:
+            prvCheckIrqs();
             break;
-        }
     }
-    return hThread;
 }
 /*-----------------------------------------------------------*/
 
-portLONG prvGetFreeThreadState(void)
+/*
+ * Creates a thread parked on the reserve of the given stack, along with its
+ * event. The thread starts with every signal blocked, so it cannot take a tick
+ * before it runs a task.
+ */
+xThreadEvent *prvCreateThread(xThreadState *pxThread)
 {
-    portLONG lIndex;
-    for (lIndex = 0; lIndex < MAX_NUMBER_OF_TASKS; lIndex++) {
-        if (pxThreads[lIndex].hThread == (pthread_t)NULL) {
-            break;
-        }
+    xThreadEvent *pxEvent = prvCreateEvent();
+    sigset_t xSavedSignals;
+
+    if (NULL == pxEvent) {
+        return NULL;
     }
 
-    if (MAX_NUMBER_OF_TASKS == lIndex) {
-        printf("No more free threads, please increase the maximum.\n");
-        lIndex = 0;
-        vPortEndScheduler();
+    pxEvent->pxThread = pxThread;
+
+    (void)pthread_sigmask(SIG_SETMASK, &xAllSignals, &xSavedSignals);
+    if (0 != prvStartThread(pxThread, &pxEvent->hThread, (void *)pxEvent)) {
+        prvDestroyEvent(pxEvent);
+        pxEvent = NULL;
+    }
+    (void)pthread_sigmask(SIG_SETMASK, &xSavedSignals, NULL);
+
+    return pxEvent;
+}
+/*-----------------------------------------------------------*/
+
+void prvResumeThread(xThreadState *pxThread)
+{
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+    prvSwitchRunTime(pxThread);
+#endif
+    hRunningThreads[pxThread->xCoreID] = pxThread->hThread;
+    prvSignalEvent(pxThread->pxEvent, portWAKE_RESUME);
+}
+/*-----------------------------------------------------------*/
+
+xThreadEvent *prvCreateEvent(void)
+{
+    xThreadEvent *pxEvent = malloc(sizeof(xThreadEvent));
+
+    if (NULL != pxEvent) {
+        pthread_mutex_init(&pxEvent->xMutex, NULL);
+        pthread_cond_init(&pxEvent->xCond, NULL);
+        pxEvent->xResume = pdFALSE;
+        pxEvent->xExit = pdFALSE;
+        pxEvent->pxThread = NULL;
+#if ( portUSE_THREAD_POOL == 1 )
+        pxEvent->xRecycle = pdFALSE;
+        pxEvent->xStarted = pdFALSE;
+        pxEvent->pxNextPooled = NULL;
+#endif
     }
 
-    return lIndex;
+    return pxEvent;
+}
+/*-----------------------------------------------------------*/
+
+void prvDestroyEvent(xThreadEvent *pxEvent)
+{
+    pthread_cond_destroy(&pxEvent->xCond);
+    pthread_mutex_destroy(&pxEvent->xMutex);
+    free(pxEvent);
 }
 /*-----------------------------------------------------------*/
 
-void prvSetTaskCriticalNesting(pthread_t xThreadId,
-                               unsigned portBASE_TYPE uxNesting)
+void prvSignalEvent(xThreadEvent *pxEvent, portBASE_TYPE xWake)
 {
-    portLONG lIndex;
-    for (lIndex = 0; lIndex < MAX_NUMBER_OF_TASKS; lIndex++) {
-        if (pxThreads[lIndex].hThread == xThreadId) {
-            pxThreads[lIndex].uxCriticalNesting = uxNesting;
+    pthread_mutex_lock(&pxEvent->xMutex);
+    switch (xWake) {
+        case portWAKE_EXIT:
+            pxEvent->xExit = pdTRUE;
+            break;
+#if ( portUSE_THREAD_POOL == 1 )
+        case portWAKE_RECYCLE:
+            pxEvent->xRecycle = pdTRUE;
+            break;
+#endif
+        default:
+            pxEvent->xResume = pdTRUE;
             break;
-        }
     }
+    pthread_cond_signal(&pxEvent->xCond);
+    pthread_mutex_unlock(&pxEvent->xMutex);
 }
 /*-----------------------------------------------------------*/
 
-unsigned portBASE_TYPE prvGetTaskCriticalNesting(pthread_t xThreadId)
+/*
+ * Exiting takes precedence over recycling, which takes precedence over
+ * resuming.
+ */
+portBASE_TYPE prvWaitEvent(xThreadEvent *pxEvent)
 {
-    unsigned portBASE_TYPE uxNesting = 0;
-    portLONG lIndex;
-    for (lIndex = 0; lIndex < MAX_NUMBER_OF_TASKS; lIndex++) {
-        if (pxThreads[lIndex].hThread == xThreadId) {
-            uxNesting = pxThreads[lIndex].uxCriticalNesting;
+    portBASE_TYPE xWake = portWAKE_RESUME;
+
+    pthread_mutex_lock(&pxEvent->xMutex);
+    for (;;) {
+        if (pdTRUE == pxEvent->xExit) {
+            xWake = portWAKE_EXIT;
+            break;
+        }
+#if ( portUSE_THREAD_POOL == 1 )
+        /* Cleared by the thread once it is back in prvWaitForStart(). */
+        if (pdTRUE == pxEvent->xRecycle) {
+            xWake = portWAKE_RECYCLE;
+            break;
+        }
+#endif
+        if (pdTRUE == pxEvent->xResume) {
+            pxEvent->xResume = pdFALSE;
             break;
         }
+        pthread_cond_wait(&pxEvent->xCond, &pxEvent->xMutex);
     }
-    return uxNesting;
+    pthread_mutex_unlock(&pxEvent->xMutex);
+
+    return xWake;
 }
 /*-----------------------------------------------------------*/
 
-void prvDeleteThread(void *xThreadId)
+/*
+ * Ends the thread of a deleted task, or sends it back to its reserve while the
+ * pool has room, in which case vPortFreeStack() keeps the stack around for the
+ * next task. Either way the thread is off the task's stack when this returns.
+ */
+void prvExitThread(xThreadState *pxThread)
 {
-    portLONG lIndex;
-    for (lIndex = 0; lIndex < MAX_NUMBER_OF_TASKS; lIndex++) {
-        if (pxThreads[lIndex].hThread == (pthread_t)xThreadId) {
-            pxThreads[lIndex].hThread = (pthread_t)NULL;
-            pxThreads[lIndex].hTask = (xTaskHandle)NULL;
-            if (pxThreads[lIndex].uxCriticalNesting > 0) {
-                uxCriticalNesting = 0;
-                vPortEnableInterrupts();
+    xThreadEvent *pxEvent = pxThread->pxEvent;
+    sigset_t xSavedSignals;
+#if ( portUSE_THREAD_POOL == 1 )
+    portBASE_TYPE xRecycle;
+#endif
+
+    /* Shared with pxPortInitialiseStack(), which may run on another core. */
+    vPortEnterCritical();
+    (void)uxListRemove(&pxThread->xThreadListItem);
+#if ( portUSE_THREAD_POOL == 1 )
+    /* Takes the place in the pool right away, another task deleted before
+    this stack is freed must not get it as well. */
+    xRecycle = (uxPooledThreads < configPOSIX_THREAD_POOL_SIZE) ? pdTRUE : pdFALSE;
+    if (pdTRUE == xRecycle) {
+        uxPooledThreads++;
+    }
+#endif
+    vPortExitCritical();
+
+    /* Joining frees memory within libc. A tick switching this task away while
+    it holds the allocator's lock would stall the next task to create one. */
+    (void)pthread_sigmask(SIG_SETMASK, &xAllSignals, &xSavedSignals);
+
+#if ( portUSE_THREAD_POOL == 1 )
+
+    if (pdTRUE == xRecycle) {
+        /* A task deleted before it ever ran left its thread parked where
+        the next one wants it. */
+        if (pdTRUE == pxEvent->xStarted) {
+            prvSignalEvent(pxEvent, portWAKE_RECYCLE);
+
+            pthread_mutex_lock(&pxEvent->xMutex);
+            while (pdTRUE == pxEvent->xRecycle) {
+                pthread_cond_wait(&pxEvent->xCond, &pxEvent->xMutex);
             }
-            pxThreads[lIndex].uxCriticalNesting = 0;
+            pthread_mutex_unlock(&pxEvent->xMutex);
+        }
+        (void)pthread_sigmask(SIG_SETMASK, &xSavedSignals, NULL);
+        return;
+    }
+#endif
+
+    prvSignalEvent(pxEvent, portWAKE_EXIT);
+
+    /* The stack is unmapped next, the thread must be gone by then. */
+    (void)pthread_join(pxThread->hThread, NULL);
+    pxThread->pxEvent = NULL;
+    (void)pthread_sigmask(SIG_SETMASK, &xSavedSignals, NULL);
+}
+/*-----------------------------------------------------------*/
+
+#if ( portUSE_THREAD_POOL == 1 )
+
+/*
+ * Parks threads on stacks of configMINIMAL_STACK_SIZE words before the first
+ * task is created, the size the idle and timer tasks and most short lived tasks
+ * ask for. Stacks of other sizes get their thread when their task is created
+ * and join the pool once it is deleted, while there is room.
+ */
+void prvFillThreadPool(void)
+{
+    const size_t xMappingSize =
+        prvStackMappingSize(configMINIMAL_STACK_SIZE * sizeof(StackType_t));
+    xThreadState *pxThread;
+    xThreadEvent *pxEvent;
+
+    while (uxPooledThreads < configPOSIX_THREAD_POOL_SIZE) {
+        pxThread = prvMapStack(xMappingSize);
+        if (NULL == pxThread) {
+            break;
+        }
+        pxEvent = prvCreateThread(pxThread);
+        if (NULL == pxEvent) {
+            (void)munmap(pxThread, xMappingSize);
             break;
         }
+        pxThread->pxEvent = pxEvent;
+        pxEvent->pxNextPooled = pxPooledThreads;
+        pxPooledThreads = pxEvent;
+        uxPooledThreads++;
     }
 }
+
+#endif /* portUSE_THREAD_POOL */
+
+#endif /* configPOSIX_SWITCH_BACKEND */
+/*-----------------------------------------------------------*/
+
+/*
+ * Every signal but SIGSEGV. Masking interrupts must not keep a thread that runs
+ * into its guard page from reporting the overflow.
+ */
+void prvFillSignalSet(sigset_t *pxSignals)
+{
+    sigfillset(pxSignals);
+    sigdelset(pxSignals, SIGSEGV);
+}
 /*-----------------------------------------------------------*/
 
-void vPortAddTaskHandle(void *pxTaskHandle)
+/*
+ * Reads a list of CPUs such as "2" or "0-1,4" from the environment variable of
+ * the given name. CPUs this process may not run on are dropped.
+ */
+portBASE_TYPE prvReadCpuList(const char *pcName, cpu_set_t *pxCpus)
 {
-    portLONG lIndex;
+    const char *pcList = getenv(pcName);
+    cpu_set_t xAllowed;
+    long lFirst, lLast;
+    char *pcEnd;
 
-    pxThreads[lIndexOfLastAddedTask].hTask = (xTaskHandle)pxTaskHandle;
-    for (lIndex = 0; lIndex < MAX_NUMBER_OF_TASKS; lIndex++) {
-        if (pxThreads[lIndex].hThread ==
-            pxThreads[lIndexOfLastAddedTask].hThread) {
-            if (pxThreads[lIndex].hTask !=
-                pxThreads[lIndexOfLastAddedTask].hTask) {
-                pxThreads[lIndex].hThread = (pthread_t)NULL;
-                pxThreads[lIndex].hTask = NULL;
-                pxThreads[lIndex].uxCriticalNesting = 0;
-            }
+    if ((NULL == pcList) || ('\0' == *pcList)) {
+        return pdFALSE;
+    }
+
+    CPU_ZERO(pxCpus);
+    while ('\0' != *pcList) {
+        lFirst = strtol(pcList, &pcEnd, 10);
+        lLast = lFirst;
+        if ('-' == *pcEnd) {
+            lLast = strtol(pcEnd + 1, &pcEnd, 10);
         }
+        if ((pcEnd == pcList) || (lFirst < 0) || (lLast < lFirst) ||
+            (lLast >= CPU_SETSIZE) || ((',' != *pcEnd) && ('\0' != *pcEnd))) {
+            printf("Ignoring %s, \"%s\" is not a list of CPUs\n", pcName,
+                   getenv(pcName));
+            return pdFALSE;
+        }
+        for (; lFirst <= lLast; lFirst++) {
+            CPU_SET(lFirst, pxCpus);
+        }
+        pcList = (',' == *pcEnd) ? pcEnd + 1 : pcEnd;
+    }
+
+    if (0 == sched_getaffinity(0, sizeof(xAllowed), &xAllowed)) {
+        CPU_AND(pxCpus, pxCpus, &xAllowed);
+    }
+    if (0 == CPU_COUNT(pxCpus)) {
+        printf("Ignoring %s, none of its CPUs are available\n", pcName);
+        return pdFALSE;
+    }
+
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * SCHED_FIFO is only used if the calling thread may switch to it, otherwise the
+ * threads stay on the default policy. The tick thread runs one priority above
+ * the task threads so the tick preempts them.
+ */
+void prvReadHostScheduling(void)
+{
+    const char *pcPriority = getenv(portENV_SCHED_FIFO);
+    struct sched_param xSavedParam, xParam;
+    int iSavedPolicy, iMin, iMax;
+
+    xPinTaskThreads = prvReadCpuList(portENV_TASK_CPUS, &xTaskCpus);
+    xPinTickThread = prvReadCpuList(portENV_TICK_CPUS, &xTickCpus);
+
+    if ((NULL == pcPriority) || ('\0' == *pcPriority)) {
+        return;
+    }
+
+    iMin = sched_get_priority_min(SCHED_FIFO);
+    iMax = sched_get_priority_max(SCHED_FIFO) - 1;
+    iTaskFifoPriority = atoi(pcPriority);
+    if (iTaskFifoPriority < iMin) {
+        iTaskFifoPriority = iMin;
+    }
+    if (iTaskFifoPriority > iMax) {
+        iTaskFifoPriority = iMax;
+    }
+
+    (void)pthread_getschedparam(pthread_self(), &iSavedPolicy, &xSavedParam);
+    xParam.sched_priority = iTaskFifoPriority + 1;
+    if (0 != pthread_setschedparam(pthread_self(), SCHED_FIFO, &xParam)) {
+        printf("SCHED_FIFO is not permitted, keeping the default policy\n");
+        iTaskFifoPriority = 0;
+        return;
     }
+    (void)pthread_setschedparam(pthread_self(), iSavedPolicy, &xSavedParam);
 }
 /*-----------------------------------------------------------*/
 
-void vPortFindTicksPerSecond(void)
+void prvSetHostScheduling(pthread_attr_t *pxAttributes,
+                          portBASE_TYPE xTickThread)
 {
-    /* Needs to be reasonably high for accuracy. */
-    unsigned long ulTicksPerSecond = sysconf(_SC_CLK_TCK);
-    printf("Timer Resolution for Run TimeStats is %ld ticks per second.\n",
-           ulTicksPerSecond);
+    struct sched_param xParam;
+
+    if ((pdTRUE == xTickThread) && (pdTRUE == xPinTickThread)) {
+        (void)pthread_attr_setaffinity_np(pxAttributes, sizeof(xTickCpus),
+                                          &xTickCpus);
+    }
+    else if ((pdFALSE == xTickThread) && (pdTRUE == xPinTaskThreads)) {
+        (void)pthread_attr_setaffinity_np(pxAttributes, sizeof(xTaskCpus),
+                                          &xTaskCpus);
+    }
+
+    if (0 != iTaskFifoPriority) {
+        xParam.sched_priority = iTaskFifoPriority + ((pdTRUE == xTickThread) ? 1 : 0);
+        (void)pthread_attr_setinheritsched(pxAttributes, PTHREAD_EXPLICIT_SCHED);
+        (void)pthread_attr_setschedpolicy(pxAttributes, SCHED_FIFO);
+        (void)pthread_attr_setschedparam(pxAttributes, &xParam);
+    }
 }
 /*-----------------------------------------------------------*/
 
-unsigned long ulPortGetTimerValue(void)
+void prvSetupSignalsAndSchedulerPolicy(void)
 {
-    struct tms xTimes;
-    unsigned long ulTotalTime = times(&xTimes);
-    /* Return the application code times.
-     * The timer only increases when the application code is actually running
-     * which means that the total execution times should add up to 100%.
-     */
-    return (unsigned long)xTimes.tms_utime;
+#if ( configPOSIX_SWITCH_BACKEND == portSWITCH_SIGNAL )
+    struct sigaction sigsuspendself, sigresume;
+#endif
+    struct sigaction sigtick;
+#if ( configNUMBER_OF_CORES > 1 )
+    struct sigaction sigyieldcore;
+#endif
+    struct sigaction sigirq;
+
+    struct sigaction sigsegv;
+
+    vListInitialise(&xThreadList);
+
+    prvReadHostScheduling();
+
+    xPageSize = (size_t)sysconf(_SC_PAGESIZE);
+    /* The overflow hook is application code and may well print. */
+    xSignalStackSize = prvRoundUpToPage(sizeof(xThreadState) + SIGSTKSZ +
+                                        PTHREAD_STACK_MIN);
+    xThreadReserveSize = prvRoundUpToPage(PTHREAD_STACK_MIN);
+
+#if ( configPOSIX_SWITCH_BACKEND == portSWITCH_SIGNAL )
+    (void)sem_init(&xThreadParked, 0, 0);
+
+    sigsuspendself.sa_flags = 0;
+    sigsuspendself.sa_handler = prvSuspendSignalHandler;
+    prvFillSignalSet(&sigsuspendself.sa_mask);
+
+    sigresume.sa_flags = 0;
+    sigresume.sa_handler = prvResumeSignalHandler;
+    prvFillSignalSet(&sigresume.sa_mask);
+#else
+    prvFillSignalSet(&xAllSignals);
+#endif
+    sigtick.sa_flags = SA_SIGINFO;
+    sigtick.sa_sigaction = vPortSystemTickHandler;
+    prvFillSignalSet(&sigtick.sa_mask);
+
+#if ( configPOSIX_SWITCH_BACKEND == portSWITCH_SIGNAL )
+    if (0 != sigaction(SIG_SUSPEND, &sigsuspendself, NULL)) {
+        printf("Problem installing SIG_SUSPEND_SELF\n");
+    }
+    if (0 != sigaction(SIG_RESUME, &sigresume, NULL)) {
+        printf("Problem installing SIG_RESUME\n");
+    }
+#endif
+    if (0 != sigaction(SIG_TICK, &sigtick, NULL)) {
+        printf("Problem installing SIG_TICK\n");
+    }
+#if ( configNUMBER_OF_CORES > 1 )
+    sigyieldcore.sa_flags = 0;
+    sigyieldcore.sa_handler = prvYieldCoreSignalHandler;
+    prvFillSignalSet(&sigyieldcore.sa_mask);
+    if (0 != sigaction(SIG_YIELD_CORE, &sigyieldcore, NULL)) {
+        printf("Problem installing SIG_YIELD_CORE\n");
+    }
+#endif
+
+    sigemptyset(&xIrqSignal);
+    sigaddset(&xIrqSignal, SIG_IRQ);
+    sigirq.sa_flags = 0;
+    sigirq.sa_handler = prvIrqSignalHandler;
+    prvFillSignalSet(&sigirq.sa_mask);
+    if (0 != sigaction(SIG_IRQ, &sigirq, NULL)) {
+        printf("Problem installing SIG_IRQ\n");
+    }
+
+    /* Runs on the signal stack, the task's stack is used up by then. */
+    sigsegv.sa_flags = SA_SIGINFO | SA_ONSTACK;
+    sigsegv.sa_sigaction = prvStackOverflowHandler;
+    sigfillset(&sigsegv.sa_mask);
+    if (0 != sigaction(SIGSEGV, &sigsegv, NULL)) {
+        printf("Problem installing SIGSEGV\n");
+    }
+#if ( portUSE_THREAD_POOL == 1 )
+    prvFillThreadPool();
+#endif
+    printf("Running as PID: %d\n", getpid());
+}
+/*-----------------------------------------------------------*/
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+void vPortConfigureRunTimeCounter(void)
+{
+    struct timespec xResolution;
+
+    (void)clock_getres(CLOCK_THREAD_CPUTIME_ID, &xResolution);
+    printf("Timer Resolution for Run TimeStats is %ld ns of task CPU time.\n",
+           (long)(xResolution.tv_sec * portNANOSECONDS_PER_SECOND +
+                  xResolution.tv_nsec));
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * The running thread's CPU clock can be read from any thread, which keeps the
+ * counter right for ticks the signal backend takes on another thread.
+ */
+uint64_t ullPortGetRunTimeCounterValue(void)
+{
+    const BaseType_t xCoreID = portGET_CORE_ID();
+    uint64_t ullNow;
+
+    if (pdTRUE != xRunTimeStarted[xCoreID]) {
+        return 0;
+    }
+
+    ullNow = prvReadCpuClock(xRunningCpuClock[xCoreID]);
+    if (ullNow < ullRunTimeSwitchedIn[xCoreID]) {
+        ullNow = ullRunTimeSwitchedIn[xCoreID];
+    }
+
+    return ullRunTimeSwitchedOut[xCoreID] +
+           (ullNow - ullRunTimeSwitchedIn[xCoreID]);
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Called by whoever resumes the next task, right before it does. Charges the
+ * CPU time of the thread being switched out and starts counting on the one
+ * being switched in, whose clock does not advance while it is parked. Each
+ * core keeps count of its own.
+ */
+void prvSwitchRunTime(xThreadState *pxThreadToResume)
+{
+    const BaseType_t xCoreID = pxThreadToResume->xCoreID;
+    uint64_t ullNow;
+
+    if (pdTRUE == xRunTimeStarted[xCoreID]) {
+        ullNow = prvReadCpuClock(xRunningCpuClock[xCoreID]);
+        if (ullNow > ullRunTimeSwitchedIn[xCoreID]) {
+            ullRunTimeSwitchedOut[xCoreID] += ullNow - ullRunTimeSwitchedIn[xCoreID];
+        }
+    }
+
+    if (0 == pthread_getcpuclockid(pxThreadToResume->hThread,
+                                   &xRunningCpuClock[xCoreID])) {
+        ullRunTimeSwitchedIn[xCoreID] = prvReadCpuClock(xRunningCpuClock[xCoreID]);
+        xRunTimeStarted[xCoreID] = pdTRUE;
+    }
+    else {
+        xRunTimeStarted[xCoreID] = pdFALSE;
+    }
+}
+
+#endif /* configGENERATE_RUN_TIME_STATS */
+/*-----------------------------------------------------------*/
+
+#if ( configGENERATE_RUN_TIME_STATS == 1 ) || ( configUSE_QUEUE_STATS == 1 )
+
+uint64_t prvReadCpuClock(clockid_t xClock)
+{
+    struct timespec xNow;
+
+    if (0 != clock_gettime(xClock, &xNow)) {
+        return 0;
+    }
+
+    return (uint64_t)xNow.tv_sec * portNANOSECONDS_PER_SECOND +
+           (uint64_t)xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
 
-    /* Should check ulTotalTime for being clock_t max minus 1. */
-    (void)ulTotalTime;
+#endif /* configGENERATE_RUN_TIME_STATS || configUSE_QUEUE_STATS */
+
+#if ( configUSE_QUEUE_STATS == 1 )
+
+uint64_t ullPortGetMonotonicTime(void)
+{
+    return prvReadCpuClock(CLOCK_MONOTONIC);
 }
 /*-----------------------------------------------------------*/
+
+#endif /* configUSE_QUEUE_STATS */
@@ -106,9 +106,68 @@ not need to be guarded with a critical section. */
 #define portTICK_PERIOD_MS              ( ( TickType_t ) 1000 / configTICK_RATE_HZ )
 #define portTICK_PERIOD_MICROSECONDS        ( ( TickType_t ) 1000000 / configTICK_RATE_HZ )
 #define portBYTE_ALIGNMENT              4
+#define portPOINTER_SIZE_TYPE           uintptr_t
 #define portREMOVE_STATIC_QUALIFIER
 /*-----------------------------------------------------------*/
 
+/* Architecture specific optimisations. */
+#ifndef configUSE_PORT_OPTIMISED_TASK_SELECTION
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 1
+#endif
+
+#if configUSE_PORT_OPTIMISED_TASK_SELECTION == 1
+
+/* Each priority with ready tasks has its bit set, 32 priorities to a word, and
+ * the highest one is found by counting the leading zeros of the word. With up
+ * to 32 priorities the kernel's uxTopReadyPriority is the bitmap. With more the
+ * bits are kept in ulPortReadyPriorities[] and uxTopReadyPriority has a bit
+ * set for each word that is not 0, so selecting takes two counts whatever
+ * configMAX_PRIORITIES is. */
+#define portREADY_WORD_BITS     32U
+#define portTOP_BIT( ulBits )   ( 31UL - ( UBaseType_t ) __builtin_clz( ( uint32_t ) ( ulBits ) ) )
+
+#if( configMAX_PRIORITIES > ( portREADY_WORD_BITS * portREADY_WORD_BITS ) )
+#error configMAX_PRIORITIES must be at most 1024 when configUSE_PORT_OPTIMISED_TASK_SELECTION is 1
+#endif
+
+#if( configMAX_PRIORITIES <= portREADY_WORD_BITS )
+
+#define portRECORD_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) |= ( 1UL << ( uxPriority ) )
+#define portRESET_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) &= ~( 1UL << ( uxPriority ) )
+#define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities ) uxTopPriority = portTOP_BIT( uxReadyPriorities )
+
+#else
+
+extern volatile uint32_t ulPortReadyPriorities[ ( configMAX_PRIORITIES + portREADY_WORD_BITS - 1 ) / portREADY_WORD_BITS ];
+
+#define portRECORD_READY_PRIORITY( uxPriority, uxReadyWords )                                              \
+    {                                                                                                       \
+        ulPortReadyPriorities[ ( uxPriority ) / portREADY_WORD_BITS ] |= 1U << ( ( uxPriority ) % portREADY_WORD_BITS ); \
+        ( uxReadyWords ) |= 1UL << ( ( uxPriority ) / portREADY_WORD_BITS );                               \
+    }
+#define portRESET_READY_PRIORITY( uxPriority, uxReadyWords )                                               \
+    {                                                                                                       \
+        ulPortReadyPriorities[ ( uxPriority ) / portREADY_WORD_BITS ] &= ~( 1U << ( ( uxPriority ) % portREADY_WORD_BITS ) ); \
+        if( ulPortReadyPriorities[ ( uxPriority ) / portREADY_WORD_BITS ] == 0U )                         \
+        {                                                                                                   \
+            ( uxReadyWords ) &= ~( 1UL << ( ( uxPriority ) / portREADY_WORD_BITS ) );                      \
+        }                                                                                                   \
+    }
+#define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyWords )                                            \
+    {                                                                                                       \
+        UBaseType_t uxTopWord = portTOP_BIT( uxReadyWords );                                                \
+        uxTopPriority = ( uxTopWord * portREADY_WORD_BITS ) + portTOP_BIT( ulPortReadyPriorities[ uxTopWord ] ); \
+    }
+
+#endif /* configMAX_PRIORITIES */
+
+#endif /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
+
+/* The timing wheel of timers.c finds its next slot in use by counting the
+ * trailing zeros of a word that is not 0. */
+#define portLOWEST_BIT( ulBits )    ( ( UBaseType_t ) __builtin_ctz( ( uint32_t ) ( ulBits ) ) )
+/*-----------------------------------------------------------*/
+
 
 
 
@@ -143,6 +202,11 @@ extern void vPortExitCritical(void);
 #define portENABLE_INTERRUPTS()     portCLEAR_INTERRUPT_MASK()
 #define portENTER_CRITICAL()        vPortEnterCritical()
 #define portEXIT_CRITICAL()         vPortExitCritical()
+
+/* Orders the copy into or out of a stream buffer against publishing its new
+ * head or tail, which the other side reads without a critical section, also
+ * with the cores running as host threads on a weakly ordered host. */
+#define portMEMORY_BARRIER()        __atomic_thread_fence( __ATOMIC_ACQ_REL )
 /*-----------------------------------------------------------*/
 
 /* Task function macros as described on the FreeRTOS.org WEB site. */
@@ -153,16 +217,108 @@ extern void vPortExitCritical(void);
 
 #define portOUTPUT_BYTE( a, b )
 
+/* Each task thread runs on a stack of exactly the size the task asked for, with
+ * a guard page below it. The port allocates the stacks itself, which needs
+ * configSTACK_ALLOCATION_FROM_SEPARATE_HEAP set to 1 in FreeRTOSConfig.h, and is
+ * told where they end. */
+#define portHAS_STACK_OVERFLOW_CHECKING         1
+
+/* The thread of a deleted task is ended right before its TCB and stack are freed. */
 extern void vPortForciblyEndThread(void *pxTaskToDelete);
-#define traceTASK_DELETE( pxTaskToDelete )      vPortForciblyEndThread( pxTaskToDelete )
+#define portCLEAN_UP_TCB( pxTCB )               vPortForciblyEndThread( pxTCB )
+
+/* Backends used to hand execution from one task thread to the next.
+ * portSWITCH_SIGNAL suspends and resumes threads by sending them SIG_SUSPEND and
+ * SIG_RESUME, portSWITCH_CONDVAR parks each thread on its own condition variable
+ * and only uses signals for the tick. Define configPOSIX_SWITCH_BACKEND in
+ * FreeRTOSConfig.h or on the command line to select one. */
+#define portSWITCH_SIGNAL           1
+#define portSWITCH_CONDVAR          2
+#ifndef configPOSIX_SWITCH_BACKEND
+#define configPOSIX_SWITCH_BACKEND  portSWITCH_CONDVAR
+#endif
 
-extern void vPortAddTaskHandle(void *pxTaskHandle);
-#define traceTASK_CREATE( pxNewTCB )            vPortAddTaskHandle( pxNewTCB )
+/* Stacks of deleted tasks kept by portSWITCH_CONDVAR with their host thread
+ * still parked on them. A new task asking for a stack of the same size takes
+ * one over, so tasks that come and go do not create and end host threads.
+ * Define as 0 to give every task a thread of its own. */
+#ifndef configPOSIX_THREAD_POOL_SIZE
+#define configPOSIX_THREAD_POOL_SIZE    16
+#endif
+
+/* With 1 heap_4.c and heap_5.c map their configTOTAL_HEAP_SIZE bytes between
+ * two inaccessible pages, so a write past either end of the heap faults right
+ * away instead of corrupting whatever the linker placed next to it. */
+#ifndef configPOSIX_HEAP_GUARD_PAGES
+#define configPOSIX_HEAP_GUARD_PAGES    0
+#endif
 
 /* Posix Signal definitions that can be changed or read as appropriate. */
 #define SIG_SUSPEND                 SIGUSR1
 #define SIG_RESUME                  SIGUSR2
 
+/* With configNUMBER_OF_CORES above 1 that many task threads run at once, each
+ * standing in for a core. They need portSWITCH_CONDVAR. Critical sections and
+ * the suspended scheduler hold one kernel lock shared by all cores, and a core
+ * asks another one to switch tasks with SIG_YIELD_CORE. */
+#if ( configNUMBER_OF_CORES > 1 )
+#define SIG_YIELD_CORE              ( SIGRTMIN + 1 )
+
+extern BaseType_t xPortGetCoreID(void);
+extern void vPortYieldCore(BaseType_t xCoreID);
+extern void vPortTakeKernelLock(void);
+extern void vPortGiveKernelLock(void);
+#define portGET_CORE_ID()           xPortGetCoreID()
+#define portYIELD_CORE( xCoreID )   vPortYieldCore( xCoreID )
+#define portGET_TASK_LOCK()         vPortTakeKernelLock()
+#define portRELEASE_TASK_LOCK()     vPortGiveKernelLock()
+#endif
+
+/* Emulated interrupt controller with configPOSIX_NUM_IRQS lines. Any host
+ * thread may raise a line with xPortRaiseIrq(), which sets the line's pending bit
+ * without taking a lock and sends SIG_IRQ to the running task's thread (core 0's
+ * with more than one core). The handler installed for the line runs there as
+ * an ISR interrupting the task. Priorities count like the NVIC's, 0 is the most
+ * urgent. Lines at configMAX_SYSCALL_INTERRUPT_PRIORITY or less urgent may call
+ * the ...FromISR() API and are held back while interrupts are masked, more
+ * urgent ones are never held back and must not call the kernel. A line more
+ * urgent than the running ISR preempts it, others wait until it returns. */
+#ifndef configPOSIX_NUM_IRQS
+#define configPOSIX_NUM_IRQS        32
+#endif
+#define portLOWEST_IRQ_PRIORITY     15
+#define SIG_IRQ                     ( SIGRTMIN + 2 )
+
+typedef void (*xPortIrqHandler)(void *pvParameter);
+
+extern portBASE_TYPE xPortInstallIrqHandler(unsigned portBASE_TYPE uxIrq,
+        xPortIrqHandler pxHandler, void *pvParameter,
+        unsigned portBASE_TYPE uxPriority);
+extern portBASE_TYPE xPortRaiseIrq(unsigned portBASE_TYPE uxIrq);
+extern BaseType_t xPortIsInsideInterrupt(void);
+extern void vPortValidateInterruptPriority(void);
+#define portASSERT_IF_INTERRUPT_PRIORITY_INVALID()  vPortValidateInterruptPriority()
+
+/* Sources of the tick.
+ * portTICK_SOURCE_ITIMER arms setitimer( TIMER_TYPE ) and takes SIG_TICK from the
+ * kernel. portTICK_SOURCE_THREAD runs a dedicated thread that sleeps until each
+ * tick's absolute deadline on CLOCK_MONOTONIC and raises SIG_TICK itself, which
+ * keeps the tick rate without drift and leaves SIGALRM to the application.
+ * portTICK_SOURCE_VIRTUAL has no timer at all, time stands still while any task
+ * can run and skips ahead to the next unblocking tick once all are blocked.
+ * Define configPOSIX_TICK_SOURCE in FreeRTOSConfig.h or on the command line to
+ * select one. */
+#define portTICK_SOURCE_ITIMER      1
+#define portTICK_SOURCE_THREAD      2
+#define portTICK_SOURCE_VIRTUAL     3
+#ifndef configPOSIX_TICK_SOURCE
+#define configPOSIX_TICK_SOURCE     portTICK_SOURCE_THREAD
+#endif
+
+#if ( configPOSIX_TICK_SOURCE != portTICK_SOURCE_ITIMER )
+/* Real-time signals are queued instead of merged, so a late tick is not lost. */
+#define SIG_TICK                    SIGRTMIN
+#else
 /* Enable the following hash defines to make use of the real-time tick where time progresses at real-time. */
 #define SIG_TICK                    SIGALRM
 #define TIMER_TYPE                  ITIMER_REAL
@@ -172,12 +328,65 @@ extern void vPortAddTaskHandle(void *pxTaskHandle);
 /* Enable the following hash defines to make use of the profile tick where time progresses when the process or system calls are executing.
 #define SIG_TICK                    SIGPROF
 #define TIMER_TYPE                  ITIMER_PROF */
+#endif
+
+/* Lateness of the tick thread against the deadlines of the ticks it raised
+ * since the last vPortResetTickStats(), in nanoseconds. */
+typedef struct PORT_TICK_STATS {
+    uint64_t ullTicks;
+    uint64_t ullMissed;         /* Ticks raised a whole period or more late. */
+    uint64_t ullMinLateness;
+    uint64_t ullMaxLateness;
+    uint64_t ullAvgLateness;
+    uint64_t ullP99Lateness;
+} xPortTickStats;
+
+/* Only portTICK_SOURCE_THREAD keeps statistics, pdFALSE is returned otherwise. */
+extern portBASE_TYPE xPortGetTickStats(xPortTickStats *pxStats);
+extern void vPortResetTickStats(void);
+
+/* Every tick raised since the last vPortResetInterruptStats(). A tick that comes
+ * in while interrupts are masked is deferred and replayed once they are enabled
+ * again, so none is dropped: ullTicksPending are the ticks raised but not taken
+ * by the kernel yet, counted over the whole run. */
+typedef struct PORT_INTERRUPT_STATS {
+    uint64_t ullTicksRaised;
+    uint64_t ullTicksTaken;
+    uint64_t ullTicksPending;
+    uint64_t ullTicksDeferred;  /* Tick signals that found interrupts masked. */
+    uint64_t ullTicksReplayed;  /* Deferred ticks replayed once unmasked. */
+} xPortInterruptStats;
+
+extern void vPortGetInterruptStats(xPortInterruptStats *pxStats);
+extern void vPortResetInterruptStats(void);
+
+/* Tickless idle needs the tick thread or virtual time, with the itimer the idle
+ * task keeps spinning through every tick. */
+#if ( configPOSIX_TICK_SOURCE != portTICK_SOURCE_ITIMER )
+extern void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime);
+#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )   vPortSuppressTicksAndSleep( xExpectedIdleTime )
+#endif
+
+#if ( configPOSIX_TICK_SOURCE == portTICK_SOURCE_VIRTUAL )
+/* Time holds still until the idle task has freed the tasks that deleted themselves. */
+extern void vPortPreDeleteThread(void *pxTaskToDelete);
+#define portPRE_TASK_DELETE_HOOK( pvTaskToDelete, pxYieldPending )  vPortPreDeleteThread( pvTaskToDelete )
+#endif
 
-/* Make use of times(man 2) to gather run-time statistics on the tasks. */
-extern void vPortFindTicksPerSecond(void);
-#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()    vPortFindTicksPerSecond()       /* Nothing to do because the timer is already present. */
-extern unsigned long ulPortGetTimerValue(void);
-#define portGET_RUN_TIME_COUNTER_VALUE()            ulPortGetTimerValue()           /* Query the System time stats for this process. */
+/* Run-time statistics count the nanoseconds of CPU time the task threads spent
+ * running. Each thread's CPU clock is read when it is switched in and out, so
+ * configRUN_TIME_COUNTER_TYPE should be 64 bits wide or it wraps within seconds. */
+extern void vPortConfigureRunTimeCounter(void);
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()    vPortConfigureRunTimeCounter()
+extern uint64_t ullPortGetRunTimeCounterValue(void);
+#define portGET_RUN_TIME_COUNTER_VALUE()            ullPortGetRunTimeCounterValue()
+/* unsigned long is as wide as the counter on 64 bit hosts. */
+#define portLU_PRINTF_SPECIFIER_REQUIRED
+
+/* Queue statistics time how long tasks stay blocked in nanoseconds of
+ * CLOCK_MONOTONIC. */
+extern uint64_t ullPortGetMonotonicTime(void);
+#define portQUEUE_STATS_TIME()                      ullPortGetMonotonicTime()
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,442 @@
+/*
+    This file is part of the FreeRTOS.org distribution.
+
+    FreeRTOS.org is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License (version 2) as published
+    by the Free Software Foundation and modified by the FreeRTOS exception.
+
+    FreeRTOS.org is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+
+    1 tab == 4 spaces!
+*/
+
+
+/*
+ * A first fit allocator that coalesces adjacent free blocks, working on a
+ * single region of configTOTAL_HEAP_SIZE bytes.  Unlike heap_3.c and heap_6.c
+ * it runs out of memory exactly where the target does, which makes it the one
+ * to size configTOTAL_HEAP_SIZE with.
+ *
+ * The region is a static array, or a mapping between two guard pages when
+ * configPOSIX_HEAP_GUARD_PAGES is 1.
+ *
+ * vPortGetHeapStats() walks the free list, its histogram shows how fragmented
+ * the heap is.
+ *
+ * See heap_5.c for a version that spans several regions, heap_6.c for one
+ * that does not suspend the scheduler.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+/* portBYTE_ALIGNMENT is that of the target, code compiled for the host
+expects the alignment malloc() gives. */
+#define heapBYTE_ALIGNMENT          ( ( size_t ) 16 )
+#define heapBYTE_ALIGNMENT_MASK     ( heapBYTE_ALIGNMENT - 1 )
+
+/* Block sizes must not get too small. */
+#define heapMINIMUM_BLOCK_SIZE      ( ( size_t ) ( xHeapStructSize << 1 ) )
+
+/* Assumes 8bit bytes! */
+#define heapBITS_PER_BYTE           ( ( size_t ) 8 )
+
+/* Define the linked list structure.  This is used to link free blocks in order
+of their memory address. */
+typedef struct A_BLOCK_LINK {
+    struct A_BLOCK_LINK *pxNextFreeBlock;   /*<< The next free block in the list. */
+    size_t xBlockSize;                      /*<< The size of the free block. */
+} BlockLink_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Inserts a block of memory that is being freed into the correct position in
+ * the list of free memory blocks.  The block being freed will be merged with
+ * the block in front it and/or the block behind it if the memory blocks are
+ * adjacent to each other.
+ */
+static void prvInsertBlockIntoFreeList(BlockLink_t *pxBlockToInsert);
+
+/*
+ * Called automatically to setup the required heap structures the first time
+ * pvPortMalloc() is called.
+ */
+static void prvHeapInit(void);
+
+/*-----------------------------------------------------------*/
+
+/* The size of the structure placed at the beginning of each allocated memory
+block must by correctly byte aligned. */
+static const size_t xHeapStructSize = (sizeof(BlockLink_t) +
+                                       heapBYTE_ALIGNMENT_MASK) & ~heapBYTE_ALIGNMENT_MASK;
+
+#if( configPOSIX_HEAP_GUARD_PAGES == 0 )
+/* Allocate the memory for the heap. */
+static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ] __attribute__((aligned(16)));
+#endif
+
+/* Create a couple of list links to mark the start and end of the list. */
+static BlockLink_t xStart, *pxEnd = NULL;
+
+/* Keeps track of the number of free bytes remaining, but says nothing about
+fragmentation. */
+static size_t xFreeBytesRemaining = 0U;
+static size_t xMinimumEverFreeBytesRemaining = 0U;
+static size_t xNumberOfSuccessfulAllocations = 0U;
+static size_t xNumberOfSuccessfulFrees = 0U;
+
+/* Gets set to the top bit of an size_t type.  When this bit in the xBlockSize
+member of an BlockLink_t structure is set then the block belongs to the
+application.  When the bit is free the block is still part of the free heap
+space. */
+static size_t xBlockAllocatedBit = 0;
+
+/*-----------------------------------------------------------*/
+
+void *pvPortMalloc(size_t xWantedSize)
+{
+    BlockLink_t *pxBlock, *pxPreviousBlock, *pxNewBlockLink;
+    void *pvReturn = NULL;
+
+    vTaskSuspendAll();
+    {
+        /* If this is the first call to malloc then the heap will require
+        initialisation to setup the list of free blocks. */
+        if (pxEnd == NULL) {
+            prvHeapInit();
+        }
+
+        /* Check the requested block size is not so large that the top bit is
+        set.  The top bit of the block size member of the BlockLink_t structure
+        is used to determine who owns the block - the application or the
+        kernel, so it must be free. */
+        if ((pxEnd != NULL) && ((xWantedSize & xBlockAllocatedBit) == 0)) {
+            /* The wanted size is increased so it can contain a BlockLink_t
+            structure in addition to the requested amount of bytes, and so
+            that the block after it stays aligned. */
+            if (xWantedSize > 0) {
+                xWantedSize += xHeapStructSize;
+                xWantedSize = (xWantedSize + heapBYTE_ALIGNMENT_MASK) &
+                              ~heapBYTE_ALIGNMENT_MASK;
+            }
+
+            if ((xWantedSize > 0) && (xWantedSize <= xFreeBytesRemaining)) {
+                /* Traverse the list from the start (lowest address) block until
+                one of adequate size is found. */
+                pxPreviousBlock = &xStart;
+                pxBlock = xStart.pxNextFreeBlock;
+                while ((pxBlock->xBlockSize < xWantedSize) &&
+                       (pxBlock->pxNextFreeBlock != NULL)) {
+                    pxPreviousBlock = pxBlock;
+                    pxBlock = pxBlock->pxNextFreeBlock;
+                }
+
+                /* If the end marker was reached then a block of adequate size
+                was not found. */
+                if (pxBlock != pxEnd) {
+                    /* Return the memory space pointed to - jumping over the
+                    BlockLink_t structure at its start. */
+                    pvReturn = (void *)(((uint8_t *)pxPreviousBlock->pxNextFreeBlock) +
+                                        xHeapStructSize);
+
+                    /* This block is being returned for use so must be taken out
+                    of the list of free blocks. */
+                    pxPreviousBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+
+                    /* If the block is larger than required it can be split into
+                    two. */
+                    if ((pxBlock->xBlockSize - xWantedSize) > heapMINIMUM_BLOCK_SIZE) {
+                        /* This block is to be split into two.  Create a new
+                        block following the number of bytes requested. */
+                        pxNewBlockLink = (void *)(((uint8_t *)pxBlock) + xWantedSize);
+
+                        /* Calculate the sizes of two blocks split from the
+                        single block. */
+                        pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
+                        pxBlock->xBlockSize = xWantedSize;
+
+                        /* Insert the new block into the list of free blocks. */
+                        prvInsertBlockIntoFreeList(pxNewBlockLink);
+                    }
+
+                    xFreeBytesRemaining -= pxBlock->xBlockSize;
+
+                    if (xFreeBytesRemaining < xMinimumEverFreeBytesRemaining) {
+                        xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+                    }
+
+                    /* The block is being returned - it is allocated and owned
+                    by the application and has no "next" block. */
+                    pxBlock->xBlockSize |= xBlockAllocatedBit;
+                    pxBlock->pxNextFreeBlock = NULL;
+                    xNumberOfSuccessfulAllocations++;
+                }
+            }
+        }
+
+        traceMALLOC(pvReturn, xWantedSize);
+    }
+    (void)xTaskResumeAll();
+
+#if( configUSE_MALLOC_FAILED_HOOK == 1 )
+    {
+        if (pvReturn == NULL) {
+            extern void vApplicationMallocFailedHook(void);
+            vApplicationMallocFailedHook();
+        }
+    }
+#endif
+
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree(void *pv)
+{
+    uint8_t *puc = (uint8_t *)pv;
+    BlockLink_t *pxLink;
+
+    if (pv != NULL) {
+        /* The memory being freed will have an BlockLink_t structure immediately
+        before it. */
+        puc -= xHeapStructSize;
+        pxLink = (void *)puc;
+
+        /* Check the block is actually allocated. */
+        configASSERT((pxLink->xBlockSize & xBlockAllocatedBit) != 0);
+        configASSERT(pxLink->pxNextFreeBlock == NULL);
+
+        if (((pxLink->xBlockSize & xBlockAllocatedBit) != 0) &&
+            (pxLink->pxNextFreeBlock == NULL)) {
+            /* The block is being returned to the heap - it is no longer
+            allocated. */
+            pxLink->xBlockSize &= ~xBlockAllocatedBit;
+
+            vTaskSuspendAll();
+            {
+                /* Add this block to the list of free blocks. */
+                xFreeBytesRemaining += pxLink->xBlockSize;
+                traceFREE(pv, pxLink->xBlockSize);
+                prvInsertBlockIntoFreeList(pxLink);
+                xNumberOfSuccessfulFrees++;
+            }
+            (void)xTaskResumeAll();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize(void)
+{
+    return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize(void)
+{
+    return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks(void)
+{
+    /* This just exists to keep the linker quiet. */
+}
+/*-----------------------------------------------------------*/
+
+#if( configPOSIX_HEAP_GUARD_PAGES == 1 )
+
+/* Maps xSize bytes, rounded up to whole pages, between two inaccessible pages.
+The returned start is placed so the heap ends right at the upper one. */
+static uint8_t *prvMapGuardedRegion(size_t xSize)
+{
+    size_t xPageSize = (size_t)sysconf(_SC_PAGESIZE);
+    size_t xRegionSize = (xSize + xPageSize - 1) & ~(xPageSize - 1);
+    uint8_t *pucMapping;
+
+    pucMapping = mmap(NULL, xRegionSize + 2 * xPageSize, PROT_NONE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == (void *)pucMapping) {
+        return NULL;
+    }
+
+    if (mprotect(pucMapping + xPageSize, xRegionSize,
+                 PROT_READ | PROT_WRITE) != 0) {
+        (void)munmap(pucMapping, xRegionSize + 2 * xPageSize);
+        return NULL;
+    }
+
+    return pucMapping + xPageSize + xRegionSize -
+           (xSize & ~heapBYTE_ALIGNMENT_MASK);
+}
+
+#endif /* configPOSIX_HEAP_GUARD_PAGES */
+/*-----------------------------------------------------------*/
+
+static void prvHeapInit(void)
+{
+    BlockLink_t *pxFirstFreeBlock;
+    uint8_t *pucAlignedHeap;
+    size_t uxAddress;
+    size_t xTotalHeapSize = configTOTAL_HEAP_SIZE;
+
+#if( configPOSIX_HEAP_GUARD_PAGES == 1 )
+    pucAlignedHeap = prvMapGuardedRegion(xTotalHeapSize);
+    configASSERT(pucAlignedHeap != NULL);
+    if (pucAlignedHeap == NULL) {
+        return;
+    }
+    xTotalHeapSize &= ~heapBYTE_ALIGNMENT_MASK;
+#else
+    /* ucHeap is declared aligned. */
+    pucAlignedHeap = ucHeap;
+#endif
+
+    /* xStart is used to hold a pointer to the first item in the list of free
+    blocks.  The void cast is used to prevent compiler warnings. */
+    xStart.pxNextFreeBlock = (void *)pucAlignedHeap;
+    xStart.xBlockSize = (size_t)0;
+
+    /* pxEnd is used to mark the end of the list of free blocks and is inserted
+    at the end of the heap space. */
+    uxAddress = ((size_t)pucAlignedHeap) + xTotalHeapSize;
+    uxAddress -= xHeapStructSize;
+    uxAddress &= ~heapBYTE_ALIGNMENT_MASK;
+    pxEnd = (void *)uxAddress;
+    pxEnd->xBlockSize = 0;
+    pxEnd->pxNextFreeBlock = NULL;
+
+    /* To start with there is a single free block that is sized to take up the
+    entire heap space, minus the space taken by pxEnd. */
+    pxFirstFreeBlock = (void *)pucAlignedHeap;
+    pxFirstFreeBlock->xBlockSize = uxAddress - (size_t)pxFirstFreeBlock;
+    pxFirstFreeBlock->pxNextFreeBlock = pxEnd;
+
+    /* Only one block exists - and it covers the entire usable heap space. */
+    xMinimumEverFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
+    xFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
+
+    /* Work out the position of the top bit in a size_t variable. */
+    xBlockAllocatedBit = ((size_t)1) << ((sizeof(size_t) * heapBITS_PER_BYTE) - 1);
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertBlockIntoFreeList(BlockLink_t *pxBlockToInsert)
+{
+    BlockLink_t *pxIterator;
+    uint8_t *puc;
+
+    /* Iterate through the list until a block is found that has a higher address
+    than the block being inserted. */
+    for (pxIterator = &xStart; pxIterator->pxNextFreeBlock < pxBlockToInsert;
+         pxIterator = pxIterator->pxNextFreeBlock) {
+        /* Nothing to do here, just iterate to the right position. */
+    }
+
+    /* Do the block being inserted, and the block it is being inserted after
+    make a contiguous block of memory? */
+    puc = (uint8_t *)pxIterator;
+    if ((puc + pxIterator->xBlockSize) == (uint8_t *)pxBlockToInsert) {
+        pxIterator->xBlockSize += pxBlockToInsert->xBlockSize;
+        pxBlockToInsert = pxIterator;
+    }
+
+    /* Do the block being inserted, and the block it is being inserted before
+    make a contiguous block of memory? */
+    puc = (uint8_t *)pxBlockToInsert;
+    if ((puc + pxBlockToInsert->xBlockSize) == (uint8_t *)pxIterator->pxNextFreeBlock) {
+        if (pxIterator->pxNextFreeBlock != pxEnd) {
+            /* Form one big block from the two blocks. */
+            pxBlockToInsert->xBlockSize += pxIterator->pxNextFreeBlock->xBlockSize;
+            pxBlockToInsert->pxNextFreeBlock = pxIterator->pxNextFreeBlock->pxNextFreeBlock;
+        }
+        else {
+            pxBlockToInsert->pxNextFreeBlock = pxEnd;
+        }
+    }
+    else {
+        pxBlockToInsert->pxNextFreeBlock = pxIterator->pxNextFreeBlock;
+    }
+
+    /* If the block being inserted plugged a gap, so was merged with the block
+    before and the block after, then it's pxNextFreeBlock pointer will have
+    already been set, and should not be set here as that would make it point
+    to itself. */
+    if (pxIterator != pxBlockToInsert) {
+        pxIterator->pxNextFreeBlock = pxBlockToInsert;
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats(HeapStats_t *pxHeapStats)
+{
+    BlockLink_t *pxBlock;
+    size_t xBlocks = 0, xMaxSize = 0, xMinSize = SIZE_MAX;
+    size_t uxBucket;
+
+    memset(pxHeapStats, 0, sizeof(HeapStats_t));
+
+    vTaskSuspendAll();
+    {
+        pxBlock = xStart.pxNextFreeBlock;
+
+        /* pxBlock will be NULL if the heap has not been initialised. */
+        if (pxBlock != NULL) {
+            while (pxBlock != pxEnd) {
+                /* Increment the number of blocks and record the largest block
+                seen so far. */
+                xBlocks++;
+
+                if (pxBlock->xBlockSize > xMaxSize) {
+                    xMaxSize = pxBlock->xBlockSize;
+                }
+
+                if (pxBlock->xBlockSize < xMinSize) {
+                    xMinSize = pxBlock->xBlockSize;
+                }
+
+                /* Blocks are at least heapMINIMUM_BLOCK_SIZE, so never 0. */
+                uxBucket = (sizeof(unsigned long) * heapBITS_PER_BYTE - 1) -
+                           __builtin_clzl((unsigned long)pxBlock->xBlockSize);
+                uxBucket = uxBucket > 4 ? uxBucket - 4 : 0;
+                if (uxBucket >= portHEAP_HISTOGRAM_BUCKETS) {
+                    uxBucket = portHEAP_HISTOGRAM_BUCKETS - 1;
+                }
+                pxHeapStats->xFreeBlockHistogram[ uxBucket ]++;
+
+                /* Move to the next block in the chain until the last block is
+                reached. */
+                pxBlock = pxBlock->pxNextFreeBlock;
+            }
+        }
+
+        pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+        pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xBlocks > 0 ? xMinSize : 0;
+        pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+        pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+        pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+        pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+        pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+    }
+    (void)xTaskResumeAll();
+}
@@ -0,0 +1,507 @@
+/*
+    This file is part of the FreeRTOS.org distribution.
+
+    FreeRTOS.org is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License (version 2) as published
+    by the Free Software Foundation and modified by the FreeRTOS exception.
+
+    FreeRTOS.org is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+
+    1 tab == 4 spaces!
+*/
+
+
+/*
+ * The heap_4.c allocator spread over the regions passed to
+ * vPortDefineHeapRegions(), to model a target whose heap is split across
+ * several RAM banks.  The regions must be listed in order of their address.
+ *
+ * vPortDefineHeapRegions() must be called before the first pvPortMalloc().
+ * If it was not, pvPortMalloc() defines a single region of
+ * configTOTAL_HEAP_SIZE bytes itself, which with configPOSIX_HEAP_GUARD_PAGES
+ * set to 1 is mapped between two guard pages.
+ *
+ * See heap_4.c for the single region version.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+/* portBYTE_ALIGNMENT is that of the target, code compiled for the host
+expects the alignment malloc() gives. */
+#define heapBYTE_ALIGNMENT          ( ( size_t ) 16 )
+#define heapBYTE_ALIGNMENT_MASK     ( heapBYTE_ALIGNMENT - 1 )
+
+/* Block sizes must not get too small. */
+#define heapMINIMUM_BLOCK_SIZE      ( ( size_t ) ( xHeapStructSize << 1 ) )
+
+/* Assumes 8bit bytes! */
+#define heapBITS_PER_BYTE           ( ( size_t ) 8 )
+
+/* Define the linked list structure.  This is used to link free blocks in order
+of their memory address. */
+typedef struct A_BLOCK_LINK {
+    struct A_BLOCK_LINK *pxNextFreeBlock;   /*<< The next free block in the list. */
+    size_t xBlockSize;                      /*<< The size of the free block. */
+} BlockLink_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Inserts a block of memory that is being freed into the correct position in
+ * the list of free memory blocks.  The block being freed will be merged with
+ * the block in front it and/or the block behind it if the memory blocks are
+ * adjacent to each other.
+ */
+static void prvInsertBlockIntoFreeList(BlockLink_t *pxBlockToInsert);
+
+/*
+ * Defines the default region, when the application has defined none before
+ * the first call to pvPortMalloc().
+ */
+static void prvDefineDefaultRegion(void);
+
+/*-----------------------------------------------------------*/
+
+/* The size of the structure placed at the beginning of each allocated memory
+block must by correctly byte aligned. */
+static const size_t xHeapStructSize = (sizeof(BlockLink_t) +
+                                       heapBYTE_ALIGNMENT_MASK) & ~heapBYTE_ALIGNMENT_MASK;
+
+#if( configPOSIX_HEAP_GUARD_PAGES == 0 )
+/* The default region. */
+static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ] __attribute__((aligned(16)));
+#endif
+
+/* Create a couple of list links to mark the start and end of the list. */
+static BlockLink_t xStart, *pxEnd = NULL;
+
+/* Keeps track of the number of free bytes remaining, but says nothing about
+fragmentation. */
+static size_t xFreeBytesRemaining = 0U;
+static size_t xMinimumEverFreeBytesRemaining = 0U;
+static size_t xNumberOfSuccessfulAllocations = 0U;
+static size_t xNumberOfSuccessfulFrees = 0U;
+
+/* Gets set to the top bit of an size_t type.  When this bit in the xBlockSize
+member of an BlockLink_t structure is set then the block belongs to the
+application.  When the bit is free the block is still part of the free heap
+space. */
+static size_t xBlockAllocatedBit = 0;
+
+/*-----------------------------------------------------------*/
+
+void *pvPortMalloc(size_t xWantedSize)
+{
+    BlockLink_t *pxBlock, *pxPreviousBlock, *pxNewBlockLink;
+    void *pvReturn = NULL;
+
+    vTaskSuspendAll();
+    {
+        /* Without regions defined by the application the heap is
+        configTOTAL_HEAP_SIZE bytes, as with heap_4.c. */
+        if (pxEnd == NULL) {
+            prvDefineDefaultRegion();
+        }
+
+        /* Check the requested block size is not so large that the top bit is
+        set.  The top bit of the block size member of the BlockLink_t structure
+        is used to determine who owns the block - the application or the
+        kernel, so it must be free. */
+        if ((pxEnd != NULL) && ((xWantedSize & xBlockAllocatedBit) == 0)) {
+            /* The wanted size is increased so it can contain a BlockLink_t
+            structure in addition to the requested amount of bytes, and so
+            that the block after it stays aligned. */
+            if (xWantedSize > 0) {
+                xWantedSize += xHeapStructSize;
+                xWantedSize = (xWantedSize + heapBYTE_ALIGNMENT_MASK) &
+                              ~heapBYTE_ALIGNMENT_MASK;
+            }
+
+            if ((xWantedSize > 0) && (xWantedSize <= xFreeBytesRemaining)) {
+                /* Traverse the list from the start (lowest address) block until
+                one of adequate size is found. */
+                pxPreviousBlock = &xStart;
+                pxBlock = xStart.pxNextFreeBlock;
+                while ((pxBlock->xBlockSize < xWantedSize) &&
+                       (pxBlock->pxNextFreeBlock != NULL)) {
+                    pxPreviousBlock = pxBlock;
+                    pxBlock = pxBlock->pxNextFreeBlock;
+                }
+
+                /* If the end marker was reached then a block of adequate size
+                was not found. */
+                if (pxBlock != pxEnd) {
+                    /* Return the memory space pointed to - jumping over the
+                    BlockLink_t structure at its start. */
+                    pvReturn = (void *)(((uint8_t *)pxPreviousBlock->pxNextFreeBlock) +
+                                        xHeapStructSize);
+
+                    /* This block is being returned for use so must be taken out
+                    of the list of free blocks. */
+                    pxPreviousBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+
+                    /* If the block is larger than required it can be split into
+                    two. */
+                    if ((pxBlock->xBlockSize - xWantedSize) > heapMINIMUM_BLOCK_SIZE) {
+                        /* This block is to be split into two.  Create a new
+                        block following the number of bytes requested. */
+                        pxNewBlockLink = (void *)(((uint8_t *)pxBlock) + xWantedSize);
+
+                        /* Calculate the sizes of two blocks split from the
+                        single block. */
+                        pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
+                        pxBlock->xBlockSize = xWantedSize;
+
+                        /* Insert the new block into the list of free blocks. */
+                        prvInsertBlockIntoFreeList(pxNewBlockLink);
+                    }
+
+                    xFreeBytesRemaining -= pxBlock->xBlockSize;
+
+                    if (xFreeBytesRemaining < xMinimumEverFreeBytesRemaining) {
+                        xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+                    }
+
+                    /* The block is being returned - it is allocated and owned
+                    by the application and has no "next" block. */
+                    pxBlock->xBlockSize |= xBlockAllocatedBit;
+                    pxBlock->pxNextFreeBlock = NULL;
+                    xNumberOfSuccessfulAllocations++;
+                }
+            }
+        }
+
+        traceMALLOC(pvReturn, xWantedSize);
+    }
+    (void)xTaskResumeAll();
+
+#if( configUSE_MALLOC_FAILED_HOOK == 1 )
+    {
+        if (pvReturn == NULL) {
+            extern void vApplicationMallocFailedHook(void);
+            vApplicationMallocFailedHook();
+        }
+    }
+#endif
+
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree(void *pv)
+{
+    uint8_t *puc = (uint8_t *)pv;
+    BlockLink_t *pxLink;
+
+    if (pv != NULL) {
+        /* The memory being freed will have an BlockLink_t structure immediately
+        before it. */
+        puc -= xHeapStructSize;
+        pxLink = (void *)puc;
+
+        /* Check the block is actually allocated. */
+        configASSERT((pxLink->xBlockSize & xBlockAllocatedBit) != 0);
+        configASSERT(pxLink->pxNextFreeBlock == NULL);
+
+        if (((pxLink->xBlockSize & xBlockAllocatedBit) != 0) &&
+            (pxLink->pxNextFreeBlock == NULL)) {
+            /* The block is being returned to the heap - it is no longer
+            allocated. */
+            pxLink->xBlockSize &= ~xBlockAllocatedBit;
+
+            vTaskSuspendAll();
+            {
+                /* Add this block to the list of free blocks. */
+                xFreeBytesRemaining += pxLink->xBlockSize;
+                traceFREE(pv, pxLink->xBlockSize);
+                prvInsertBlockIntoFreeList(pxLink);
+                xNumberOfSuccessfulFrees++;
+            }
+            (void)xTaskResumeAll();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize(void)
+{
+    return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize(void)
+{
+    return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks(void)
+{
+    /* This just exists to keep the linker quiet. */
+}
+/*-----------------------------------------------------------*/
+
+#if( configPOSIX_HEAP_GUARD_PAGES == 1 )
+
+/* Maps xSize bytes, rounded up to whole pages, between two inaccessible pages.
+The returned start is placed so the heap ends right at the upper one. */
+static uint8_t *prvMapGuardedRegion(size_t xSize)
+{
+    size_t xPageSize = (size_t)sysconf(_SC_PAGESIZE);
+    size_t xRegionSize = (xSize + xPageSize - 1) & ~(xPageSize - 1);
+    uint8_t *pucMapping;
+
+    pucMapping = mmap(NULL, xRegionSize + 2 * xPageSize, PROT_NONE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == (void *)pucMapping) {
+        return NULL;
+    }
+
+    if (mprotect(pucMapping + xPageSize, xRegionSize,
+                 PROT_READ | PROT_WRITE) != 0) {
+        (void)munmap(pucMapping, xRegionSize + 2 * xPageSize);
+        return NULL;
+    }
+
+    return pucMapping + xPageSize + xRegionSize -
+           (xSize & ~heapBYTE_ALIGNMENT_MASK);
+}
+
+#endif /* configPOSIX_HEAP_GUARD_PAGES */
+/*-----------------------------------------------------------*/
+
+static void prvDefineDefaultRegion(void)
+{
+    HeapRegion_t xRegions[ 2 ] = {
+        { NULL, configTOTAL_HEAP_SIZE },
+        { NULL, 0 }
+    };
+
+#if( configPOSIX_HEAP_GUARD_PAGES == 1 )
+    xRegions[ 0 ].pucStartAddress = prvMapGuardedRegion(configTOTAL_HEAP_SIZE);
+    configASSERT(xRegions[ 0 ].pucStartAddress != NULL);
+    if (xRegions[ 0 ].pucStartAddress == NULL) {
+        return;
+    }
+    xRegions[ 0 ].xSizeInBytes &= ~heapBYTE_ALIGNMENT_MASK;
+#else
+    xRegions[ 0 ].pucStartAddress = ucHeap;
+#endif
+
+    vPortDefineHeapRegions(xRegions);
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertBlockIntoFreeList(BlockLink_t *pxBlockToInsert)
+{
+    BlockLink_t *pxIterator;
+    uint8_t *puc;
+
+    /* Iterate through the list until a block is found that has a higher address
+    than the block being inserted. */
+    for (pxIterator = &xStart; pxIterator->pxNextFreeBlock < pxBlockToInsert;
+         pxIterator = pxIterator->pxNextFreeBlock) {
+        /* Nothing to do here, just iterate to the right position. */
+    }
+
+    /* Do the block being inserted, and the block it is being inserted after
+    make a contiguous block of memory? */
+    puc = (uint8_t *)pxIterator;
+    if ((puc + pxIterator->xBlockSize) == (uint8_t *)pxBlockToInsert) {
+        pxIterator->xBlockSize += pxBlockToInsert->xBlockSize;
+        pxBlockToInsert = pxIterator;
+    }
+
+    /* Do the block being inserted, and the block it is being inserted before
+    make a contiguous block of memory? */
+    puc = (uint8_t *)pxBlockToInsert;
+    if ((puc + pxBlockToInsert->xBlockSize) == (uint8_t *)pxIterator->pxNextFreeBlock) {
+        if (pxIterator->pxNextFreeBlock != pxEnd) {
+            /* Form one big block from the two blocks. */
+            pxBlockToInsert->xBlockSize += pxIterator->pxNextFreeBlock->xBlockSize;
+            pxBlockToInsert->pxNextFreeBlock = pxIterator->pxNextFreeBlock->pxNextFreeBlock;
+        }
+        else {
+            pxBlockToInsert->pxNextFreeBlock = pxEnd;
+        }
+    }
+    else {
+        pxBlockToInsert->pxNextFreeBlock = pxIterator->pxNextFreeBlock;
+    }
+
+    /* If the block being inserted plugged a gap, so was merged with the block
+    before and the block after, then it's pxNextFreeBlock pointer will have
+    already been set, and should not be set here as that would make it point
+    to itself. */
+    if (pxIterator != pxBlockToInsert) {
+        pxIterator->pxNextFreeBlock = pxBlockToInsert;
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortDefineHeapRegions(const HeapRegion_t *const pxHeapRegions)
+{
+    BlockLink_t *pxFirstFreeBlockInRegion = NULL, *pxPreviousFreeBlock;
+    size_t xAlignedHeap;
+    size_t xTotalRegionSize, xTotalHeapSize = 0;
+    BaseType_t xDefinedRegions = 0;
+    size_t xAddress;
+    const HeapRegion_t *pxHeapRegion;
+
+    /* Can only call once! */
+    configASSERT(pxEnd == NULL);
+
+    pxHeapRegion = &(pxHeapRegions[ xDefinedRegions ]);
+
+    while (pxHeapRegion->xSizeInBytes > 0) {
+        xTotalRegionSize = pxHeapRegion->xSizeInBytes;
+
+        /* Ensure the heap region starts on a correctly aligned boundary. */
+        xAddress = (size_t)pxHeapRegion->pucStartAddress;
+        if ((xAddress & heapBYTE_ALIGNMENT_MASK) != 0) {
+            xAddress += heapBYTE_ALIGNMENT_MASK;
+            xAddress &= ~heapBYTE_ALIGNMENT_MASK;
+
+            /* Adjust the size for the bytes lost to alignment. */
+            xTotalRegionSize -= xAddress - (size_t)pxHeapRegion->pucStartAddress;
+        }
+
+        xAlignedHeap = xAddress;
+
+        /* Set xStart if it has not already been set. */
+        if (xDefinedRegions == 0) {
+            /* xStart is used to hold a pointer to the first item in the list
+            of free blocks.  The void cast is used to prevent compiler
+            warnings. */
+            xStart.pxNextFreeBlock = (BlockLink_t *)xAlignedHeap;
+            xStart.xBlockSize = (size_t)0;
+        }
+        else {
+            /* Should only get here if one region has already been added to
+            the heap. */
+            configASSERT(pxEnd != NULL);
+
+            /* Check blocks are passed in with increasing start addresses. */
+            configASSERT(xAddress > (size_t)pxEnd);
+        }
+
+        /* Remember the location of the end marker in the previous region, if
+        any. */
+        pxPreviousFreeBlock = pxEnd;
+
+        /* pxEnd is used to mark the end of the list of free blocks and is
+        inserted at the end of the region space. */
+        xAddress = xAlignedHeap + xTotalRegionSize;
+        xAddress -= xHeapStructSize;
+        xAddress &= ~heapBYTE_ALIGNMENT_MASK;
+        pxEnd = (BlockLink_t *)xAddress;
+        pxEnd->xBlockSize = 0;
+        pxEnd->pxNextFreeBlock = NULL;
+
+        /* To start with there is a single free block in this region that is
+        sized to take up the entire heap region minus the space taken by the
+        free block structure. */
+        pxFirstFreeBlockInRegion = (BlockLink_t *)xAlignedHeap;
+        pxFirstFreeBlockInRegion->xBlockSize = xAddress -
+                                               (size_t)pxFirstFreeBlockInRegion;
+        pxFirstFreeBlockInRegion->pxNextFreeBlock = pxEnd;
+
+        /* If this is not the first region that makes up the entire heap space
+        then link the previous region to this region. */
+        if (pxPreviousFreeBlock != NULL) {
+            pxPreviousFreeBlock->pxNextFreeBlock = pxFirstFreeBlockInRegion;
+        }
+
+        xTotalHeapSize += pxFirstFreeBlockInRegion->xBlockSize;
+
+        /* Move onto the next HeapRegion_t structure. */
+        xDefinedRegions++;
+        pxHeapRegion = &(pxHeapRegions[ xDefinedRegions ]);
+    }
+
+    xMinimumEverFreeBytesRemaining = xTotalHeapSize;
+    xFreeBytesRemaining = xTotalHeapSize;
+
+    /* Check something was actually defined before it is accessed. */
+    configASSERT(xTotalHeapSize);
+
+    /* Work out the position of the top bit in a size_t variable. */
+    xBlockAllocatedBit = ((size_t)1) << ((sizeof(size_t) * heapBITS_PER_BYTE) - 1);
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats(HeapStats_t *pxHeapStats)
+{
+    BlockLink_t *pxBlock;
+    size_t xBlocks = 0, xMaxSize = 0, xMinSize = SIZE_MAX;
+    size_t uxBucket;
+
+    memset(pxHeapStats, 0, sizeof(HeapStats_t));
+
+    vTaskSuspendAll();
+    {
+        pxBlock = xStart.pxNextFreeBlock;
+
+        /* pxBlock will be NULL if the heap has not been initialised. */
+        if (pxBlock != NULL) {
+            while (pxBlock != pxEnd) {
+                /* The end marker of a region links to the next region, it is
+                not a free block. */
+                if (pxBlock->xBlockSize > 0) {
+                    /* Increment the number of blocks and record the largest
+                    block seen so far. */
+                    xBlocks++;
+
+                    if (pxBlock->xBlockSize > xMaxSize) {
+                        xMaxSize = pxBlock->xBlockSize;
+                    }
+
+                    if (pxBlock->xBlockSize < xMinSize) {
+                        xMinSize = pxBlock->xBlockSize;
+                    }
+
+                    uxBucket = (sizeof(unsigned long) * heapBITS_PER_BYTE - 1) -
+                               __builtin_clzl((unsigned long)pxBlock->xBlockSize);
+                    uxBucket = uxBucket > 4 ? uxBucket - 4 : 0;
+                    if (uxBucket >= portHEAP_HISTOGRAM_BUCKETS) {
+                        uxBucket = portHEAP_HISTOGRAM_BUCKETS - 1;
+                    }
+                    pxHeapStats->xFreeBlockHistogram[ uxBucket ]++;
+                }
+
+                /* Move to the next block in the chain until the last block is
+                reached. */
+                pxBlock = pxBlock->pxNextFreeBlock;
+            }
+        }
+
+        pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+        pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xBlocks > 0 ? xMinSize : 0;
+        pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+        pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+        pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+        pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+        pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+    }
+    (void)xTaskResumeAll();
+}
@@ -0,0 +1,385 @@
+/*
+    This file is part of the FreeRTOS.org distribution.
+
+    FreeRTOS.org is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License (version 2) as published
+    by the Free Software Foundation and modified by the FreeRTOS exception.
+
+    FreeRTOS.org is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+
+    1 tab == 4 spaces!
+*/
+
+
+/*
+ * A pool allocator for the POSIX port that, unlike heap_3.c, never suspends
+ * the scheduler.
+ *
+ * Requests are rounded up, header included, to one of a set of power of two
+ * size classes from 32 bytes to 64 KiB, which covers TCBs, queues, timers,
+ * list items and the like.  Each host thread keeps a private free list per
+ * class, so an allocation or free normally touches no shared state at all.
+ * A thread whose list grows past heapCACHE_LIMIT blocks hands the whole list
+ * to a lock free stack shared by all threads, where a thread that runs out
+ * takes it from again.  That stack is only ever pushed onto and emptied as a
+ * whole, which keeps it free of the ABA problem without tagged pointers.
+ *
+ * Blocks are carved from slabs mapped for the thread and class, larger
+ * requests get a mapping of their own.  mmap() takes no user space lock, so
+ * unlike malloc() it cannot deadlock against a task preempted inside it.
+ *
+ * Memory is never returned to the host, except for the large mappings.  The
+ * unused rest of a thread's slabs is abandoned when the thread exits, the
+ * POSIX port keeps task threads pooled so that is rare.
+ *
+ * xPortGetFreeHeapSize() and xPortGetMinimumEverFreeHeapSize() report what
+ * the bytes in use, and their peak, would leave of configTOTAL_HEAP_SIZE.
+ * xPortGetHeapReservedSize() reports the bytes taken from the host, the
+ * difference to the bytes in use is what the size classes cost.
+ * vPortGetHeapStats() has no free list to walk, it leaves the free block
+ * fields and the histogram 0.
+ *
+ * See heap_3.c for an implementation on top of malloc() and free().
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* Keeps the memory handed out aligned for any host type. */
+#define heapHEADER_SIZE             ( ( size_t ) 16 )
+
+#define heapMIN_CLASS_SHIFT         5
+#define heapMAX_CLASS_SHIFT         16
+#define heapNUM_CLASSES             ( heapMAX_CLASS_SHIFT - heapMIN_CLASS_SHIFT + 1 )
+#define heapLARGE_CLASS             ( ( size_t ) heapNUM_CLASSES )
+
+/* Slabs hold at least heapMIN_SLAB_BLOCKS blocks and are at least
+heapMIN_SLAB_SIZE bytes. */
+#define heapMIN_SLAB_SIZE           ( ( size_t ) 64 * 1024 )
+#define heapMIN_SLAB_BLOCKS         ( ( size_t ) 16 )
+
+/* Free blocks a thread keeps per class before handing them to the others. */
+#define heapCACHE_LIMIT             ( ( size_t ) 64 )
+
+#define heapCLASS_SIZE( uxClass )   ( ( size_t ) 1 << ( ( uxClass ) + heapMIN_CLASS_SHIFT ) )
+
+/* Precedes every block.  A free block links to the next through the header,
+its class follows from the list it is on. */
+typedef union BLOCK_HEADER {
+    struct {
+        size_t xClass;
+        size_t xSize;   /* Requested size, or the mapping size of a large block. */
+    } xUsed;
+    union BLOCK_HEADER *pxNextFree;
+    uint8_t ucPad[ heapHEADER_SIZE ];
+} BlockHeader_t;
+
+typedef struct CLASS_CACHE {
+    BlockHeader_t *pxFree;
+    size_t uxFree;
+    uint8_t *pucSlab;       /* Not yet carved part of the current slab. */
+    uint8_t *pucSlabEnd;
+} ClassCache_t;
+
+static __thread ClassCache_t xCaches[ heapNUM_CLASSES ];
+static __thread BaseType_t xCachesRegistered = pdFALSE;
+
+static _Atomic( BlockHeader_t * ) pxSharedFree[ heapNUM_CLASSES ];
+
+static pthread_once_t xKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t xCacheKey;
+
+static _Atomic size_t xBytesInUse = 0;
+static _Atomic size_t xPeakBytesInUse = 0;
+static _Atomic size_t xBytesReserved = 0;
+static _Atomic size_t xAllocations = 0;
+static _Atomic size_t xFrees = 0;
+
+/*-----------------------------------------------------------*/
+
+static void prvPushShared(size_t uxClass, BlockHeader_t *pxHead,
+                          BlockHeader_t *pxTail)
+{
+    BlockHeader_t *pxOld = atomic_load_explicit(&pxSharedFree[ uxClass ],
+                           memory_order_relaxed);
+
+    do {
+        pxTail->pxNextFree = pxOld;
+    } while (!atomic_compare_exchange_weak_explicit(&pxSharedFree[ uxClass ],
+             &pxOld, pxHead, memory_order_release, memory_order_relaxed));
+}
+/*-----------------------------------------------------------*/
+
+static void prvFlushCache(ClassCache_t *pxCache, size_t uxClass)
+{
+    BlockHeader_t *pxTail = pxCache->pxFree;
+
+    if (NULL == pxTail) {
+        return;
+    }
+
+    while (NULL != pxTail->pxNextFree) {
+        pxTail = pxTail->pxNextFree;
+    }
+    prvPushShared(uxClass, pxCache->pxFree, pxTail);
+
+    pxCache->pxFree = NULL;
+    pxCache->uxFree = 0;
+}
+/*-----------------------------------------------------------*/
+
+/* Hands the free lists of an exiting thread to the others. */
+static void prvReleaseCaches(void *pvCaches)
+{
+    ClassCache_t *pxCaches = (ClassCache_t *)pvCaches;
+    size_t uxClass;
+
+    for (uxClass = 0; uxClass < heapNUM_CLASSES; uxClass++) {
+        prvFlushCache(&pxCaches[ uxClass ], uxClass);
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvCreateCacheKey(void)
+{
+    (void)pthread_key_create(&xCacheKey, prvReleaseCaches);
+}
+/*-----------------------------------------------------------*/
+
+static ClassCache_t *prvGetCache(size_t uxClass)
+{
+    if (pdFALSE == xCachesRegistered) {
+        (void)pthread_once(&xKeyOnce, prvCreateCacheKey);
+        (void)pthread_setspecific(xCacheKey, xCaches);
+        xCachesRegistered = pdTRUE;
+    }
+
+    return &xCaches[ uxClass ];
+}
+/*-----------------------------------------------------------*/
+
+static void *prvMap(size_t xSize)
+{
+    void *pvMapping = mmap(NULL, xSize, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (MAP_FAILED == pvMapping) {
+        return NULL;
+    }
+
+    atomic_fetch_add_explicit(&xBytesReserved, xSize, memory_order_relaxed);
+    return pvMapping;
+}
+/*-----------------------------------------------------------*/
+
+static void prvAccountAllocation(size_t xSize)
+{
+    size_t xInUse = atomic_fetch_add_explicit(&xBytesInUse, xSize,
+                    memory_order_relaxed) + xSize;
+    size_t xPeak = atomic_load_explicit(&xPeakBytesInUse,
+                                        memory_order_relaxed);
+
+    atomic_fetch_add_explicit(&xAllocations, 1, memory_order_relaxed);
+
+    while (xInUse > xPeak &&
+           !atomic_compare_exchange_weak_explicit(&xPeakBytesInUse, &xPeak,
+                   xInUse, memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+/*-----------------------------------------------------------*/
+
+static BlockHeader_t *prvAllocateFromClass(size_t uxClass)
+{
+    ClassCache_t *pxCache = prvGetCache(uxClass);
+    const size_t xBlockSize = heapCLASS_SIZE(uxClass);
+    BlockHeader_t *pxBlock;
+    size_t xSlabSize;
+
+    if (NULL == pxCache->pxFree) {
+        /* Take all the blocks other threads have given up. */
+        pxCache->pxFree = atomic_exchange_explicit(&pxSharedFree[ uxClass ],
+                          NULL, memory_order_acquire);
+        pxCache->uxFree = 0;
+    }
+
+    if (NULL != pxCache->pxFree) {
+        pxBlock = pxCache->pxFree;
+        pxCache->pxFree = pxBlock->pxNextFree;
+        if (pxCache->uxFree > 0) {
+            pxCache->uxFree--;
+        }
+        return pxBlock;
+    }
+
+    if (pxCache->pucSlab + xBlockSize > pxCache->pucSlabEnd) {
+        xSlabSize = xBlockSize * heapMIN_SLAB_BLOCKS;
+        if (xSlabSize < heapMIN_SLAB_SIZE) {
+            xSlabSize = heapMIN_SLAB_SIZE;
+        }
+
+        pxCache->pucSlab = prvMap(xSlabSize);
+        if (NULL == pxCache->pucSlab) {
+            pxCache->pucSlabEnd = NULL;
+            return NULL;
+        }
+        pxCache->pucSlabEnd = pxCache->pucSlab + xSlabSize;
+    }
+
+    pxBlock = (BlockHeader_t *)pxCache->pucSlab;
+    pxCache->pucSlab += xBlockSize;
+
+    return pxBlock;
+}
+/*-----------------------------------------------------------*/
+
+void *pvPortMalloc(size_t xWantedSize)
+{
+    BlockHeader_t *pxBlock = NULL;
+    size_t xTotalSize, uxClass;
+
+    if (xWantedSize > 0 && xWantedSize <= SIZE_MAX - heapHEADER_SIZE) {
+        xTotalSize = xWantedSize + heapHEADER_SIZE;
+
+        if (xTotalSize <= heapCLASS_SIZE(0)) {
+            uxClass = 0;
+        }
+        else {
+            /* Rounds up to the next power of two. */
+            uxClass = (sizeof(unsigned long) * 8) -
+                      __builtin_clzl((unsigned long)(xTotalSize - 1)) -
+                      heapMIN_CLASS_SHIFT;
+        }
+
+        if (uxClass < heapNUM_CLASSES) {
+            pxBlock = prvAllocateFromClass(uxClass);
+            if (NULL != pxBlock) {
+                pxBlock->xUsed.xClass = uxClass;
+                pxBlock->xUsed.xSize = xWantedSize;
+            }
+        }
+        else {
+            pxBlock = prvMap(xTotalSize);
+            if (NULL != pxBlock) {
+                pxBlock->xUsed.xClass = heapLARGE_CLASS;
+                pxBlock->xUsed.xSize = xTotalSize;
+            }
+        }
+    }
+
+    if (NULL != pxBlock) {
+        prvAccountAllocation(xWantedSize);
+        traceMALLOC(pxBlock + 1, xWantedSize);
+        return pxBlock + 1;
+    }
+
+    traceMALLOC(NULL, xWantedSize);
+
+#if( configUSE_MALLOC_FAILED_HOOK == 1 )
+    {
+        extern void vApplicationMallocFailedHook(void);
+        vApplicationMallocFailedHook();
+    }
+#endif
+
+    return NULL;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree(void *pv)
+{
+    BlockHeader_t *pxBlock;
+    ClassCache_t *pxCache;
+    size_t uxClass, xSize;
+
+    if (NULL == pv) {
+        return;
+    }
+
+    pxBlock = (BlockHeader_t *)pv - 1;
+    uxClass = pxBlock->xUsed.xClass;
+    configASSERT(uxClass <= heapLARGE_CLASS);
+
+    atomic_fetch_add_explicit(&xFrees, 1, memory_order_relaxed);
+
+    if (heapLARGE_CLASS == uxClass) {
+        xSize = pxBlock->xUsed.xSize;
+        traceFREE(pv, xSize - heapHEADER_SIZE);
+        atomic_fetch_sub_explicit(&xBytesInUse, xSize - heapHEADER_SIZE,
+                                  memory_order_relaxed);
+        atomic_fetch_sub_explicit(&xBytesReserved, xSize,
+                                  memory_order_relaxed);
+        (void)munmap(pxBlock, xSize);
+        return;
+    }
+
+    traceFREE(pv, pxBlock->xUsed.xSize);
+    atomic_fetch_sub_explicit(&xBytesInUse, pxBlock->xUsed.xSize,
+                              memory_order_relaxed);
+
+    pxCache = prvGetCache(uxClass);
+    pxBlock->pxNextFree = pxCache->pxFree;
+    pxCache->pxFree = pxBlock;
+
+    if (++pxCache->uxFree > heapCACHE_LIMIT) {
+        prvFlushCache(pxCache, uxClass);
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks(void)
+{
+    /* Only required when static memory is not cleared. */
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize(void)
+{
+    size_t xInUse = atomic_load_explicit(&xBytesInUse, memory_order_relaxed);
+
+    return xInUse < configTOTAL_HEAP_SIZE ? configTOTAL_HEAP_SIZE - xInUse : 0;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize(void)
+{
+    size_t xPeak = atomic_load_explicit(&xPeakBytesInUse,
+                                        memory_order_relaxed);
+
+    return xPeak < configTOTAL_HEAP_SIZE ? configTOTAL_HEAP_SIZE - xPeak : 0;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetHeapReservedSize(void)
+{
+    return atomic_load_explicit(&xBytesReserved, memory_order_relaxed);
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats(HeapStats_t *pxHeapStats)
+{
+    memset(pxHeapStats, 0, sizeof(HeapStats_t));
+
+    pxHeapStats->xAvailableHeapSpaceInBytes = xPortGetFreeHeapSize();
+    pxHeapStats->xMinimumEverFreeBytesRemaining =
+        xPortGetMinimumEverFreeHeapSize();
+    pxHeapStats->xNumberOfSuccessfulAllocations =
+        atomic_load_explicit(&xAllocations, memory_order_relaxed);
+    pxHeapStats->xNumberOfSuccessfulFrees =
+        atomic_load_explicit(&xFrees, memory_order_relaxed);
+}
@@ -166,6 +166,15 @@ typedef struct QueueDefinition {
     uint8_t ucQueueType;
 #endif
 
+#if (configUSE_QUEUE_ZERO_COPY == 1)
+    int8_t *pcReserved; /*< The slot handed out by xQueueReserve() until it is committed, otherwise NULL. */
+    int8_t *pcBorrowed; /*< The slot handed out by xQueueBorrow() until it is released, otherwise NULL. */
+#endif
+
+#if (configUSE_QUEUE_STATS == 1)
+    struct xQUEUE_STATS *pxQueueStats; /*< Where the statistics of the queue are collected, NULL if they are not. */
+#endif
+
 } xQUEUE;
 
 /* The old xQUEUE name is maintained above then typedefed to the new Queue_t
@@ -219,11 +228,13 @@ static void prvUnlockQueue(Queue_t *const pxQueue) PRIVILEGED_FUNCTION;
 static BaseType_t prvIsQueueEmpty(const Queue_t *pxQueue) PRIVILEGED_FUNCTION;
 
 /*
- * Uses a critical section to determine if there is any space in a queue.
+ * Uses a critical section to determine if there is any space in a queue for
+ * an item sent to xPosition.
  *
  * @return pdTRUE if there is no space, otherwise pdFALSE;
  */
-static BaseType_t prvIsQueueFull(const Queue_t *pxQueue) PRIVILEGED_FUNCTION;
+static BaseType_t prvIsQueueFull(const Queue_t *pxQueue,
+                                 const BaseType_t xPosition) PRIVILEGED_FUNCTION;
 
 /*
  * Copies an item into the queue, either at the front of the queue or the
@@ -268,6 +279,25 @@ static void prvInitialiseNewQueue(const UBaseType_t uxQueueLength,
 static void prvInitialiseMutex(Queue_t *pxNewQueue) PRIVILEGED_FUNCTION;
 #endif
 
+#if (configUSE_QUEUE_ZERO_COPY == 1)
+/*
+ * Blocks like xQueueGenericSend() until the slot at the back of the queue can
+ * be reserved, or like xQueueGenericReceive() until the item at the front can
+ * be borrowed, and hands out the slot.
+ */
+static BaseType_t prvTakeSlot(Queue_t *const pxQueue, void **const ppvSlot,
+                              TickType_t xTicksToWait,
+                              const BaseType_t xReserve) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblocks all the tasks on pxEventList, when a slot given back lets them try
+ * again.  Called from a critical section.
+ *
+ * @return pdTRUE if one of them has a higher priority than the calling task.
+ */
+static BaseType_t prvUnblockAll(List_t *const pxEventList) PRIVILEGED_FUNCTION;
+#endif
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -285,6 +315,30 @@ static void prvInitialiseMutex(Queue_t *pxNewQueue) PRIVILEGED_FUNCTION;
         }                                                              \
     }                                                                      \
     taskEXIT_CRITICAL()
+
+/*
+ * Whether an item can be sent to xPosition, and whether the item at the front
+ * can be received.  A reserved slot is the next one written at the back and a
+ * borrowed slot the next one read, so while either is out the operations that
+ * would touch it wait as if the queue were full or empty.
+ */
+#if (configUSE_QUEUE_ZERO_COPY == 1)
+#define prvCanSendToQueue(pxQueue, xPosition)                                  \
+    (((pxQueue)->pcReserved == NULL) &&                                    \
+     (((xPosition) == queueSEND_TO_BACK) ||                                \
+      ((pxQueue)->pcBorrowed == NULL)) &&                                  \
+     (((pxQueue)->uxMessagesWaiting < (pxQueue)->uxLength) ||              \
+      ((xPosition) == queueOVERWRITE)))
+#define prvCanReceiveFromQueue(pxQueue)                                        \
+    (((pxQueue)->pcBorrowed == NULL) &&                                    \
+     ((pxQueue)->uxMessagesWaiting > (UBaseType_t)0))
+#else
+#define prvCanSendToQueue(pxQueue, xPosition)                                  \
+    (((pxQueue)->uxMessagesWaiting < (pxQueue)->uxLength) ||               \
+     ((xPosition) == queueOVERWRITE))
+#define prvCanReceiveFromQueue(pxQueue)                                        \
+    ((pxQueue)->uxMessagesWaiting > (UBaseType_t)0)
+#endif /* configUSE_QUEUE_ZERO_COPY */
 /*-----------------------------------------------------------*/
 
 BaseType_t xQueueGenericReset(QueueHandle_t xQueue, BaseType_t xNewQueue)
@@ -305,6 +359,13 @@ BaseType_t xQueueGenericReset(QueueHandle_t xQueue, BaseType_t xNewQueue)
         pxQueue->cRxLock = queueUNLOCKED;
         pxQueue->cTxLock = queueUNLOCKED;
 
+#if (configUSE_QUEUE_ZERO_COPY == 1)
+        {
+            pxQueue->pcReserved = NULL;
+            pxQueue->pcBorrowed = NULL;
+        }
+#endif
+
         if (xNewQueue == pdFALSE) {
             /* If there are tasks blocked waiting to read from the queue, then
             the tasks will remain blocked as after this function exits the queue
@@ -782,8 +843,7 @@ BaseType_t xQueueGenericSend(QueueHandle_t xQueue,
             highest priority task wanting to access the queue.  If the head item
             in the queue is to be overwritten then it does not matter if the
             queue is full. */
-            if ((pxQueue->uxMessagesWaiting < pxQueue->uxLength) ||
-                (xCopyPosition == queueOVERWRITE)) {
+            if (prvCanSendToQueue(pxQueue, xCopyPosition)) {
                 traceQUEUE_SEND(pxQueue);
                 xYieldRequired = prvCopyDataToQueue(
                                      pxQueue, pvItemToQueue, xCopyPosition);
@@ -906,7 +966,7 @@ BaseType_t xQueueGenericSend(QueueHandle_t xQueue,
 
         /* Update the timeout state to see if it has expired yet. */
         if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) == pdFALSE) {
-            if (prvIsQueueFull(pxQueue) != pdFALSE) {
+            if (prvIsQueueFull(pxQueue, xCopyPosition) != pdFALSE) {
                 traceBLOCKING_ON_QUEUE_SEND(pxQueue);
                 vTaskPlaceOnEventList(
                     &(pxQueue->xTasksWaitingToSend),
@@ -984,8 +1044,7 @@ BaseType_t xQueueGenericSendFromISR(QueueHandle_t xQueue,
     post). */
     uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
     {
-        if ((pxQueue->uxMessagesWaiting < pxQueue->uxLength) ||
-            (xCopyPosition == queueOVERWRITE)) {
+        if (prvCanSendToQueue(pxQueue, xCopyPosition)) {
             const int8_t cTxLock = pxQueue->cTxLock;
 
             traceQUEUE_SEND_FROM_ISR(pxQueue);
@@ -1304,7 +1363,7 @@ BaseType_t xQueueGenericReceive(QueueHandle_t xQueue, void *const pvBuffer,
 
             /* Is there data in the queue now?  To be running the calling task
             must be the highest priority task wanting to access the queue. */
-            if (uxMessagesWaiting > (UBaseType_t)0) {
+            if (prvCanReceiveFromQueue(pxQueue)) {
                 /* Remember the read position in case the queue is only being
                 peeked. */
                 pcOriginalReadPosition = pxQueue->u.pcReadFrom;
@@ -1497,7 +1556,7 @@ BaseType_t xQueueReceiveFromISR(QueueHandle_t xQueue, void *const pvBuffer,
             pxQueue->uxMessagesWaiting;
 
         /* Cannot block in an ISR, so check there is data available. */
-        if (uxMessagesWaiting > (UBaseType_t)0) {
+        if (prvCanReceiveFromQueue(pxQueue)) {
             const int8_t cRxLock = pxQueue->cRxLock;
 
             traceQUEUE_RECEIVE_FROM_ISR(pxQueue);
@@ -1585,7 +1644,7 @@ BaseType_t xQueuePeekFromISR(QueueHandle_t xQueue, void *const pvBuffer)
     uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
     {
         /* Cannot block in an ISR, so check there is data available. */
-        if (pxQueue->uxMessagesWaiting > (UBaseType_t)0) {
+        if (prvCanReceiveFromQueue(pxQueue)) {
             traceQUEUE_PEEK_FROM_ISR(pxQueue);
 
             /* Remember the read position so it can be reset as nothing is
@@ -1607,6 +1666,320 @@ BaseType_t xQueuePeekFromISR(QueueHandle_t xQueue, void *const pvBuffer)
 }
 /*-----------------------------------------------------------*/
 
+#if (configUSE_QUEUE_ZERO_COPY == 1)
+
+static BaseType_t prvTakeSlot(Queue_t *const pxQueue, void **const ppvSlot,
+                              TickType_t xTicksToWait,
+                              const BaseType_t xReserve)
+{
+    BaseType_t xEntryTimeSet = pdFALSE, xAvailable;
+    TimeOut_t xTimeOut;
+    int8_t *pcSlot;
+
+    for (;;) {
+        taskENTER_CRITICAL();
+        {
+            if (xReserve != pdFALSE) {
+                xAvailable = prvCanSendToQueue(pxQueue, queueSEND_TO_BACK);
+            }
+            else {
+                xAvailable = prvCanReceiveFromQueue(pxQueue);
+            }
+
+            if (xAvailable != pdFALSE) {
+                if (xReserve != pdFALSE) {
+                    /* The slot an item sent to the back would be copied to. */
+                    pcSlot = pxQueue->pcWriteTo;
+                    pxQueue->pcReserved = pcSlot;
+                }
+                else {
+                    /* The slot prvCopyDataFromQueue() would copy from, the
+                    read position only moves on once it is released. */
+                    pcSlot = pxQueue->u.pcReadFrom + pxQueue->uxItemSize;
+                    if (pcSlot >= pxQueue->pcTail) { /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
+                        pcSlot = pxQueue->pcHead;
+                    }
+                    else {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                    pxQueue->pcBorrowed = pcSlot;
+                    traceQUEUE_RECEIVE(pxQueue);
+                }
+
+                *ppvSlot = (void *)pcSlot;
+                taskEXIT_CRITICAL();
+                return pdPASS;
+            }
+            else {
+                if (xTicksToWait == (TickType_t)0) {
+                    taskEXIT_CRITICAL();
+                    break;
+                }
+                else if (xEntryTimeSet == pdFALSE) {
+                    vTaskSetTimeOutState(&xTimeOut);
+                    xEntryTimeSet = pdTRUE;
+                }
+                else {
+                    /* Entry time was already set. */
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        vTaskSuspendAll();
+        prvLockQueue(pxQueue);
+
+        /* Blocks exactly like xQueueGenericSend() and xQueueGenericReceive(). */
+        if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) == pdFALSE) {
+            if (xReserve != pdFALSE) {
+                xAvailable = (prvIsQueueFull(pxQueue, queueSEND_TO_BACK) == pdFALSE);
+            }
+            else {
+                xAvailable = (prvIsQueueEmpty(pxQueue) == pdFALSE);
+            }
+
+            if (xAvailable == pdFALSE) {
+                if (xReserve != pdFALSE) {
+                    traceBLOCKING_ON_QUEUE_SEND(pxQueue);
+                    vTaskPlaceOnEventList(&(pxQueue->xTasksWaitingToSend),
+                                          xTicksToWait);
+                }
+                else {
+                    traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue);
+                    vTaskPlaceOnEventList(&(pxQueue->xTasksWaitingToReceive),
+                                          xTicksToWait);
+                }
+                prvUnlockQueue(pxQueue);
+                if (xTaskResumeAll() == pdFALSE) {
+                    portYIELD_WITHIN_API();
+                }
+                else {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else {
+                /* Try again. */
+                prvUnlockQueue(pxQueue);
+                (void)xTaskResumeAll();
+            }
+        }
+        else {
+            /* The timeout has expired. */
+            prvUnlockQueue(pxQueue);
+            (void)xTaskResumeAll();
+            break;
+        }
+    }
+
+    *ppvSlot = NULL;
+
+    if (xReserve != pdFALSE) {
+        traceQUEUE_SEND_FAILED(pxQueue);
+        return errQUEUE_FULL;
+    }
+
+    traceQUEUE_RECEIVE_FAILED(pxQueue);
+    return errQUEUE_EMPTY;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvUnblockAll(List_t *const pxEventList)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    while (listLIST_IS_EMPTY(pxEventList) == pdFALSE) {
+        if (xTaskRemoveFromEventList(pxEventList) != pdFALSE) {
+            xHigherPriorityTaskWoken = pdTRUE;
+        }
+        else {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+    return xHigherPriorityTaskWoken;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueReserve(QueueHandle_t xQueue, void **const ppvSlot,
+                         TickType_t xTicksToWait)
+{
+    Queue_t *const pxQueue = (Queue_t *)xQueue;
+
+    configASSERT(pxQueue);
+    configASSERT(ppvSlot);
+    configASSERT(pxQueue->uxItemSize != (UBaseType_t)0U);
+#if ((INCLUDE_xTaskGetSchedulerState == 1) || (configUSE_TIMERS == 1))
+    {
+        configASSERT(!(
+                         (xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED) &&
+                         (xTicksToWait != 0)));
+    }
+#endif
+
+    return prvTakeSlot(pxQueue, ppvSlot, xTicksToWait, pdTRUE);
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueCommit(QueueHandle_t xQueue)
+{
+    BaseType_t xYieldRequired = pdFALSE;
+    Queue_t *const pxQueue = (Queue_t *)xQueue;
+
+    configASSERT(pxQueue);
+
+    taskENTER_CRITICAL();
+    {
+        configASSERT(pxQueue->pcReserved != NULL);
+        if (pxQueue->pcReserved == NULL) {
+            taskEXIT_CRITICAL();
+            return pdFAIL;
+        }
+
+        traceQUEUE_SEND(pxQueue);
+
+        /* The item was written in place, only the write position moves on. */
+        pxQueue->pcWriteTo += pxQueue->uxItemSize;
+        if (pxQueue->pcWriteTo >= pxQueue->pcTail) { /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
+            pxQueue->pcWriteTo = pxQueue->pcHead;
+        }
+        else {
+            mtCOVERAGE_TEST_MARKER();
+        }
+        pxQueue->pcReserved = NULL;
+        pxQueue->uxMessagesWaiting++;
+
+#if (configUSE_QUEUE_SETS == 1)
+        {
+            if (pxQueue->pxQueueSetContainer != NULL) {
+                xYieldRequired = prvNotifyQueueSetContainer(pxQueue,
+                                 queueSEND_TO_BACK);
+            }
+            else if (listLIST_IS_EMPTY(&(pxQueue->xTasksWaitingToReceive)) ==
+                     pdFALSE) {
+                xYieldRequired = xTaskRemoveFromEventList(
+                                     &(pxQueue->xTasksWaitingToReceive));
+            }
+            else {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+#else /* configUSE_QUEUE_SETS */
+        {
+            if (listLIST_IS_EMPTY(&(pxQueue->xTasksWaitingToReceive)) ==
+                pdFALSE) {
+                xYieldRequired = xTaskRemoveFromEventList(
+                                     &(pxQueue->xTasksWaitingToReceive));
+            }
+            else {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+#endif /* configUSE_QUEUE_SETS */
+
+        /* Senders found the back of the queue taken while the slot was
+        reserved, those that still fit may go ahead now. */
+        if (pxQueue->uxMessagesWaiting < pxQueue->uxLength) {
+            if (prvUnblockAll(&(pxQueue->xTasksWaitingToSend)) != pdFALSE) {
+                xYieldRequired = pdTRUE;
+            }
+            else {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if (xYieldRequired != pdFALSE) {
+            queueYIELD_IF_USING_PREEMPTION();
+        }
+        else {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueBorrow(QueueHandle_t xQueue, void **const ppvSlot,
+                        TickType_t xTicksToWait)
+{
+    Queue_t *const pxQueue = (Queue_t *)xQueue;
+
+    configASSERT(pxQueue);
+    configASSERT(ppvSlot);
+    configASSERT(pxQueue->uxItemSize != (UBaseType_t)0U);
+#if ((INCLUDE_xTaskGetSchedulerState == 1) || (configUSE_TIMERS == 1))
+    {
+        configASSERT(!(
+                         (xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED) &&
+                         (xTicksToWait != 0)));
+    }
+#endif
+
+    return prvTakeSlot(pxQueue, ppvSlot, xTicksToWait, pdFALSE);
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueRelease(QueueHandle_t xQueue)
+{
+    BaseType_t xYieldRequired = pdFALSE;
+    Queue_t *const pxQueue = (Queue_t *)xQueue;
+
+    configASSERT(pxQueue);
+
+    taskENTER_CRITICAL();
+    {
+        configASSERT(pxQueue->pcBorrowed != NULL);
+        if (pxQueue->pcBorrowed == NULL) {
+            taskEXIT_CRITICAL();
+            return pdFAIL;
+        }
+
+        /* The item is only now removed from the queue. */
+        pxQueue->u.pcReadFrom = pxQueue->pcBorrowed;
+        pxQueue->pcBorrowed = NULL;
+        pxQueue->uxMessagesWaiting--;
+
+        /* The slot is free for senders, and receivers that found the front of
+        the queue taken may go ahead if there is more to read. */
+        if (prvUnblockAll(&(pxQueue->xTasksWaitingToSend)) != pdFALSE) {
+            xYieldRequired = pdTRUE;
+        }
+        else {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if (pxQueue->uxMessagesWaiting > (UBaseType_t)0) {
+            if (prvUnblockAll(&(pxQueue->xTasksWaitingToReceive)) != pdFALSE) {
+                xYieldRequired = pdTRUE;
+            }
+            else {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if (xYieldRequired != pdFALSE) {
+            queueYIELD_IF_USING_PREEMPTION();
+        }
+        else {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return pdPASS;
+}
+
+#endif /* configUSE_QUEUE_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
 UBaseType_t uxQueueMessagesWaiting(const QueueHandle_t xQueue)
 {
     UBaseType_t uxReturn;
@@ -1946,7 +2319,7 @@ static BaseType_t prvIsQueueEmpty(const Queue_t *pxQueue)
 
     taskENTER_CRITICAL();
     {
-        if (pxQueue->uxMessagesWaiting == (UBaseType_t)0) {
+        if (!prvCanReceiveFromQueue(pxQueue)) {
             xReturn = pdTRUE;
         }
         else {
@@ -1975,13 +2348,14 @@ BaseType_t xQueueIsQueueEmptyFromISR(const QueueHandle_t xQueue)
 } /*lint !e818 xQueue could not be pointer to const because it is a typedef. */
 /*-----------------------------------------------------------*/
 
-static BaseType_t prvIsQueueFull(const Queue_t *pxQueue)
+static BaseType_t prvIsQueueFull(const Queue_t *pxQueue,
+                                 const BaseType_t xPosition)
 {
     BaseType_t xReturn;
 
     taskENTER_CRITICAL();
     {
-        if (pxQueue->uxMessagesWaiting == pxQueue->uxLength) {
+        if (!prvCanSendToQueue(pxQueue, xPosition)) {
             xReturn = pdTRUE;
         }
         else {
@@ -2024,7 +2398,7 @@ BaseType_t xQueueCRSend(QueueHandle_t xQueue, const void *pvItemToQueue,
         between the check to see if the queue is full and blocking on the queue. */
     portDISABLE_INTERRUPTS();
     {
-        if (prvIsQueueFull(pxQueue) != pdFALSE) {
+        if (prvIsQueueFull(pxQueue, queueSEND_TO_BACK) != pdFALSE) {
             /* The queue is full - do we want to block or just leave without
                 posting? */
             if (xTicksToWait > (TickType_t)0) {
@@ -2532,7 +2906,7 @@ static BaseType_t prvNotifyQueueSetContainer(const Queue_t *const pxQueue,
         pxQueueSetContainer->uxLength) {
         const int8_t cTxLock = pxQueueSetContainer->cTxLock;
 
-        traceQUEUE_SEND(pxQueueSetContainer);
+        traceQUEUE_SET_SEND(pxQueueSetContainer);
 
         /* The data copied is the handle of the queue that contains data. */
         xReturn = prvCopyDataToQueue(pxQueueSetContainer, &pxQueue,
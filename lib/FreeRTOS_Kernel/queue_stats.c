@@ -0,0 +1,506 @@
+/*
+    FreeRTOS V9.0.0 - Copyright (C) 2016 Real Time Engineers Ltd.
+    All rights reserved
+
+    VISIT http://www.FreeRTOS.org TO ENSURE YOU ARE USING THE LATEST VERSION.
+
+    This file is part of the FreeRTOS distribution.
+
+    FreeRTOS is free software; you can redistribute it and/or modify it under
+    the terms of the GNU General Public License (version 2) as published by the
+    Free Software Foundation >>>> AND MODIFIED BY <<<< the FreeRTOS exception.
+
+    ***************************************************************************
+    >>!   NOTE: The modification to the GPL is included to allow you to     !<<
+    >>!   distribute a combined work that includes FreeRTOS without being   !<<
+    >>!   obliged to provide the source code for proprietary components     !<<
+    >>!   outside of the FreeRTOS kernel.                                   !<<
+    ***************************************************************************
+
+    FreeRTOS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  Full license text is available on the following
+    link: http://www.freertos.org/a00114.html
+
+    ***************************************************************************
+     *                                                                       *
+     *    FreeRTOS provides completely free yet professionally developed,    *
+     *    robust, strictly quality controlled, supported, and cross          *
+     *    platform software that is more than just the market leader, it     *
+     *    is the industry's de facto standard.                               *
+     *                                                                       *
+     *    Help yourself get started quickly while simultaneously helping     *
+     *    to support the FreeRTOS project by purchasing a FreeRTOS           *
+     *    tutorial book, reference manual, or both:                          *
+     *    http://www.FreeRTOS.org/Documentation                              *
+     *                                                                       *
+    ***************************************************************************
+
+    http://www.FreeRTOS.org/FAQHelp.html - Having a problem?  Start by reading
+    the FAQ page "My application does not run, what could be wrong?".  Have you
+    defined configASSERT()?
+
+    http://www.FreeRTOS.org/support - In return for receiving this top quality
+    embedded software for free we request you assist our global community by
+    participating in the support forum.
+
+    http://www.FreeRTOS.org/training - Investing in training allows your team to
+    be as productive as possible as early as possible.  Now you can receive
+    FreeRTOS training directly from Richard Barry, CEO of Real Time Engineers
+    Ltd, and the world's leading authority on the world's leading RTOS.
+
+    http://www.FreeRTOS.org/plus - A selection of FreeRTOS ecosystem products,
+    including FreeRTOS+Trace - an indispensable productivity tool, a DOS
+    compatible FAT file system, and our tiny thread aware UDP/IP stack.
+
+    http://www.FreeRTOS.org/labs - Where new FreeRTOS products go to incubate.
+    Come and try FreeRTOS+TCP, our new open source TCP/IP stack for FreeRTOS.
+
+    http://www.OpenRTOS.com - Real Time Engineers ltd. license FreeRTOS to High
+    Integrity Systems ltd. to sell under the OpenRTOS brand.  Low cost OpenRTOS
+    licenses offer ticketed support, indemnification and commercial middleware.
+
+    http://www.SafeRTOS.com - High Integrity Systems also provide a safety
+    engineered and independently SIL3 certified version for use in safety and
+    mission critical applications that require provable dependability.
+
+    1 tab == 4 spaces!
+*/
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* Lint e961 and e750 are suppressed as a MISRA exception justified because the
+MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined for the
+header files above, but not in this file, in order to generate the correct
+privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750. */
+
+#if (configUSE_QUEUE_STATS == 1)
+
+/* Every queue, semaphore and mutex points to its own entry, NULL for objects
+created while all entries were in use.  An entry with a NULL handle is free. */
+static QueueStats_t xQueueStats[ configQUEUE_STATS_SIZE ];
+/*-----------------------------------------------------------*/
+
+/* Only the API functions look an entry up, the trace macros are handed the
+one the object points to. */
+static QueueStats_t *prvFindStats(QueueHandle_t xQueue)
+{
+    UBaseType_t ux;
+
+    for (ux = (UBaseType_t)0U; ux < (UBaseType_t)configQUEUE_STATS_SIZE; ux++) {
+        if (xQueueStats[ ux ].xHandle == xQueue) {
+            return &(xQueueStats[ ux ]);
+        }
+    }
+
+    return NULL;
+}
+/*-----------------------------------------------------------*/
+
+/* Ends the wait of the calling task if it was waiting on the object of
+pxStats, whether it got through or gave up. */
+static void prvEndWait(QueueStats_t *pxStats)
+{
+    QueueStatsWait_t *pxWait = pxTaskGetQueueStatsWait();
+    uint64_t ullBlockedTime, ullMicroseconds;
+    UBaseType_t uxBucket = 0;
+
+    if ((pxStats == NULL) || (pxWait->pxWaitingOn != pxStats)) {
+        return;
+    }
+    pxWait->pxWaitingOn = NULL;
+
+    ullBlockedTime = portQUEUE_STATS_TIME() - pxWait->ullWaitStart;
+    pxStats->ullBlockedTime += ullBlockedTime;
+    if (ullBlockedTime > pxStats->ullMaxBlockedTime) {
+        pxStats->ullMaxBlockedTime = ullBlockedTime;
+    }
+
+    for (ullMicroseconds = ullBlockedTime / 1000U;
+         (ullMicroseconds >= 2U) &&
+         (uxBucket < (UBaseType_t)(queueSTATS_HISTOGRAM_BUCKETS - 1));
+         ullMicroseconds >>= 1) {
+        uxBucket++;
+    }
+    pxStats->ulBlockedHistogram[ uxBucket ]++;
+}
+/*-----------------------------------------------------------*/
+
+struct xQUEUE_STATS *pxQueueStatsCreate(void *pvQueue, uint8_t ucQueueType)
+{
+    QueueStats_t *pxStats;
+
+    taskENTER_CRITICAL();
+    {
+        pxStats = prvFindStats(NULL);
+        if (pxStats != NULL) {
+            (void)memset(pxStats, 0x00, sizeof(QueueStats_t));
+            pxStats->xHandle = (QueueHandle_t)pvQueue;
+            pxStats->ucQueueType = ucQueueType;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return pxStats;
+}
+/*-----------------------------------------------------------*/
+
+void vQueueStatsDelete(struct xQUEUE_STATS *pxStats)
+{
+    if (pxStats == NULL) {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    {
+        pxStats->xHandle = NULL;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vQueueStatsBlock(struct xQUEUE_STATS *pxStats)
+{
+    QueueStatsWait_t *pxWait = pxTaskGetQueueStatsWait();
+
+    /* A task woken up without getting through blocks again on the same
+    wait. */
+    if ((pxStats == NULL) || (pxWait->pxWaitingOn == pxStats)) {
+        return;
+    }
+
+    pxWait->pxWaitingOn = pxStats;
+    pxWait->ullWaitStart = portQUEUE_STATS_TIME();
+
+    /* Only the scheduler is suspended here, interrupts still count. */
+    taskENTER_CRITICAL();
+    {
+        pxStats->ulWaits++;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vQueueStatsSend(struct xQUEUE_STATS *pxStats, UBaseType_t uxDepth,
+                     BaseType_t xFromISR)
+{
+    if (xFromISR == pdFALSE) {
+        prvEndWait(pxStats);
+        pxTaskGetQueueStatsWait()->pxLastSentTo = pxStats;
+    }
+
+    if (pxStats == NULL) {
+        return;
+    }
+
+    pxStats->ulSends++;
+    if (xFromISR != pdFALSE) {
+        pxStats->ulFromISR++;
+    }
+    if (uxDepth > pxStats->uxMaxDepth) {
+        pxStats->uxMaxDepth = uxDepth;
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vQueueStatsSetSend(struct xQUEUE_STATS *pxStats, UBaseType_t uxDepth)
+{
+    /* Counted like any other send, but it may come from a task or an
+    interrupt and neither was waiting on the set, so no wait is ended. */
+    if (pxStats == NULL) {
+        return;
+    }
+
+    pxStats->ulSends++;
+    if (uxDepth > pxStats->uxMaxDepth) {
+        pxStats->uxMaxDepth = uxDepth;
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vQueueStatsReceive(struct xQUEUE_STATS *pxStats, BaseType_t xPeek,
+                        BaseType_t xFromISR)
+{
+    if (pxStats == NULL) {
+        return;
+    }
+
+    if (xFromISR == pdFALSE) {
+        prvEndWait(pxStats);
+    }
+
+    if (xPeek != pdFALSE) {
+        pxStats->ulPeeks++;
+    }
+    else {
+        pxStats->ulReceives++;
+    }
+    if (xFromISR != pdFALSE) {
+        pxStats->ulFromISR++;
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vQueueStatsFailed(struct xQUEUE_STATS *pxStats, BaseType_t xSend,
+                       BaseType_t xFromISR)
+{
+    if (pxStats == NULL) {
+        return;
+    }
+
+    /* Tasks give up once they have left the critical section. */
+    if (xFromISR == pdFALSE) {
+        taskENTER_CRITICAL();
+        prvEndWait(pxStats);
+    }
+
+    if (xSend != pdFALSE) {
+        pxStats->ulSendsFailed++;
+    }
+    else {
+        pxStats->ulReceivesFailed++;
+    }
+    if (xFromISR != pdFALSE) {
+        pxStats->ulFromISR++;
+    }
+
+    if (xFromISR == pdFALSE) {
+        taskEXIT_CRITICAL();
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vQueueStatsPriorityInherit(void)
+{
+    QueueStats_t *pxStats = pxTaskGetQueueStatsWait()->pxWaitingOn;
+
+    if (pxStats != NULL) {
+        pxStats->ulPriorityInherits++;
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vQueueStatsPriorityDisinherit(void)
+{
+    QueueStats_t *pxStats = pxTaskGetQueueStatsWait()->pxLastSentTo;
+
+    if (pxStats != NULL) {
+        pxStats->ulPriorityDisinherits++;
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueGetStats(QueueHandle_t xQueue, QueueStats_t *pxStats)
+{
+    QueueStats_t *pxEntry;
+    BaseType_t xReturn = pdFAIL;
+
+    configASSERT(xQueue);
+    configASSERT(pxStats);
+
+    taskENTER_CRITICAL();
+    {
+        pxEntry = prvFindStats(xQueue);
+        if (pxEntry != NULL) {
+            *pxStats = *pxEntry;
+            xReturn = pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if (xReturn == pdPASS) {
+#if (configQUEUE_REGISTRY_SIZE > 0)
+        {
+            pxStats->pcName = pcQueueGetName(xQueue);
+        }
+#else
+        {
+            pxStats->pcName = NULL;
+        }
+#endif
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxQueueGetAllStats(QueueStats_t *const pxStatsArray,
+                               const UBaseType_t uxArraySize)
+{
+    UBaseType_t ux, uxFilled = (UBaseType_t)0U;
+
+    for (ux = (UBaseType_t)0U; (ux < (UBaseType_t)configQUEUE_STATS_SIZE) &&
+         (uxFilled < uxArraySize); ux++) {
+        taskENTER_CRITICAL();
+        {
+            pxStatsArray[ uxFilled ] = xQueueStats[ ux ];
+        }
+        taskEXIT_CRITICAL();
+
+        if (pxStatsArray[ uxFilled ].xHandle == NULL) {
+            continue;
+        }
+
+#if (configQUEUE_REGISTRY_SIZE > 0)
+        {
+            pxStatsArray[ uxFilled ].pcName =
+                pcQueueGetName(pxStatsArray[ uxFilled ].xHandle);
+        }
+#else
+        {
+            pxStatsArray[ uxFilled ].pcName = NULL;
+        }
+#endif
+        uxFilled++;
+    }
+
+    return uxFilled;
+}
+/*-----------------------------------------------------------*/
+
+void vQueueResetStats(QueueHandle_t xQueue)
+{
+    QueueHandle_t xHandle;
+    uint8_t ucQueueType;
+    UBaseType_t ux;
+
+    taskENTER_CRITICAL();
+    {
+        for (ux = (UBaseType_t)0U; ux < (UBaseType_t)configQUEUE_STATS_SIZE;
+             ux++) {
+            xHandle = xQueueStats[ ux ].xHandle;
+            if ((xHandle == NULL) || ((xQueue != NULL) && (xHandle != xQueue))) {
+                continue;
+            }
+
+            ucQueueType = xQueueStats[ ux ].ucQueueType;
+            (void)memset(&(xQueueStats[ ux ]), 0x00, sizeof(QueueStats_t));
+            xQueueStats[ ux ].xHandle = xHandle;
+            xQueueStats[ ux ].ucQueueType = ucQueueType;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+#if (configUSE_STATS_FORMATTING_FUNCTIONS > 0)
+
+static const char *prvQueueTypeName(uint8_t ucQueueType)
+{
+    switch (ucQueueType) {
+        case queueQUEUE_TYPE_MUTEX:
+            return "mutex";
+
+        case queueQUEUE_TYPE_RECURSIVE_MUTEX:
+            return "recmutex";
+
+        case queueQUEUE_TYPE_COUNTING_SEMAPHORE:
+            return "counting";
+
+        case queueQUEUE_TYPE_BINARY_SEMAPHORE:
+            return "binary";
+
+        default:
+            return "queue";
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vQueueGetStatsList(char *pcWriteBuffer, size_t xBufferLength)
+{
+    QueueStats_t xStats;
+    char cName[ configMAX_TASK_NAME_LEN + 1 ];
+    uint32_t ulFailed, ulEnded;
+    uint64_t ullAverage;
+    size_t xWritten = 0;
+    int iLength;
+    UBaseType_t ux, uxBucket;
+
+    /*
+     * Like vTaskList() this is provided for convenience only, one line per
+     * object:
+     *
+     * name  type  sends  receives+peeks  failed  ISR  waits  max depth
+     * average wait us  max wait us  inherits
+     */
+
+    if (xBufferLength == 0U) {
+        return;
+    }
+    *pcWriteBuffer = 0x00;
+
+    for (ux = (UBaseType_t)0U; ux < (UBaseType_t)configQUEUE_STATS_SIZE;
+         ux++) {
+        taskENTER_CRITICAL();
+        {
+            xStats = xQueueStats[ ux ];
+        }
+        taskEXIT_CRITICAL();
+
+        if (xStats.xHandle == NULL) {
+            continue;
+        }
+
+        xStats.pcName = NULL;
+#if (configQUEUE_REGISTRY_SIZE > 0)
+        {
+            xStats.pcName = pcQueueGetName(xStats.xHandle);
+        }
+#endif
+        if (xStats.pcName != NULL) {
+            (void)snprintf(cName, sizeof(cName), "%s", xStats.pcName);
+        }
+        else {
+            (void)snprintf(cName, sizeof(cName), "%p",
+                           (void *)xStats.xHandle);
+        }
+
+        ulFailed = xStats.ulSendsFailed + xStats.ulReceivesFailed;
+        /* Waits still going on are not in the blocked time yet. */
+        ulEnded = 0;
+        for (uxBucket = (UBaseType_t)0U;
+             uxBucket < (UBaseType_t)queueSTATS_HISTOGRAM_BUCKETS; uxBucket++) {
+            ulEnded += xStats.ulBlockedHistogram[ uxBucket ];
+        }
+        ullAverage = 0;
+        if (ulEnded > 0U) {
+            ullAverage = xStats.ullBlockedTime / ulEnded;
+        }
+
+        iLength = snprintf(pcWriteBuffer + xWritten, xBufferLength - xWritten,
+                           "%-*s\t%s\t%u\t%u\t%u\t%u\t%u\t%u\t%llu\t%llu\t%u\r\n",
+                           configMAX_TASK_NAME_LEN, cName,
+                           prvQueueTypeName(xStats.ucQueueType),
+                           (unsigned int)xStats.ulSends,
+                           (unsigned int)(xStats.ulReceives + xStats.ulPeeks),
+                           (unsigned int)ulFailed,
+                           (unsigned int)xStats.ulFromISR,
+                           (unsigned int)xStats.ulWaits,
+                           (unsigned int)xStats.uxMaxDepth,
+                           (unsigned long long)(ullAverage / 1000U),
+                           (unsigned long long)(xStats.ullMaxBlockedTime / 1000U),
+                           (unsigned int)xStats.ulPriorityInherits);
+        if ((iLength < 0) || ((size_t)iLength >= xBufferLength - xWritten)) {
+            /* Cut short at the last whole line. */
+            pcWriteBuffer[ xWritten ] = 0x00;
+            break;
+        }
+        xWritten += (size_t)iLength;
+    }
+}
+
+#endif /* configUSE_STATS_FORMATTING_FUNCTIONS */
+
+#endif /* configUSE_QUEUE_STATS */
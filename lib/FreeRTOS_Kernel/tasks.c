@@ -106,6 +106,15 @@ performed just because a higher priority task has been woken. */
 #define taskYIELD_IF_USING_PREEMPTION() portYIELD_WITHIN_API()
 #endif
 
+#if ( configNUMBER_OF_CORES > 1 )
+/* Value of the xTaskRunState member of the TCB while the task is not running,
+otherwise it holds the core the task runs on. */
+#define taskTASK_NOT_RUNNING            ( ( BaseType_t ) -1 )
+#define taskTASK_IS_RUNNING( pxTCB )    ( ( pxTCB )->xTaskRunState != taskTASK_NOT_RUNNING )
+#else
+#define taskTASK_IS_RUNNING( pxTCB )    ( ( pxTCB ) == pxCurrentTCB )
+#endif
+
 /* Values that can be assigned to the ucNotifyState member of the TCB. */
 #define taskNOT_WAITING_NOTIFICATION    ( ( uint8_t ) 0 )
 #define taskWAITING_NOTIFICATION        ( ( uint8_t ) 1 )
@@ -171,6 +180,14 @@ state task. */
 
 /*-----------------------------------------------------------*/
 
+#if ( configNUMBER_OF_CORES > 1 )
+
+/* Each core picks from the tasks that are not running on another core, see
+prvSelectHighestPriorityTask(). */
+#define taskSELECT_HIGHEST_PRIORITY_TASK() prvSelectHighestPriorityTask( portGET_CORE_ID() )
+
+#else /* configNUMBER_OF_CORES */
+
 #define taskSELECT_HIGHEST_PRIORITY_TASK()                                                          \
     {                                                                                                   \
         UBaseType_t uxTopPriority = uxTopReadyPriority;                                                     \
@@ -188,6 +205,8 @@ state task. */
         uxTopReadyPriority = uxTopPriority;                                                             \
     } /* taskSELECT_HIGHEST_PRIORITY_TASK */
 
+#endif /* configNUMBER_OF_CORES */
+
 /*-----------------------------------------------------------*/
 
 /* Define away taskRESET_READY_PRIORITY() and portRESET_READY_PRIORITY() as
@@ -207,6 +226,14 @@ architecture being used. */
 
 /*-----------------------------------------------------------*/
 
+#if ( configNUMBER_OF_CORES > 1 )
+
+/* The bitmap gives the highest ready priority to start from, see
+prvSelectHighestPriorityTask(). */
+#define taskSELECT_HIGHEST_PRIORITY_TASK() prvSelectHighestPriorityTask( portGET_CORE_ID() )
+
+#else /* configNUMBER_OF_CORES */
+
 #define taskSELECT_HIGHEST_PRIORITY_TASK()                                                      \
     {                                                                                               \
         UBaseType_t uxTopPriority;                                                                      \
@@ -217,6 +244,8 @@ architecture being used. */
         listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCB, &( pxReadyTasksLists[ uxTopPriority ] ) );       \
     } /* taskSELECT_HIGHEST_PRIORITY_TASK() */
 
+#endif /* configNUMBER_OF_CORES */
+
 /*-----------------------------------------------------------*/
 
 /* A port optimised version is provided, call it only if the TCB being reset
@@ -234,6 +263,19 @@ or suspended list then it won't be in a ready list. */
 
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+
+/* The timing wheel files delayed tasks by wake time modulo the tick count
+range, so nothing moves when the tick count overflows.  Only the time of the
+next unblock has to be worked out again for the new range. */
+#define taskSWITCH_DELAYED_LISTS()                                                                  \
+    {                                                                                                   \
+        xNumOfOverflows++;                                                                              \
+        prvResetNextTaskUnblockTime();                                                                  \
+    }
+
+#else
+
 /* pxDelayedTaskList and pxOverflowDelayedTaskList are switched when the tick
 count overflows. */
 #define taskSWITCH_DELAYED_LISTS()                                                                  \
@@ -250,8 +292,19 @@ count overflows. */
         prvResetNextTaskUnblockTime();                                                                  \
     }
 
+#endif /* configUSE_DELAYED_TASK_WHEEL */
 /*-----------------------------------------------------------*/
 
+/*
+ * With more than one core, a task made ready may preempt the task running on
+ * any of the cores it is allowed on, not just the calling one.
+ */
+#if ( configNUMBER_OF_CORES > 1 )
+#define taskYIELD_FOR_TASK( pxTCB ) prvYieldForTask( pxTCB )
+#else
+#define taskYIELD_FOR_TASK( pxTCB )
+#endif
+
 /*
  * Place the task represented by pxTCB into the appropriate ready list for
  * the task.  It is inserted at the end of the list.
@@ -260,6 +313,7 @@ count overflows. */
     traceMOVED_TASK_TO_READY_STATE( pxTCB );                                                        \
     taskRECORD_READY_PRIORITY( ( pxTCB )->uxPriority );                                             \
     vListInsertEnd( &( pxReadyTasksLists[ ( pxTCB )->uxPriority ] ), &( ( pxTCB )->xStateListItem ) ); \
+    taskYIELD_FOR_TASK( pxTCB );                                                                    \
     tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB )
 /*-----------------------------------------------------------*/
 
@@ -330,7 +384,7 @@ typedef struct tskTaskControlBlock {
 #endif
 
 #if( configGENERATE_RUN_TIME_STATS == 1 )
-    uint32_t        ulRunTimeCounter;   /*< Stores the amount of time the task has spent in the Running state. */
+    configRUN_TIME_COUNTER_TYPE ulRunTimeCounter;   /*< Stores the amount of time the task has spent in the Running state. */
 #endif
 
 #if ( configUSE_NEWLIB_REENTRANT == 1 )
@@ -359,6 +413,15 @@ typedef struct tskTaskControlBlock {
     uint8_t ucDelayAborted;
 #endif
 
+#if( configUSE_QUEUE_STATS == 1 )
+    QueueStatsWait_t xQueueStatsWait;   /*< The wait on a queue, semaphore or mutex the task is in, see queue_stats.c. */
+#endif
+
+#if( configNUMBER_OF_CORES > 1 )
+    volatile BaseType_t xTaskRunState;  /*< The core the task runs on, or taskTASK_NOT_RUNNING. */
+    UBaseType_t     uxCoreAffinityMask; /*< Bit n set allows the task to run on core n. */
+#endif
+
 } tskTCB;
 
 /* The old tskTCB name is maintained above then typedefed to the new TCB_t name
@@ -368,14 +431,62 @@ typedef tskTCB TCB_t;
 /*lint -e956 A manual analysis and inspection has been used to determine which
 static variables must be declared volatile. */
 
+#if ( configNUMBER_OF_CORES > 1 )
+/* Every core has a task of its own running, the macro refers to the calling
+core's. */
+PRIVILEGED_DATA TCB_t *volatile pxCurrentTCBs[ configNUMBER_OF_CORES ];
+#define pxCurrentTCB pxCurrentTCBs[ portGET_CORE_ID() ]
+#else
 PRIVILEGED_DATA TCB_t *volatile pxCurrentTCB = NULL;
+#endif
 
 /* Lists for ready and blocked tasks. --------------------*/
 PRIVILEGED_DATA static List_t pxReadyTasksLists[ configMAX_PRIORITIES ];/*< Prioritised ready tasks. */
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+
+/* Delayed tasks are filed in one of taskWHEEL_SLOTS slots per level by their
+wake time, each level covering taskWHEEL_SLOTS times the ticks of the one
+below.  A task moves down a level when the wheel reaches its slot and is
+unblocked from level 0, so blocking and unblocking a task takes the same time
+however many tasks are delayed. */
+#define taskWHEEL_SLOT_BITS     5U
+#define taskWHEEL_SLOTS         ( 1U << taskWHEEL_SLOT_BITS )
+#define taskWHEEL_SLOT_MASK     ( taskWHEEL_SLOTS - 1U )
+#define taskWHEEL_LEVELS        ( ( ( sizeof( TickType_t ) * 8U ) + taskWHEEL_SLOT_BITS - 1U ) / taskWHEEL_SLOT_BITS )
+
+PRIVILEGED_DATA static List_t xDelayedTaskWheel[ taskWHEEL_LEVELS ][ taskWHEEL_SLOTS ];   /*< Delayed tasks, by wake time. */
+PRIVILEGED_DATA static uint32_t ulDelayedTaskSlotsInUse[ taskWHEEL_LEVELS ];           /*< A bit for each slot tasks were added to, cleared once the slot is found empty. */
+PRIVILEGED_DATA static TickType_t xDelayedTaskWheelTime = (TickType_t) 0U;             /*< The tick the wheel has been turned to, the slots of later ticks are still to come. */
+
+#define taskLIST_IS_DELAYED( pxList ) ( ( ( pxList ) >= &( xDelayedTaskWheel[ 0 ][ 0 ] ) ) && ( ( pxList ) <= &( xDelayedTaskWheel[ taskWHEEL_LEVELS - 1U ][ taskWHEEL_SLOTS - 1U ] ) ) )
+
+#ifndef portLOWEST_BIT
+/* Index of the lowest set bit of a non zero slot bitmap. */
+#define portLOWEST_BIT( ulBits )    prvLowestBit( ulBits )
+
+static UBaseType_t prvLowestBit(uint32_t ulBits)
+{
+    UBaseType_t uxBit = 0U;
+
+    while ((ulBits & 1U) == 0U) {
+        ulBits >>= 1U;
+        uxBit++;
+    }
+
+    return uxBit;
+}
+#endif /* portLOWEST_BIT */
+
+#else
+
 PRIVILEGED_DATA static List_t xDelayedTaskList1;                        /*< Delayed tasks. */
 PRIVILEGED_DATA static List_t xDelayedTaskList2;                        /*< Delayed tasks (two lists are used - one for delays that have overflowed the current tick count. */
 PRIVILEGED_DATA static List_t *volatile pxDelayedTaskList;              /*< Points to the delayed task list currently being used. */
 PRIVILEGED_DATA static List_t *volatile pxOverflowDelayedTaskList;      /*< Points to the delayed task list currently being used to hold tasks that have overflowed the current tick count. */
+
+#define taskLIST_IS_DELAYED( pxList ) ( ( ( pxList ) == pxDelayedTaskList ) || ( ( pxList ) == pxOverflowDelayedTaskList ) )
+
+#endif /* configUSE_DELAYED_TASK_WHEEL */
 PRIVILEGED_DATA static List_t xPendingReadyList;                        /*< Tasks that have been readied while the scheduler was suspended.  They will be moved to the ready list when the scheduler is resumed. */
 
 #if( INCLUDE_vTaskDelete == 1 )
@@ -397,7 +508,12 @@ PRIVILEGED_DATA static volatile TickType_t xTickCount               = (TickType_
 PRIVILEGED_DATA static volatile UBaseType_t uxTopReadyPriority      = tskIDLE_PRIORITY;
 PRIVILEGED_DATA static volatile BaseType_t xSchedulerRunning        = pdFALSE;
 PRIVILEGED_DATA static volatile UBaseType_t uxPendedTicks           = (UBaseType_t) 0U;
+#if ( configNUMBER_OF_CORES > 1 )
+PRIVILEGED_DATA static volatile BaseType_t xYieldPendings[ configNUMBER_OF_CORES ];
+#define xYieldPending xYieldPendings[ portGET_CORE_ID() ]
+#else
 PRIVILEGED_DATA static volatile BaseType_t xYieldPending            = pdFALSE;
+#endif
 PRIVILEGED_DATA static volatile BaseType_t xNumOfOverflows          = (BaseType_t) 0;
 PRIVILEGED_DATA static UBaseType_t uxTaskNumber                     = (UBaseType_t) 0U;
 PRIVILEGED_DATA static volatile TickType_t xNextTaskUnblockTime     = (TickType_t) 0U;   /* Initialised to portMAX_DELAY before the scheduler starts. */
@@ -415,9 +531,18 @@ PRIVILEGED_DATA static volatile UBaseType_t uxSchedulerSuspended    = (UBaseType
 
 #if ( configGENERATE_RUN_TIME_STATS == 1 )
 
-PRIVILEGED_DATA static uint32_t ulTaskSwitchedInTime = 0UL; /*< Holds the value of a timer/counter the last time a task was switched in. */
-PRIVILEGED_DATA static uint32_t ulTotalRunTime = 0UL;       /*< Holds the total amount of execution time as defined by the run time counter clock. */
+#if ( configNUMBER_OF_CORES > 1 )
+PRIVILEGED_DATA static configRUN_TIME_COUNTER_TYPE ulTaskSwitchedInTimes[ configNUMBER_OF_CORES ]; /*< Holds the value of each core's timer/counter the last time a task was switched in. */
+#define ulTaskSwitchedInTime ulTaskSwitchedInTimes[ portGET_CORE_ID() ]
+#else
+PRIVILEGED_DATA static configRUN_TIME_COUNTER_TYPE ulTaskSwitchedInTime = 0UL; /*< Holds the value of a timer/counter the last time a task was switched in. */
+#endif
+PRIVILEGED_DATA static configRUN_TIME_COUNTER_TYPE ulTotalRunTime = 0UL;       /*< Holds the total amount of execution time as defined by the run time counter clock. */
+
+#endif
 
+#if ( configUSE_QUEUE_STATS == 1 )
+PRIVILEGED_DATA static QueueStatsWait_t xNoTaskQueueStatsWait;  /*< Taken by queues used before the first task is created, which never wait. */
 #endif
 
 /*lint +e956 */
@@ -549,6 +674,55 @@ static TickType_t prvGetExpectedIdleTime(void) PRIVILEGED_FUNCTION;
  */
 static void prvResetNextTaskUnblockTime(void);
 
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+
+/*
+ * Files the task in the slot of the delayed task wheel its wake time falls in,
+ * and brings xNextTaskUnblockTime forward if the wheel has to be turned to the
+ * slot first.
+ */
+static void prvAddTaskToDelayedTaskWheel(TCB_t *const pxTCB) PRIVILEGED_FUNCTION;
+
+/*
+ * Files the list item in the slot of the delayed task wheel its value falls
+ * in, relative to the tick the wheel has been turned to.  Returns the tick the
+ * wheel has to be turned to for that slot, which above level 0 is the start of
+ * the slot.
+ */
+static TickType_t prvInsertInDelayedTaskWheel(ListItem_t *const pxStateListItem) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the next tick the delayed task wheel has to be turned to, setting
+ * *pxWheelWasEmpty to pdTRUE if no task is delayed.  Slots found empty, which
+ * a task left before it had to be unblocked, are cleared on the way.
+ */
+static TickType_t prvGetNextDelayedTaskWheelTime(BaseType_t *const pxWheelWasEmpty) PRIVILEGED_FUNCTION;
+
+/*
+ * Turns the delayed task wheel on to xTimeNow.  Tasks in the slots passed on
+ * the way move down a level or, on level 0, are unblocked.  Returns pdTRUE if
+ * an unblocked task should preempt the running one.
+ */
+static BaseType_t prvTurnDelayedTaskWheel(const TickType_t xTimeNow) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_DELAYED_TASK_WHEEL */
+
+#if ( configNUMBER_OF_CORES > 1 )
+
+/*
+ * Makes the highest priority ready task that may run on the core, and is not
+ * running on another one, the core's current task.
+ */
+static void prvSelectHighestPriorityTask(const BaseType_t xCoreID) PRIVILEGED_FUNCTION;
+
+/*
+ * Asks the core running the lowest priority task that pxTCB may preempt to
+ * switch tasks.  MUST BE CALLED FROM A CRITICAL SECTION.
+ */
+static void prvYieldForTask(const TCB_t *pxTCB) PRIVILEGED_FUNCTION;
+
+#endif
+
 #if ( ( configUSE_TRACE_FACILITY == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) )
 
 /*
@@ -692,7 +866,7 @@ BaseType_t xTaskCreate(TaskFunction_t pxTaskCode,
             /* Allocate space for the stack used by the task being created.
             The base of the stack memory stored in the TCB so the task can
             be deleted later if required. */
-            pxNewTCB->pxStack = (StackType_t *) pvPortMalloc((((size_t) usStackDepth) * sizeof(StackType_t)));             /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+            pxNewTCB->pxStack = (StackType_t *) pvPortMallocStack((((size_t) usStackDepth) * sizeof(StackType_t)));             /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
 
             if (pxNewTCB->pxStack == NULL) {
                 /* Could not allocate the stack.  Delete the allocated TCB. */
@@ -706,7 +880,7 @@ BaseType_t xTaskCreate(TaskFunction_t pxTaskCode,
         StackType_t *pxStack;
 
         /* Allocate space for the stack used by the task being created. */
-        pxStack = (StackType_t *) pvPortMalloc((((size_t) usStackDepth) * sizeof(StackType_t)));             /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+        pxStack = (StackType_t *) pvPortMallocStack((((size_t) usStackDepth) * sizeof(StackType_t)));             /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
 
         if (pxStack != NULL) {
             /* Allocate space for the TCB. */
@@ -719,7 +893,7 @@ BaseType_t xTaskCreate(TaskFunction_t pxTaskCode,
             else {
                 /* The stack cannot be used as the TCB was not created.  Free
                 it again. */
-                vPortFree(pxStack);
+                vPortFreeStack(pxStack);
             }
         }
         else {
@@ -912,17 +1086,64 @@ static void prvInitialiseNewTask(TaskFunction_t pxTaskCode,
     }
 #endif
 
+#if( configUSE_QUEUE_STATS == 1 )
+    {
+        pxNewTCB->xQueueStatsWait.pxWaitingOn = NULL;
+        pxNewTCB->xQueueStatsWait.pxLastSentTo = NULL;
+        pxNewTCB->xQueueStatsWait.ullWaitStart = 0U;
+    }
+#endif
+
+#if( configNUMBER_OF_CORES > 1 )
+    {
+        pxNewTCB->xTaskRunState = taskTASK_NOT_RUNNING;
+        pxNewTCB->uxCoreAffinityMask = tskNO_AFFINITY;
+    }
+#endif
+
     /* Initialize the TCB stack to look as if the task was already running,
     but had been interrupted by the scheduler.  The return address is set
     to the start of the task function. Once the stack has been initialised
     the top of stack variable is updated. */
 #if( portUSING_MPU_WRAPPERS == 1 )
     {
-        pxNewTCB->pxTopOfStack = pxPortInitialiseStack(pxTopOfStack, pxTaskCode, pvParameters, xRunPrivileged);
+#if( portHAS_STACK_OVERFLOW_CHECKING == 1 )
+        {
+#if( portSTACK_GROWTH < 0 )
+            {
+                pxNewTCB->pxTopOfStack = pxPortInitialiseStack(pxTopOfStack, pxNewTCB->pxStack, pxTaskCode, pvParameters, xRunPrivileged);
+            }
+#else /* portSTACK_GROWTH */
+            {
+                pxNewTCB->pxTopOfStack = pxPortInitialiseStack(pxTopOfStack, pxNewTCB->pxEndOfStack, pxTaskCode, pvParameters, xRunPrivileged);
+            }
+#endif /* portSTACK_GROWTH */
+        }
+#else /* portHAS_STACK_OVERFLOW_CHECKING */
+        {
+            pxNewTCB->pxTopOfStack = pxPortInitialiseStack(pxTopOfStack, pxTaskCode, pvParameters, xRunPrivileged);
+        }
+#endif /* portHAS_STACK_OVERFLOW_CHECKING */
     }
 #else /* portUSING_MPU_WRAPPERS */
     {
-        pxNewTCB->pxTopOfStack = pxPortInitialiseStack(pxTopOfStack, pxTaskCode, pvParameters);
+#if( portHAS_STACK_OVERFLOW_CHECKING == 1 )
+        {
+#if( portSTACK_GROWTH < 0 )
+            {
+                pxNewTCB->pxTopOfStack = pxPortInitialiseStack(pxTopOfStack, pxNewTCB->pxStack, pxTaskCode, pvParameters);
+            }
+#else /* portSTACK_GROWTH */
+            {
+                pxNewTCB->pxTopOfStack = pxPortInitialiseStack(pxTopOfStack, pxNewTCB->pxEndOfStack, pxTaskCode, pvParameters);
+            }
+#endif /* portSTACK_GROWTH */
+        }
+#else /* portHAS_STACK_OVERFLOW_CHECKING */
+        {
+            pxNewTCB->pxTopOfStack = pxPortInitialiseStack(pxTopOfStack, pxTaskCode, pvParameters);
+        }
+#endif /* portHAS_STACK_OVERFLOW_CHECKING */
     }
 #endif /* portUSING_MPU_WRAPPERS */
 
@@ -944,6 +1165,16 @@ static void prvAddNewTaskToReadyList(TCB_t *pxNewTCB)
     taskENTER_CRITICAL();
     {
         uxCurrentNumberOfTasks++;
+#if ( configNUMBER_OF_CORES > 1 )
+        /* The tasks each core starts with are picked once the scheduler is
+        started. */
+        if (uxCurrentNumberOfTasks == (UBaseType_t) 1) {
+            prvInitialiseTaskLists();
+        }
+        else {
+            mtCOVERAGE_TEST_MARKER();
+        }
+#else
         if (pxCurrentTCB == NULL) {
             /* There are no other tasks, or all the other tasks are in
             the suspended state - make this the current task. */
@@ -975,6 +1206,7 @@ static void prvAddNewTaskToReadyList(TCB_t *pxNewTCB)
                 mtCOVERAGE_TEST_MARKER();
             }
         }
+#endif /* configNUMBER_OF_CORES */
 
         uxTaskNumber++;
 
@@ -995,7 +1227,12 @@ static void prvAddNewTaskToReadyList(TCB_t *pxNewTCB)
     if (xSchedulerRunning != pdFALSE) {
         /* If the created task is of a higher priority than the current task
         then it should run now. */
-        if (pxCurrentTCB->uxPriority < pxNewTCB->uxPriority) {
+#if ( configNUMBER_OF_CORES > 1 )
+        if (xYieldPending != pdFALSE)
+#else
+        if (pxCurrentTCB->uxPriority < pxNewTCB->uxPriority)
+#endif
+        {
             taskYIELD_IF_USING_PREEMPTION();
         }
         else {
@@ -1042,7 +1279,7 @@ void vTaskDelete(TaskHandle_t xTaskToDelete)
         not return. */
         uxTaskNumber++;
 
-        if (pxTCB == pxCurrentTCB) {
+        if (taskTASK_IS_RUNNING(pxTCB)) {
             /* A task is deleting itself.  This cannot complete within the
             task itself, as a context switch to another task is required.
             Place the task in the termination list.  The idle task will
@@ -1061,6 +1298,19 @@ void vTaskDelete(TaskHandle_t xTaskToDelete)
             hence xYieldPending is used to latch that a context switch is
             required. */
             portPRE_TASK_DELETE_HOOK(pxTCB, &xYieldPending);
+
+#if ( configNUMBER_OF_CORES > 1 )
+            {
+                /* The task is running on another core, which has to switch
+                away from it before the idle task can free it. */
+                if (pxTCB->xTaskRunState != portGET_CORE_ID()) {
+                    portYIELD_CORE(pxTCB->xTaskRunState);
+                }
+                else {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+#endif
         }
         else {
             --uxCurrentNumberOfTasks;
@@ -1216,7 +1466,7 @@ eTaskState eTaskGetState(TaskHandle_t xTask)
 
     configASSERT(pxTCB);
 
-    if (pxTCB == pxCurrentTCB) {
+    if (taskTASK_IS_RUNNING(pxTCB)) {
         /* The task calling this function is querying its own state. */
         eReturn = eRunning;
     }
@@ -1227,7 +1477,7 @@ eTaskState eTaskGetState(TaskHandle_t xTask)
         }
         taskEXIT_CRITICAL();
 
-        if ((pxStateList == pxDelayedTaskList) || (pxStateList == pxOverflowDelayedTaskList)) {
+        if (taskLIST_IS_DELAYED(pxStateList)) {
             /* The task being queried is referenced from one of the Blocked
             lists. */
             eReturn = eBlocked;
@@ -1374,8 +1624,15 @@ void vTaskPrioritySet(TaskHandle_t xTask, UBaseType_t uxNewPriority)
                 if (pxTCB != pxCurrentTCB) {
                     /* The priority of a task other than the currently
                     running task is being raised.  Is the priority being
-                    raised above that of the running task? */
-                    if (uxNewPriority >= pxCurrentTCB->uxPriority) {
+                    raised above that of the running task?  With more than
+                    one core there is no running task until the scheduler
+                    has been started. */
+#if ( configNUMBER_OF_CORES > 1 )
+                    if ((xSchedulerRunning != pdFALSE) && (uxNewPriority >= pxCurrentTCB->uxPriority))
+#else
+                    if (uxNewPriority >= pxCurrentTCB->uxPriority)
+#endif
+                    {
                         xYieldRequired = pdTRUE;
                     }
                     else {
@@ -1394,6 +1651,12 @@ void vTaskPrioritySet(TaskHandle_t xTask, UBaseType_t uxNewPriority)
                 is ready to execute. */
                 xYieldRequired = pdTRUE;
             }
+#if ( configNUMBER_OF_CORES > 1 )
+            else if (taskTASK_IS_RUNNING(pxTCB)) {
+                /* Likewise for a task running on another core. */
+                portYIELD_CORE(pxTCB->xTaskRunState);
+            }
+#endif
             else {
                 /* Setting the priority of any other task down does not
                 require a yield as the running task must be above the
@@ -1475,6 +1738,65 @@ void vTaskPrioritySet(TaskHandle_t xTask, UBaseType_t uxNewPriority)
 #endif /* INCLUDE_vTaskPrioritySet */
 /*-----------------------------------------------------------*/
 
+#if ( configNUMBER_OF_CORES > 1 )
+
+void vTaskCoreAffinitySet(const TaskHandle_t xTask, UBaseType_t uxCoreAffinityMask)
+{
+    TCB_t *pxTCB;
+
+    taskENTER_CRITICAL();
+    {
+        pxTCB = prvGetTCBFromHandle(xTask);
+        pxTCB->uxCoreAffinityMask = uxCoreAffinityMask;
+
+        if (xSchedulerRunning != pdFALSE) {
+            if (taskTASK_IS_RUNNING(pxTCB)) {
+                /* Move the task off a core it may no longer run on. */
+                if ((uxCoreAffinityMask & ((UBaseType_t) 1 << pxTCB->xTaskRunState)) == (UBaseType_t) 0) {
+                    if (pxTCB->xTaskRunState == portGET_CORE_ID()) {
+                        xYieldPending = pdTRUE;
+                    }
+                    else {
+                        portYIELD_CORE(pxTCB->xTaskRunState);
+                    }
+                }
+                else {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else if (listIS_CONTAINED_WITHIN(&(pxReadyTasksLists[ pxTCB->uxPriority ]), &(pxTCB->xStateListItem)) != pdFALSE) {
+                /* The task may now preempt a core it was kept off. */
+                prvYieldForTask(pxTCB);
+            }
+            else {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if (xYieldPending != pdFALSE) {
+        taskYIELD_IF_USING_PREEMPTION();
+    }
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxTaskCoreAffinityGet(const TaskHandle_t xTask)
+{
+    UBaseType_t uxReturn;
+
+    taskENTER_CRITICAL();
+    {
+        uxReturn = prvGetTCBFromHandle(xTask)->uxCoreAffinityMask;
+    }
+    taskEXIT_CRITICAL();
+
+    return uxReturn;
+}
+
+#endif /* configNUMBER_OF_CORES */
+/*-----------------------------------------------------------*/
+
 #if ( INCLUDE_vTaskSuspend == 1 )
 
 void vTaskSuspend(TaskHandle_t xTaskToSuspend)
@@ -1507,6 +1829,19 @@ void vTaskSuspend(TaskHandle_t xTaskToSuspend)
         }
 
         vListInsertEnd(&xSuspendedTaskList, &(pxTCB->xStateListItem));
+
+#if ( configNUMBER_OF_CORES > 1 )
+        {
+            /* A task running on another core keeps running until that core
+            switches away from it. */
+            if ((taskTASK_IS_RUNNING(pxTCB)) && (pxTCB->xTaskRunState != portGET_CORE_ID())) {
+                portYIELD_CORE(pxTCB->xTaskRunState);
+            }
+            else {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+#endif
     }
     taskEXIT_CRITICAL();
 
@@ -1747,6 +2082,31 @@ void vTaskStartScheduler(void)
     }
 #endif /* configSUPPORT_STATIC_ALLOCATION */
 
+#if ( configNUMBER_OF_CORES > 1 )
+    {
+        /* One more idle task for each of the other cores, so that every core
+        always has a task to run.  They are named IDLE1, IDLE2 and so on. */
+        BaseType_t xCoreID;
+        char cIdleName[ configMAX_TASK_NAME_LEN ] = "IDLE";
+        size_t xDigit;
+
+        for (xCoreID = 1; (xCoreID < configNUMBER_OF_CORES) && (xReturn == pdPASS); xCoreID++) {
+            xDigit = 4;
+            if (xCoreID >= 10) {
+                cIdleName[ xDigit++ ] = (char)('0' + (xCoreID / 10) % 10);
+            }
+            cIdleName[ xDigit++ ] = (char)('0' + xCoreID % 10);
+            cIdleName[ xDigit ] = '\0';
+
+            xReturn = xTaskCreate(prvIdleTask,
+                                  cIdleName, configMINIMAL_STACK_SIZE,
+                                  (void *) NULL,
+                                  (tskIDLE_PRIORITY | portPRIVILEGE_BIT),
+                                  NULL);  /*lint !e961 MISRA exception, justified as it is not a redundant explicit cast to all supported compilers. */
+        }
+    }
+#endif /* configNUMBER_OF_CORES */
+
 #if ( configUSE_TIMERS == 1 )
     {
         if (xReturn == pdPASS) {
@@ -1774,6 +2134,17 @@ void vTaskStartScheduler(void)
         }
 #endif /* configUSE_NEWLIB_REENTRANT */
 
+#if ( configNUMBER_OF_CORES > 1 )
+        {
+            BaseType_t xCoreID;
+
+            /* Hand out the highest priority tasks, one core at a time. */
+            for (xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++) {
+                prvSelectHighestPriorityTask(xCoreID);
+            }
+        }
+#endif /* configNUMBER_OF_CORES */
+
         xNextTaskUnblockTime = portMAX_DELAY;
         xSchedulerRunning = pdTRUE;
         xTickCount = (TickType_t) 0U;
@@ -1819,6 +2190,15 @@ void vTaskEndScheduler(void)
 
 void vTaskSuspendAll(void)
 {
+#if ( configNUMBER_OF_CORES > 1 )
+    {
+        /* The other cores must not touch the task lists either, they wait
+        for the lock until xTaskResumeAll() releases it.  Interrupts on this
+        core remain enabled. */
+        portGET_TASK_LOCK();
+    }
+#endif
+
     /* A critical section is not required as the variable is of type
     BaseType_t.  Please read Richard Barry's reply in the following link to a
     post in the FreeRTOS support forum before reporting this as a bug! -
@@ -1846,14 +2226,14 @@ static TickType_t prvGetExpectedIdleTime(void)
     }
 #else
     {
-        const UBaseType_t uxLeastSignificantBit = (UBaseType_t) 0x01;
+        UBaseType_t uxTopPriority;
 
         /* When port optimised task selection is used the uxTopReadyPriority
-        variable is used as a bit map.  If bits other than the least
-        significant bit are set then there are tasks that have a priority
-        above the idle priority that are in the Ready state.  This takes
-        care of the case where the co-operative scheduler is in use. */
-        if (uxTopReadyPriority > uxLeastSignificantBit) {
+        variable is used as a bit map, which the port may spread over more
+        words than it, so ask the port for the highest ready priority.  This
+        takes care of the case where the co-operative scheduler is in use. */
+        portGET_HIGHEST_PRIORITY(uxTopPriority, uxTopReadyPriority);
+        if (uxTopPriority > tskIDLE_PRIORITY) {
             uxHigherPriorityReadyTasks = pdTRUE;
         }
     }
@@ -1902,6 +2282,13 @@ BaseType_t xTaskResumeAll(void)
     {
         --uxSchedulerSuspended;
 
+#if ( configNUMBER_OF_CORES > 1 )
+        {
+            /* The critical section holds on to the lock from here. */
+            portRELEASE_TASK_LOCK();
+        }
+#endif
+
         if (uxSchedulerSuspended == (UBaseType_t) pdFALSE) {
             if (uxCurrentNumberOfTasks > (UBaseType_t) 0U) {
                 /* Move any readied tasks from the pending list into the
@@ -2107,6 +2494,9 @@ TaskHandle_t xTaskGetHandle(const char *pcNameToQuery)   /*lint !e971 Unqualifie
 {
     UBaseType_t uxQueue = configMAX_PRIORITIES;
     TCB_t *pxTCB;
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+    UBaseType_t uxLevel, uxSlot;
+#endif
 
     /* Task names will be truncated to configMAX_TASK_NAME_LEN - 1 bytes. */
     configASSERT(strlen(pcNameToQuery) < configMAX_TASK_NAME_LEN);
@@ -2127,13 +2517,25 @@ TaskHandle_t xTaskGetHandle(const char *pcNameToQuery)   /*lint !e971 Unqualifie
         while (uxQueue > (UBaseType_t) tskIDLE_PRIORITY);      /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
 
         /* Search the delayed lists. */
-        if (pxTCB == NULL) {
-            pxTCB = prvSearchForNameWithinSingleList((List_t *) pxDelayedTaskList, pcNameToQuery);
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+        {
+            for (uxLevel = (UBaseType_t) 0U; (uxLevel < taskWHEEL_LEVELS) && (pxTCB == NULL); uxLevel++) {
+                for (uxSlot = (UBaseType_t) 0U; (uxSlot < taskWHEEL_SLOTS) && (pxTCB == NULL); uxSlot++) {
+                    pxTCB = prvSearchForNameWithinSingleList(&(xDelayedTaskWheel[ uxLevel ][ uxSlot ]), pcNameToQuery);
+                }
+            }
         }
+#else
+        {
+            if (pxTCB == NULL) {
+                pxTCB = prvSearchForNameWithinSingleList((List_t *) pxDelayedTaskList, pcNameToQuery);
+            }
 
-        if (pxTCB == NULL) {
-            pxTCB = prvSearchForNameWithinSingleList((List_t *) pxOverflowDelayedTaskList, pcNameToQuery);
+            if (pxTCB == NULL) {
+                pxTCB = prvSearchForNameWithinSingleList((List_t *) pxOverflowDelayedTaskList, pcNameToQuery);
+            }
         }
+#endif /* configUSE_DELAYED_TASK_WHEEL */
 
 #if ( INCLUDE_vTaskSuspend == 1 )
         {
@@ -2163,9 +2565,12 @@ TaskHandle_t xTaskGetHandle(const char *pcNameToQuery)   /*lint !e971 Unqualifie
 
 #if ( configUSE_TRACE_FACILITY == 1 )
 
-UBaseType_t uxTaskGetSystemState(TaskStatus_t *const pxTaskStatusArray, const UBaseType_t uxArraySize, uint32_t *const pulTotalRunTime)
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *const pxTaskStatusArray, const UBaseType_t uxArraySize, configRUN_TIME_COUNTER_TYPE *const pulTotalRunTime)
 {
     UBaseType_t uxTask = 0, uxQueue = configMAX_PRIORITIES;
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+    UBaseType_t uxLevel, uxSlot;
+#endif
 
     vTaskSuspendAll();
     {
@@ -2182,8 +2587,20 @@ UBaseType_t uxTaskGetSystemState(TaskStatus_t *const pxTaskStatusArray, const UB
 
             /* Fill in an TaskStatus_t structure with information on each
             task in the Blocked state. */
-            uxTask += prvListTasksWithinSingleList(&(pxTaskStatusArray[ uxTask ]), (List_t *) pxDelayedTaskList, eBlocked);
-            uxTask += prvListTasksWithinSingleList(&(pxTaskStatusArray[ uxTask ]), (List_t *) pxOverflowDelayedTaskList, eBlocked);
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+            {
+                for (uxLevel = (UBaseType_t) 0U; uxLevel < taskWHEEL_LEVELS; uxLevel++) {
+                    for (uxSlot = (UBaseType_t) 0U; uxSlot < taskWHEEL_SLOTS; uxSlot++) {
+                        uxTask += prvListTasksWithinSingleList(&(pxTaskStatusArray[ uxTask ]), &(xDelayedTaskWheel[ uxLevel ][ uxSlot ]), eBlocked);
+                    }
+                }
+            }
+#else
+            {
+                uxTask += prvListTasksWithinSingleList(&(pxTaskStatusArray[ uxTask ]), (List_t *) pxDelayedTaskList, eBlocked);
+                uxTask += prvListTasksWithinSingleList(&(pxTaskStatusArray[ uxTask ]), (List_t *) pxOverflowDelayedTaskList, eBlocked);
+            }
+#endif /* configUSE_DELAYED_TASK_WHEEL */
 
 #if( INCLUDE_vTaskDelete == 1 )
             {
@@ -2333,8 +2750,10 @@ BaseType_t xTaskAbortDelay(TaskHandle_t xTask)
 
 BaseType_t xTaskIncrementTick(void)
 {
+#if ( configUSE_DELAYED_TASK_WHEEL == 0 )
     TCB_t *pxTCB;
     TickType_t xItemValue;
+#endif
     BaseType_t xSwitchRequired = pdFALSE;
 
     /* Called by the portable layer each time a tick interrupt occurs.
@@ -2357,6 +2776,18 @@ BaseType_t xTaskIncrementTick(void)
             mtCOVERAGE_TEST_MARKER();
         }
 
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+        /* See if this tick has reached the next slot of the delayed task
+        wheel in use.  Turning the wheel unblocks the tasks whose wake
+        time has come and moves the others down towards level 0. */
+        if (xConstTickCount >= xNextTaskUnblockTime) {
+            xSwitchRequired = prvTurnDelayedTaskWheel(xConstTickCount);
+            prvResetNextTaskUnblockTime();
+        }
+        else {
+            mtCOVERAGE_TEST_MARKER();
+        }
+#else
         /* See if this tick has made a timeout expire.  Tasks are stored in
         the queue in the order of their wake time - meaning once one task
         has been found whose block time has not expired there is no need to
@@ -2428,18 +2859,48 @@ BaseType_t xTaskIncrementTick(void)
                 }
             }
         }
+#endif /* configUSE_DELAYED_TASK_WHEEL */
 
         /* Tasks of equal priority to the currently running task will share
         processing time (time slice) if preemption is on, and the application
         writer has not explicitly turned time slicing off. */
 #if ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) )
         {
+#if ( configNUMBER_OF_CORES > 1 )
+            BaseType_t xCoreID, xOtherCoreID;
+            UBaseType_t uxPriority, uxRunning;
+
+            /* Each core takes turns with the ready tasks of its priority
+            that no core is running. */
+            for (xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++) {
+                uxPriority = pxCurrentTCBs[ xCoreID ]->uxPriority;
+                uxRunning = 0;
+                for (xOtherCoreID = 0; xOtherCoreID < configNUMBER_OF_CORES; xOtherCoreID++) {
+                    if (pxCurrentTCBs[ xOtherCoreID ]->uxPriority == uxPriority) {
+                        uxRunning++;
+                    }
+                }
+
+                if (listCURRENT_LIST_LENGTH(&(pxReadyTasksLists[ uxPriority ])) > uxRunning) {
+                    if (xCoreID == portGET_CORE_ID()) {
+                        xSwitchRequired = pdTRUE;
+                    }
+                    else {
+                        portYIELD_CORE(xCoreID);
+                    }
+                }
+                else {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+#else
             if (listCURRENT_LIST_LENGTH(&(pxReadyTasksLists[ pxCurrentTCB->uxPriority ])) > (UBaseType_t) 1) {
                 xSwitchRequired = pdTRUE;
             }
             else {
                 mtCOVERAGE_TEST_MARKER();
             }
+#endif /* configNUMBER_OF_CORES */
         }
 #endif /* ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) ) */
 
@@ -2949,8 +3410,9 @@ static portTASK_FUNCTION(prvIdleTask, pvParameters)
             A critical region is not required here as we are just reading from
             the list, and an occasional incorrect value will not matter.  If
             the ready list at the idle priority contains more than one task
-            then a task other than the idle task is ready to execute. */
-            if (listCURRENT_LIST_LENGTH(&(pxReadyTasksLists[ tskIDLE_PRIORITY ])) > (UBaseType_t) 1) {
+            then a task other than the idle task is ready to execute.  There
+            is an idle task for each core. */
+            if (listCURRENT_LIST_LENGTH(&(pxReadyTasksLists[ tskIDLE_PRIORITY ])) > (UBaseType_t) configNUMBER_OF_CORES) {
                 taskYIELD();
             }
             else {
@@ -3111,8 +3573,23 @@ static void prvInitialiseTaskLists(void)
         vListInitialise(&(pxReadyTasksLists[ uxPriority ]));
     }
 
-    vListInitialise(&xDelayedTaskList1);
-    vListInitialise(&xDelayedTaskList2);
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+    {
+        UBaseType_t uxLevel, uxSlot;
+
+        for (uxLevel = (UBaseType_t) 0U; uxLevel < taskWHEEL_LEVELS; uxLevel++) {
+            for (uxSlot = (UBaseType_t) 0U; uxSlot < taskWHEEL_SLOTS; uxSlot++) {
+                vListInitialise(&(xDelayedTaskWheel[ uxLevel ][ uxSlot ]));
+            }
+            ulDelayedTaskSlotsInUse[ uxLevel ] = 0U;
+        }
+    }
+#else
+    {
+        vListInitialise(&xDelayedTaskList1);
+        vListInitialise(&xDelayedTaskList2);
+    }
+#endif /* configUSE_DELAYED_TASK_WHEEL */
     vListInitialise(&xPendingReadyList);
 
 #if ( INCLUDE_vTaskDelete == 1 )
@@ -3127,10 +3604,14 @@ static void prvInitialiseTaskLists(void)
     }
 #endif /* INCLUDE_vTaskSuspend */
 
-    /* Start with pxDelayedTaskList using list1 and the pxOverflowDelayedTaskList
-    using list2. */
-    pxDelayedTaskList = &xDelayedTaskList1;
-    pxOverflowDelayedTaskList = &xDelayedTaskList2;
+#if ( configUSE_DELAYED_TASK_WHEEL == 0 )
+    {
+        /* Start with pxDelayedTaskList using list1 and the
+        pxOverflowDelayedTaskList using list2. */
+        pxDelayedTaskList = &xDelayedTaskList1;
+        pxOverflowDelayedTaskList = &xDelayedTaskList2;
+    }
+#endif /* configUSE_DELAYED_TASK_WHEEL */
 }
 /*-----------------------------------------------------------*/
 
@@ -3157,13 +3638,40 @@ static void prvCheckTasksWaitingTermination(void)
 
                 taskENTER_CRITICAL();
                 {
+#if ( configNUMBER_OF_CORES > 1 )
+                    {
+                        const ListItem_t *pxItem;
+
+                        /* A task deleted while running on another core is
+                        only freed once that core has switched away from it. */
+                        pxTCB = NULL;
+                        for (pxItem = listGET_HEAD_ENTRY(&xTasksWaitingTermination);
+                             pxItem != listGET_END_MARKER(&xTasksWaitingTermination);
+                             pxItem = listGET_NEXT(pxItem)) {
+                            if (((TCB_t *) listGET_LIST_ITEM_OWNER(pxItem))->xTaskRunState == taskTASK_NOT_RUNNING) {
+                                pxTCB = (TCB_t *) listGET_LIST_ITEM_OWNER(pxItem);
+                                break;
+                            }
+                        }
+                    }
+
+                    if (pxTCB != NULL)
+#else
                     pxTCB = (TCB_t *) listGET_OWNER_OF_HEAD_ENTRY((&xTasksWaitingTermination));
-                    (void) uxListRemove(&(pxTCB->xStateListItem));
-                    --uxCurrentNumberOfTasks;
-                    --uxDeletedTasksWaitingCleanUp;
+#endif /* configNUMBER_OF_CORES */
+                    {
+                        (void) uxListRemove(&(pxTCB->xStateListItem));
+                        --uxCurrentNumberOfTasks;
+                        --uxDeletedTasksWaitingCleanUp;
+                    }
                 }
                 taskEXIT_CRITICAL();
 
+                if (pxTCB == NULL) {
+                    /* Still running, try again next time round. */
+                    break;
+                }
+
                 prvDeleteTCB(pxTCB);
             }
             else {
@@ -3357,7 +3865,7 @@ static void prvDeleteTCB(TCB_t *pxTCB)
     {
         /* The task can only have been allocated dynamically - free both
         the stack and TCB. */
-        vPortFree(pxTCB->pxStack);
+        vPortFreeStack(pxTCB->pxStack);
         vPortFree(pxTCB);
     }
 #elif( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE == 1 )
@@ -3368,7 +3876,7 @@ static void prvDeleteTCB(TCB_t *pxTCB)
         if (pxTCB->ucStaticallyAllocated == tskDYNAMICALLY_ALLOCATED_STACK_AND_TCB) {
             /* Both the stack and TCB were allocated dynamically, so both
             must be freed. */
-            vPortFree(pxTCB->pxStack);
+            vPortFreeStack(pxTCB->pxStack);
             vPortFree(pxTCB);
         }
         else if (pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_ONLY) {
@@ -3389,6 +3897,222 @@ static void prvDeleteTCB(TCB_t *pxTCB)
 #endif /* INCLUDE_vTaskDelete */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+
+static void prvResetNextTaskUnblockTime(void)
+{
+    TickType_t xNextTurnTime;
+    BaseType_t xWheelWasEmpty;
+
+    xNextTurnTime = prvGetNextDelayedTaskWheelTime(&xWheelWasEmpty);
+
+    if (xWheelWasEmpty != pdFALSE) {
+        /* No task is delayed.  Set xNextTaskUnblockTime to the maximum
+        possible value so it is extremely unlikely that the
+        if( xTickCount >= xNextTaskUnblockTime ) test will pass until a task
+        is delayed. */
+        xNextTaskUnblockTime = portMAX_DELAY;
+    }
+    else if ((TickType_t)(xNextTurnTime - xDelayedTaskWheelTime) <= (TickType_t)(xTickCount - xDelayedTaskWheelTime)) {
+        /* The tick count has just overflowed onto a slot in use, the wheel is
+        turned to it on this tick. */
+        xNextTaskUnblockTime = xTickCount;
+    }
+    else if (xNextTurnTime < xTickCount) {
+        /* The slot is only reached once the tick count has overflowed, when
+        xNextTaskUnblockTime is worked out again. */
+        xNextTaskUnblockTime = portMAX_DELAY;
+    }
+    else {
+        xNextTaskUnblockTime = xNextTurnTime;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddTaskToDelayedTaskWheel(TCB_t *const pxTCB)
+{
+    TickType_t xNextTurnTime;
+
+    /* Every slot up to the tick count has been turned to unless the tick
+    count has been stepped onto xNextTaskUnblockTime, so file the task
+    relative to the tick count where that is possible.  A lower level then
+    takes it straight to its wake time. */
+    if (xTickCount < xNextTaskUnblockTime) {
+        xDelayedTaskWheelTime = xTickCount;
+    }
+    else {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    xNextTurnTime = prvInsertInDelayedTaskWheel(&(pxTCB->xStateListItem));
+
+    /* If the wheel has to be turned to the task's slot before any other then
+    xNextTaskUnblockTime needs to be updated too.  A slot beyond the tick count
+    overflow is found once it has overflowed. */
+    if ((xNextTurnTime >= xTickCount) && (xNextTurnTime < xNextTaskUnblockTime)) {
+        xNextTaskUnblockTime = xNextTurnTime;
+    }
+    else {
+        mtCOVERAGE_TEST_MARKER();
+    }
+}
+/*-----------------------------------------------------------*/
+
+static TickType_t prvInsertInDelayedTaskWheel(ListItem_t *const pxStateListItem)
+{
+    const TickType_t xTimeToWake = listGET_LIST_ITEM_VALUE(pxStateListItem);
+    const TickType_t xTicksToWake = xTimeToWake - xDelayedTaskWheelTime;
+    UBaseType_t uxLevel = 0U, uxShift, uxSlot;
+
+    /* The lowest level whose slots, counted on from the wheel's current one,
+    reach the wake time. */
+    while ((uxLevel < (taskWHEEL_LEVELS - 1U)) && ((xTicksToWake >> ((uxLevel + 1U) * taskWHEEL_SLOT_BITS)) != (TickType_t) 0U)) {
+        uxLevel++;
+    }
+
+    uxShift = uxLevel * taskWHEEL_SLOT_BITS;
+    uxSlot = (UBaseType_t)(xTimeToWake >> uxShift) & taskWHEEL_SLOT_MASK;
+
+    vListInsertEnd(&(xDelayedTaskWheel[ uxLevel ][ uxSlot ]), pxStateListItem);
+    ulDelayedTaskSlotsInUse[ uxLevel ] |= (uint32_t) 1U << uxSlot;
+
+    return (TickType_t)((xTimeToWake >> uxShift) << uxShift);
+}
+/*-----------------------------------------------------------*/
+
+static TickType_t prvGetNextDelayedTaskWheelTime(BaseType_t *const pxWheelWasEmpty)
+{
+    TickType_t xTicksToSlot, xTicksToNextSlot = (TickType_t) 0U;
+    UBaseType_t uxLevel, uxShift, uxRotate, uxBit, uxSlot;
+    uint32_t ulSlots;
+
+    /* On each level the first slot in use after the wheel's current one is
+    the next the wheel has to turn to.  On level 0 that is a task's wake time,
+    above it the start of the slot, when its tasks move down.  Tasks leave
+    the wheel without clearing their slot's bit, so a slot is checked for
+    tasks before it counts. */
+    *pxWheelWasEmpty = pdTRUE;
+
+    for (uxLevel = 0U; uxLevel < taskWHEEL_LEVELS; uxLevel++) {
+        uxShift = uxLevel * taskWHEEL_SLOT_BITS;
+
+        /* Rotate the slot after the current one to bit 0. */
+        uxRotate = (UBaseType_t)((xDelayedTaskWheelTime >> uxShift) + 1U) & taskWHEEL_SLOT_MASK;
+
+        while (ulDelayedTaskSlotsInUse[ uxLevel ] != 0U) {
+            ulSlots = ulDelayedTaskSlotsInUse[ uxLevel ];
+            if (uxRotate != 0U) {
+                ulSlots = (ulSlots >> uxRotate) | (ulSlots << (taskWHEEL_SLOTS - uxRotate));
+            }
+
+            uxBit = portLOWEST_BIT(ulSlots);
+            uxSlot = (uxBit + uxRotate) & taskWHEEL_SLOT_MASK;
+
+            if (listLIST_IS_EMPTY(&(xDelayedTaskWheel[ uxLevel ][ uxSlot ])) != pdFALSE) {
+                ulDelayedTaskSlotsInUse[ uxLevel ] &= ~((uint32_t) 1U << uxSlot);
+                continue;
+            }
+
+            xTicksToSlot = (TickType_t)(((xDelayedTaskWheelTime >> uxShift) + uxBit + 1U) << uxShift) - xDelayedTaskWheelTime;
+
+            if ((*pxWheelWasEmpty != pdFALSE) || (xTicksToSlot < xTicksToNextSlot)) {
+                xTicksToNextSlot = xTicksToSlot;
+                *pxWheelWasEmpty = pdFALSE;
+            }
+            break;
+        }
+    }
+
+    return xDelayedTaskWheelTime + xTicksToNextSlot;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvTurnDelayedTaskWheel(const TickType_t xTimeNow)
+{
+    TCB_t *pxTCB;
+    List_t *pxSlot;
+    TickType_t xNextTurnTime;
+    BaseType_t xWheelWasEmpty, xSwitchRequired = pdFALSE;
+    UBaseType_t uxLevel, uxShift, uxSlot;
+
+    for (;;) {
+        xNextTurnTime = prvGetNextDelayedTaskWheelTime(&xWheelWasEmpty);
+
+        if ((xWheelWasEmpty != pdFALSE) || ((TickType_t)(xNextTurnTime - xDelayedTaskWheelTime) > (TickType_t)(xTimeNow - xDelayedTaskWheelTime))) {
+            break;
+        }
+
+        xDelayedTaskWheelTime = xNextTurnTime;
+
+        /* Move the tasks of the slots that start at this tick down, from the
+        top level so a task can fall through every level below. */
+        for (uxLevel = taskWHEEL_LEVELS - 1U; uxLevel > 0U; uxLevel--) {
+            uxShift = uxLevel * taskWHEEL_SLOT_BITS;
+
+            if ((xDelayedTaskWheelTime & (((TickType_t) 1U << uxShift) - 1U)) == (TickType_t) 0U) {
+                uxSlot = (UBaseType_t)(xDelayedTaskWheelTime >> uxShift) & taskWHEEL_SLOT_MASK;
+                pxSlot = &(xDelayedTaskWheel[ uxLevel ][ uxSlot ]);
+
+                while (listLIST_IS_EMPTY(pxSlot) == pdFALSE) {
+                    pxTCB = (TCB_t *) listGET_OWNER_OF_HEAD_ENTRY(pxSlot);
+                    (void) uxListRemove(&(pxTCB->xStateListItem));
+                    (void) prvInsertInDelayedTaskWheel(&(pxTCB->xStateListItem));
+                }
+                ulDelayedTaskSlotsInUse[ uxLevel ] &= ~((uint32_t) 1U << uxSlot);
+            }
+            else {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+
+        /* Every task in the level 0 slot of this tick wakes now. */
+        uxSlot = (UBaseType_t) xDelayedTaskWheelTime & taskWHEEL_SLOT_MASK;
+        pxSlot = &(xDelayedTaskWheel[ 0 ][ uxSlot ]);
+
+        while (listLIST_IS_EMPTY(pxSlot) == pdFALSE) {
+            pxTCB = (TCB_t *) listGET_OWNER_OF_HEAD_ENTRY(pxSlot);
+
+            /* It is time to remove the item from the Blocked state. */
+            (void) uxListRemove(&(pxTCB->xStateListItem));
+
+            /* Is the task waiting on an event also?  If so remove it from the
+            event list. */
+            if (listLIST_ITEM_CONTAINER(&(pxTCB->xEventListItem)) != NULL) {
+                (void) uxListRemove(&(pxTCB->xEventListItem));
+            }
+            else {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* Place the unblocked task into the appropriate ready list. */
+            prvAddTaskToReadyList(pxTCB);
+
+            /* A task being unblocked cannot cause an immediate context switch
+            if preemption is turned off. */
+#if ( configUSE_PREEMPTION == 1 )
+            {
+                /* Preemption is on, but a context switch should only be
+                performed if the unblocked task has a priority that is equal
+                to or higher than the currently executing task. */
+                if (pxTCB->uxPriority >= pxCurrentTCB->uxPriority) {
+                    xSwitchRequired = pdTRUE;
+                }
+                else {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+#endif /* configUSE_PREEMPTION */
+        }
+        ulDelayedTaskSlotsInUse[ 0 ] &= ~((uint32_t) 1U << uxSlot);
+    }
+
+    xDelayedTaskWheelTime = xTimeNow;
+
+    return xSwitchRequired;
+}
+
+#else
+
 static void prvResetNextTaskUnblockTime(void)
 {
     TCB_t *pxTCB;
@@ -3409,6 +4133,108 @@ static void prvResetNextTaskUnblockTime(void)
         xNextTaskUnblockTime = listGET_LIST_ITEM_VALUE(&((pxTCB)->xStateListItem));
     }
 }
+
+#endif /* configUSE_DELAYED_TASK_WHEEL */
+/*-----------------------------------------------------------*/
+
+#if ( configNUMBER_OF_CORES > 1 )
+
+static void prvSelectHighestPriorityTask(const BaseType_t xCoreID)
+{
+    UBaseType_t uxPriority, uxCount;
+    List_t *pxList;
+    ListItem_t *pxItem;
+    TCB_t *pxTCB, *pxSelectedTCB = NULL;
+
+    /* Find the highest priority queue that contains ready tasks. */
+#if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
+    {
+        while (listLIST_IS_EMPTY(&(pxReadyTasksLists[ uxTopReadyPriority ]))) {
+            configASSERT(uxTopReadyPriority);
+            --uxTopReadyPriority;
+        }
+        uxPriority = uxTopReadyPriority;
+    }
+#else
+    {
+        portGET_HIGHEST_PRIORITY(uxPriority, uxTopReadyPriority);
+    }
+#endif
+
+    /* The head of a ready list may be running on another core, so walk the
+    lists from the top down for the first task this core is allowed to run.
+    Each list is walked from the task last selected from it so tasks of equal
+    priority share the cores round robin. Below the top an empty list costs no
+    more than testing its bit would. */
+    for (; pxSelectedTCB == NULL; uxPriority--) {
+        pxList = &(pxReadyTasksLists[ uxPriority ]);
+        pxItem = pxList->pxIndex;
+
+        for (uxCount = listCURRENT_LIST_LENGTH(pxList); uxCount > (UBaseType_t) 0; uxCount--) {
+            pxItem = pxItem->pxNext;
+            if ((void *) pxItem == (void *) &(pxList->xListEnd)) {
+                pxItem = pxItem->pxNext;
+            }
+
+            pxTCB = (TCB_t *) listGET_LIST_ITEM_OWNER(pxItem);
+            if (((pxTCB->xTaskRunState == taskTASK_NOT_RUNNING) || (pxTCB->xTaskRunState == xCoreID)) &&
+                ((pxTCB->uxCoreAffinityMask & ((UBaseType_t) 1 << xCoreID)) != (UBaseType_t) 0)) {
+                pxList->pxIndex = pxItem;
+                pxSelectedTCB = pxTCB;
+                break;
+            }
+        }
+
+        /* There is an idle task for every core, so the walk ends at the
+        idle priority at the latest. */
+        configASSERT((pxSelectedTCB != NULL) || (uxPriority > tskIDLE_PRIORITY));
+    }
+
+    if ((pxCurrentTCBs[ xCoreID ] != NULL) && (pxCurrentTCBs[ xCoreID ]->xTaskRunState == xCoreID)) {
+        pxCurrentTCBs[ xCoreID ]->xTaskRunState = taskTASK_NOT_RUNNING;
+    }
+    pxSelectedTCB->xTaskRunState = xCoreID;
+    pxCurrentTCBs[ xCoreID ] = pxSelectedTCB;
+}
+/*-----------------------------------------------------------*/
+
+static void prvYieldForTask(const TCB_t *pxTCB)
+{
+    BaseType_t xCoreID, xLowestCoreID = taskTASK_NOT_RUNNING;
+    UBaseType_t uxLowestPriority = pxTCB->uxPriority;
+    const BaseType_t xThisCoreID = portGET_CORE_ID();
+
+    if ((xSchedulerRunning == pdFALSE) || (taskTASK_IS_RUNNING(pxTCB))) {
+        return;
+    }
+
+    /* Preempt the core running the lowest priority task below that of pxTCB,
+    the calling core if it is one of several such cores. */
+    for (xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++) {
+        if ((pxTCB->uxCoreAffinityMask & ((UBaseType_t) 1 << xCoreID)) == (UBaseType_t) 0) {
+            continue;
+        }
+
+        if ((pxCurrentTCBs[ xCoreID ]->uxPriority < uxLowestPriority) ||
+            ((pxCurrentTCBs[ xCoreID ]->uxPriority == uxLowestPriority) &&
+             (xLowestCoreID != taskTASK_NOT_RUNNING) && (xCoreID == xThisCoreID))) {
+            uxLowestPriority = pxCurrentTCBs[ xCoreID ]->uxPriority;
+            xLowestCoreID = xCoreID;
+        }
+    }
+
+    if (xLowestCoreID == xThisCoreID) {
+        xYieldPending = pdTRUE;
+    }
+    else if (xLowestCoreID != taskTASK_NOT_RUNNING) {
+        portYIELD_CORE(xLowestCoreID);
+    }
+    else {
+        mtCOVERAGE_TEST_MARKER();
+    }
+}
+
+#endif /* configNUMBER_OF_CORES */
 /*-----------------------------------------------------------*/
 
 #if ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) )
@@ -3428,6 +4254,38 @@ TaskHandle_t xTaskGetCurrentTaskHandle(void)
 #endif /* ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) ) */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_QUEUE_STATS == 1 )
+
+QueueStatsWait_t *pxTaskGetQueueStatsWait(void)
+{
+    /* Only called by the task itself from within a critical section or with
+    the scheduler suspended, so it cannot be moved to another core. */
+    if (pxCurrentTCB == NULL) {
+        return &xNoTaskQueueStatsWait;
+    }
+
+    return &(pxCurrentTCB->xQueueStatsWait);
+}
+
+#endif /* configUSE_QUEUE_STATS */
+/*-----------------------------------------------------------*/
+
+#if ( configNUMBER_OF_CORES > 1 )
+
+TaskHandle_t xTaskGetCurrentTaskHandleForCore(BaseType_t xCoreID)
+{
+    TaskHandle_t xReturn = NULL;
+
+    if ((xCoreID >= 0) && (xCoreID < configNUMBER_OF_CORES)) {
+        xReturn = pxCurrentTCBs[ xCoreID ];
+    }
+
+    return xReturn;
+}
+
+#endif /* configNUMBER_OF_CORES */
+/*-----------------------------------------------------------*/
+
 #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
 
 BaseType_t xTaskGetSchedulerState(void)
@@ -3438,12 +4296,20 @@ BaseType_t xTaskGetSchedulerState(void)
         xReturn = taskSCHEDULER_NOT_STARTED;
     }
     else {
+#if ( configNUMBER_OF_CORES > 1 )
+        /* Another core only suspends the scheduler while holding the task
+        lock, so wait for it rather than report its suspension as ours. */
+        taskENTER_CRITICAL();
+#endif
         if (uxSchedulerSuspended == (UBaseType_t) pdFALSE) {
             xReturn = taskSCHEDULER_RUNNING;
         }
         else {
             xReturn = taskSCHEDULER_SUSPENDED;
         }
+#if ( configNUMBER_OF_CORES > 1 )
+        taskEXIT_CRITICAL();
+#endif
     }
 
     return xReturn;
@@ -3757,7 +4623,7 @@ void vTaskGetRunTimeStats(char *pcWriteBuffer)
 {
     TaskStatus_t *pxTaskStatusArray;
     volatile UBaseType_t uxArraySize, x;
-    uint32_t ulTotalTime, ulStatsAsPercentage;
+    configRUN_TIME_COUNTER_TYPE ulTotalTime, ulStatsAsPercentage;
 
 #if( configUSE_TRACE_FACILITY != 1 )
     {
@@ -3826,7 +4692,7 @@ void vTaskGetRunTimeStats(char *pcWriteBuffer)
                 if (ulStatsAsPercentage > 0UL) {
 #ifdef portLU_PRINTF_SPECIFIER_REQUIRED
                     {
-                        sprintf(pcWriteBuffer, "\t%lu\t\t%lu%%\r\n", pxTaskStatusArray[ x ].ulRunTimeCounter, ulStatsAsPercentage);
+                        sprintf(pcWriteBuffer, "\t%lu\t\t%lu%%\r\n", (unsigned long) pxTaskStatusArray[ x ].ulRunTimeCounter, (unsigned long) ulStatsAsPercentage);
                     }
 #else
                     {
@@ -3841,7 +4707,7 @@ void vTaskGetRunTimeStats(char *pcWriteBuffer)
                     consumed less than 1% of the total run time. */
 #ifdef portLU_PRINTF_SPECIFIER_REQUIRED
                     {
-                        sprintf(pcWriteBuffer, "\t%lu\t\t<1%%\r\n", pxTaskStatusArray[ x ].ulRunTimeCounter);
+                        sprintf(pcWriteBuffer, "\t%lu\t\t<1%%\r\n", (unsigned long) pxTaskStatusArray[ x ].ulRunTimeCounter);
                     }
 #else
                     {
@@ -4399,6 +5265,9 @@ static void prvAddCurrentTaskToDelayedList(TickType_t xTicksToWait, const BaseTy
             /* The list item will be inserted in wake time order. */
             listSET_LIST_ITEM_VALUE(&(pxCurrentTCB->xStateListItem), xTimeToWake);
 
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+            prvAddTaskToDelayedTaskWheel(pxCurrentTCB);
+#else
             if (xTimeToWake < xConstTickCount) {
                 /* Wake time has overflowed.  Place this item in the overflow
                 list. */
@@ -4419,6 +5288,7 @@ static void prvAddCurrentTaskToDelayedList(TickType_t xTicksToWait, const BaseTy
                     mtCOVERAGE_TEST_MARKER();
                 }
             }
+#endif /* configUSE_DELAYED_TASK_WHEEL */
         }
     }
 #else /* INCLUDE_vTaskSuspend */
@@ -4431,6 +5301,9 @@ static void prvAddCurrentTaskToDelayedList(TickType_t xTicksToWait, const BaseTy
         /* The list item will be inserted in wake time order. */
         listSET_LIST_ITEM_VALUE(&(pxCurrentTCB->xStateListItem), xTimeToWake);
 
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+        prvAddTaskToDelayedTaskWheel(pxCurrentTCB);
+#else
         if (xTimeToWake < xConstTickCount) {
             /* Wake time has overflowed.  Place this item in the overflow list. */
             vListInsert(pxOverflowDelayedTaskList, &(pxCurrentTCB->xStateListItem));
@@ -4449,6 +5322,7 @@ static void prvAddCurrentTaskToDelayedList(TickType_t xTicksToWait, const BaseTy
                 mtCOVERAGE_TEST_MARKER();
             }
         }
+#endif /* configUSE_DELAYED_TASK_WHEEL */
 
         /* Avoid compiler warning when INCLUDE_vTaskSuspend is not 1. */
         (void) xCanBlockIndefinitely;
@@ -156,6 +156,59 @@ typedef struct tmrTimerQueueMessage {
 /*lint -e956 A manual analysis and inspection has been used to determine which
 static variables must be declared volatile. */
 
+#if ( configUSE_TIMER_WHEEL == 1 )
+
+/* Active timers are kept in the slots of a hierarchical timing wheel.  A timer
+that expires less than 32 ticks after the wheel's time is in the level 0 slot
+of its expiry tick.  One that expires later is in the slot of level n that
+covers the 32^n ticks its expiry tick falls in.  Once the wheel reaches the
+start of a slot above level 0, the timers in it move down to the levels below.
+Starting, stopping and expiring a timer therefore costs the same however many
+timers are active.  A bit is set for each slot that holds timers, so the next
+slot to turn the wheel to is found without looking at the empty ones.  Only the
+timer service task is allowed to access the wheel. */
+#define tmrWHEEL_SLOT_BITS      5U
+#define tmrWHEEL_SLOTS          ( 1U << tmrWHEEL_SLOT_BITS )
+#define tmrWHEEL_SLOT_MASK      ( tmrWHEEL_SLOTS - 1U )
+#define tmrWHEEL_LEVELS         ( ( ( sizeof( TickType_t ) * 8U ) + tmrWHEEL_SLOT_BITS - 1U ) / tmrWHEEL_SLOT_BITS )
+
+/* Ports without a way to count trailing zeros get the slot by shifting. */
+#ifndef portLOWEST_BIT
+#define portLOWEST_BIT( ulBits )    prvLowestBit( ulBits )
+
+static UBaseType_t prvLowestBit(uint32_t ulBits)
+{
+    UBaseType_t uxBit = 0U;
+
+    while ((ulBits & 1U) == 0U) {
+        ulBits >>= 1U;
+        uxBit++;
+    }
+
+    return uxBit;
+}
+#endif /* portLOWEST_BIT */
+
+PRIVILEGED_DATA static List_t xTimerWheel[ tmrWHEEL_LEVELS ][ tmrWHEEL_SLOTS ];
+PRIVILEGED_DATA static uint32_t ulTimerWheelSlotsInUse[ tmrWHEEL_LEVELS ];
+
+/* The tick the wheel has been turned to.  It is never ahead of the tick
+count. */
+PRIVILEGED_DATA static TickType_t xTimerWheelTime = ( TickType_t ) 0U;
+
+#if ( configUSE_TIMER_DIRECT_COMMANDS == 1 )
+
+/* Set while the timer service task is blocked waiting for a command or the
+next slot, at xTimerWakeTime unless xTimerWaitsIndefinitely, and so leaves
+the wheel alone. */
+PRIVILEGED_DATA static volatile BaseType_t xTimerTaskWaiting = pdFALSE;
+PRIVILEGED_DATA static TickType_t xTimerWakeTime = ( TickType_t ) 0U;
+PRIVILEGED_DATA static BaseType_t xTimerWaitsIndefinitely = pdFALSE;
+
+#endif /* configUSE_TIMER_DIRECT_COMMANDS */
+
+#else
+
 /* The list in which active timers are stored.  Timers are referenced in expire
 time order, with the nearest expiry time at the front of the list.  Only the
 timer service task is allowed to access these lists. */
@@ -164,6 +217,8 @@ PRIVILEGED_DATA static List_t xActiveTimerList2;
 PRIVILEGED_DATA static List_t *pxCurrentTimerList;
 PRIVILEGED_DATA static List_t *pxOverflowTimerList;
 
+#endif /* configUSE_TIMER_WHEEL */
+
 /* A queue that is used to send commands to the timer service task. */
 PRIVILEGED_DATA static QueueHandle_t xTimerQueue = NULL;
 PRIVILEGED_DATA static TaskHandle_t xTimerTaskHandle = NULL;
@@ -201,12 +256,52 @@ static void prvTimerTask(void *pvParameters) PRIVILEGED_FUNCTION;
  */
 static void prvProcessReceivedCommands(void) PRIVILEGED_FUNCTION;
 
+/*
+ * Carry out a command for a timer, received on the timer queue or applied
+ * directly.
+ */
+static void prvProcessTimerCommand(const DaemonTaskMessage_t *const pxMessage) PRIVILEGED_FUNCTION;
+
+#if ( configUSE_TIMER_DIRECT_COMMANDS == 1 )
+
+/*
+ * Carry out a command sent from a task right away, without the timer queue,
+ * if the timer service task is the caller or is waiting with nothing queued.
+ * Returns pdFALSE, leaving the command to be sent, otherwise.
+ */
+static BaseType_t prvApplyCommandDirectly(const DaemonTaskMessage_t *const pxMessage) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_TIMER_DIRECT_COMMANDS */
+
 /*
  * Insert the timer into either xActiveTimerList1, or xActiveTimerList2,
- * depending on if the expire time causes a timer counter overflow.
+ * depending on if the expire time causes a timer counter overflow, or into
+ * the timing wheel.
  */
 static BaseType_t prvInsertTimerInActiveList(Timer_t *const pxTimer, const TickType_t xNextExpiryTime, const TickType_t xTimeNow, const TickType_t xCommandTime) PRIVILEGED_FUNCTION;
 
+/*
+ * Remove an active timer from the list or wheel slot it is in.
+ */
+static void prvRemoveTimerFromActiveList(Timer_t *const pxTimer) PRIVILEGED_FUNCTION;
+
+#if ( configUSE_TIMER_WHEEL == 1 )
+
+/*
+ * Put the timer into the wheel slot that its expiry time falls in, as seen
+ * from the wheel's time.
+ */
+static void prvInsertTimerInWheel(Timer_t *const pxTimer, const TickType_t xExpiryTime) PRIVILEGED_FUNCTION;
+
+/*
+ * Turn the wheel on to xTimeNow.  Timers in the slots passed on the way move
+ * down a level or, on level 0, expire.  Each expired timer is reloaded if it
+ * is an auto reload timer and then its callback is called.
+ */
+static void prvTurnTimerWheel(const TickType_t xTimeNow) PRIVILEGED_FUNCTION;
+
+#else
+
 /*
  * An active timer has reached its expire time.  Reload the timer if it is an
  * auto reload timer, then call its callback.
@@ -219,6 +314,8 @@ static void prvProcessExpiredTimer(const TickType_t xNextExpireTime, const TickT
  */
 static void prvSwitchTimerLists(void) PRIVILEGED_FUNCTION;
 
+#endif /* configUSE_TIMER_WHEEL */
+
 /*
  * Obtain the current tick count, setting *pxTimerListsWereSwitched to pdTRUE
  * if a tick count overflow occurred since prvSampleTimeNow() was last called.
@@ -229,7 +326,8 @@ static TickType_t prvSampleTimeNow(BaseType_t *const pxTimerListsWereSwitched) P
  * If the timer list contains any active timers then return the expire time of
  * the timer that will expire first and set *pxListWasEmpty to false.  If the
  * timer list does not contain any timers then return 0 and set *pxListWasEmpty
- * to pdTRUE.
+ * to pdTRUE.  With the timing wheel the time returned is that of the next
+ * slot in use, which above level 0 can be earlier than any expiry time.
  */
 static TickType_t prvGetNextExpireTime(BaseType_t *const pxListWasEmpty) PRIVILEGED_FUNCTION;
 
@@ -419,6 +517,12 @@ BaseType_t xTimerGenericCommand(TimerHandle_t xTimer, const BaseType_t xCommandI
         xMessage.u.xTimerParameters.xMessageValue = xOptionalValue;
         xMessage.u.xTimerParameters.pxTimer = (Timer_t *) xTimer;
 
+#if ( configUSE_TIMER_DIRECT_COMMANDS == 1 )
+        if (prvApplyCommandDirectly(&xMessage) != pdFALSE) {
+            xReturn = pdPASS;
+        }
+        else
+#endif /* configUSE_TIMER_DIRECT_COMMANDS */
         if (xCommandID < tmrFIRST_FROM_ISR_COMMAND) {
             if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
                 xReturn = xQueueSendToBack(xTimerQueue, &xMessage, xTicksToWait);
@@ -441,6 +545,75 @@ BaseType_t xTimerGenericCommand(TimerHandle_t xTimer, const BaseType_t xCommandI
 }
 /*-----------------------------------------------------------*/
 
+UBaseType_t uxTimerSendCommandBatch(const TimerCommand_t *pxCommands, UBaseType_t uxCommands, TickType_t xTicksToWait)
+{
+    UBaseType_t uxSent = 0U;
+    DaemonTaskMessage_t xMessage;
+    TimeOut_t xTimeOut;
+    TickType_t xCommandTime;
+    BaseType_t xSchedulerRunning;
+
+    configASSERT(pxCommands);
+    configASSERT(xTimerQueue);
+
+    xSchedulerRunning = (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) ? pdTRUE : pdFALSE;
+    xCommandTime = xTaskGetTickCount();
+    vTaskSetTimeOutState(&xTimeOut);
+
+    while (uxSent < uxCommands) {
+        /* Queue as many commands as fit without letting the timer service
+        task run, it is then woken once to process them all. */
+        if (xSchedulerRunning != pdFALSE) {
+            vTaskSuspendAll();
+        }
+
+        while (uxSent < uxCommands) {
+            configASSERT(pxCommands[ uxSent ].xTimer);
+            configASSERT(pxCommands[ uxSent ].xCommandID >= tmrCOMMAND_START_DONT_TRACE);
+            configASSERT(pxCommands[ uxSent ].xCommandID < tmrFIRST_FROM_ISR_COMMAND);
+
+            xMessage.xMessageID = pxCommands[ uxSent ].xCommandID;
+            xMessage.u.xTimerParameters.xMessageValue = (pxCommands[ uxSent ].xCommandID == tmrCOMMAND_CHANGE_PERIOD) ? pxCommands[ uxSent ].xNewPeriod : xCommandTime;
+            xMessage.u.xTimerParameters.pxTimer = (Timer_t *) pxCommands[ uxSent ].xTimer;
+
+#if ( configUSE_TIMER_DIRECT_COMMANDS == 1 )
+            if (prvApplyCommandDirectly(&xMessage) != pdFALSE) {
+                mtCOVERAGE_TEST_MARKER();
+            }
+            else
+#endif /* configUSE_TIMER_DIRECT_COMMANDS */
+            if (xQueueSendToBack(xTimerQueue, &xMessage, tmrNO_DELAY) != pdPASS) {
+                break;
+            }
+
+            traceTIMER_COMMAND_SEND(xMessage.u.xTimerParameters.pxTimer, xMessage.xMessageID, xMessage.u.xTimerParameters.xMessageValue, pdPASS);
+            uxSent++;
+        }
+
+        if (xSchedulerRunning != pdFALSE) {
+            (void) xTaskResumeAll();
+        }
+
+        /* The queue is full.  Wait, for what is left of xTicksToWait, until
+        the timer service task has taken at least the next command. */
+        if (uxSent < uxCommands) {
+            if ((xSchedulerRunning == pdFALSE) || (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)) {
+                break;
+            }
+
+            if (xQueueSendToBack(xTimerQueue, &xMessage, xTicksToWait) != pdPASS) {
+                break;
+            }
+
+            traceTIMER_COMMAND_SEND(xMessage.u.xTimerParameters.pxTimer, xMessage.xMessageID, xMessage.u.xTimerParameters.xMessageValue, pdPASS);
+            uxSent++;
+        }
+    }
+
+    return uxSent;
+}
+/*-----------------------------------------------------------*/
+
 TaskHandle_t xTimerGetTimerDaemonTaskHandle(void)
 {
     /* If xTimerGetTimerDaemonTaskHandle() is called before the scheduler has been
@@ -479,6 +652,72 @@ const char *pcTimerGetName(TimerHandle_t xTimer)    /*lint !e971 Unqualified cha
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_TIMER_WHEEL == 1 )
+
+static void prvTurnTimerWheel(const TickType_t xTimeNow)
+{
+    Timer_t *pxTimer;
+    List_t *pxSlot;
+    TickType_t xNextTurnTime;
+    BaseType_t xWheelWasEmpty;
+    UBaseType_t uxLevel, uxShift;
+
+    for (;;) {
+        xNextTurnTime = prvGetNextExpireTime(&xWheelWasEmpty);
+
+        if ((xWheelWasEmpty != pdFALSE) || ((TickType_t)(xNextTurnTime - xTimerWheelTime) > (TickType_t)(xTimeNow - xTimerWheelTime))) {
+            break;
+        }
+
+        xTimerWheelTime = xNextTurnTime;
+
+        /* Move the timers of the slots that start at this tick down, from
+        the top level so a timer can fall through every level below. */
+        for (uxLevel = tmrWHEEL_LEVELS - 1U; uxLevel > 0U; uxLevel--) {
+            uxShift = uxLevel * tmrWHEEL_SLOT_BITS;
+
+            if ((xTimerWheelTime & (((TickType_t) 1U << uxShift) - 1U)) == (TickType_t) 0U) {
+                pxSlot = &(xTimerWheel[ uxLevel ][(xTimerWheelTime >> uxShift) & tmrWHEEL_SLOT_MASK ]);
+
+                while (listLIST_IS_EMPTY(pxSlot) == pdFALSE) {
+                    pxTimer = (Timer_t *) listGET_OWNER_OF_HEAD_ENTRY(pxSlot);
+                    prvRemoveTimerFromActiveList(pxTimer);
+                    prvInsertTimerInWheel(pxTimer, listGET_LIST_ITEM_VALUE(&(pxTimer->xTimerListItem)));
+                }
+            }
+            else {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+
+        /* Every timer in the level 0 slot of this tick expires now. */
+        pxSlot = &(xTimerWheel[ 0 ][ xTimerWheelTime & tmrWHEEL_SLOT_MASK ]);
+
+        while (listLIST_IS_EMPTY(pxSlot) == pdFALSE) {
+            pxTimer = (Timer_t *) listGET_OWNER_OF_HEAD_ENTRY(pxSlot);
+            prvRemoveTimerFromActiveList(pxTimer);
+            traceTIMER_EXPIRED(pxTimer);
+
+            /* The next expiry time is never behind the wheel, so a timer the
+            daemon task fell behind on still expires once for every period
+            before the wheel reaches xTimeNow. */
+            if (pxTimer->uxAutoReload == (UBaseType_t) pdTRUE) {
+                prvInsertTimerInWheel(pxTimer, xTimerWheelTime + pxTimer->xTimerPeriodInTicks);
+            }
+            else {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* Call the timer callback. */
+            pxTimer->pxCallbackFunction((TimerHandle_t) pxTimer);
+        }
+    }
+
+    xTimerWheelTime = xTimeNow;
+}
+
+#else
+
 static void prvProcessExpiredTimer(const TickType_t xNextExpireTime, const TickType_t xTimeNow)
 {
     BaseType_t xResult;
@@ -513,6 +752,8 @@ static void prvProcessExpiredTimer(const TickType_t xNextExpireTime, const TickT
     /* Call the timer callback. */
     pxTimer->pxCallbackFunction((TimerHandle_t) pxTimer);
 }
+
+#endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
 static void prvTimerTask(void *pvParameters)
@@ -550,6 +791,58 @@ static void prvTimerTask(void *pvParameters)
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_TIMER_WHEEL == 1 )
+
+static void prvProcessTimerOrBlockTask(const TickType_t xNextExpireTime, BaseType_t xListWasEmpty)
+{
+    TickType_t xTimeNow;
+
+    vTaskSuspendAll();
+    {
+        /* Times are compared as ticks after the wheel's time, which the tick
+        count cannot have wrapped past, so an overflow needs no handling. */
+        xTimeNow = xTaskGetTickCount();
+
+        if ((xListWasEmpty == pdFALSE) && ((TickType_t)(xNextExpireTime - xTimerWheelTime) <= (TickType_t)(xTimeNow - xTimerWheelTime))) {
+            (void) xTaskResumeAll();
+            prvTurnTimerWheel(xTimeNow);
+        }
+        else {
+            /* No slot in use comes before xTimeNow, so the wheel skips ahead
+            to it.  That keeps the wheel within a tick count wrap of the tick
+            count however long it stays empty. */
+            xTimerWheelTime = xTimeNow;
+
+#if ( configUSE_TIMER_DIRECT_COMMANDS == 1 )
+            {
+                xTimerWakeTime = xNextExpireTime;
+                xTimerWaitsIndefinitely = xListWasEmpty;
+                xTimerTaskWaiting = pdTRUE;
+            }
+#endif /* configUSE_TIMER_DIRECT_COMMANDS */
+
+            vQueueWaitForMessageRestricted(xTimerQueue, (xNextExpireTime - xTimeNow), xListWasEmpty);
+
+            if (xTaskResumeAll() == pdFALSE) {
+                /* Yield to wait for either a command to arrive, or the block
+                time to expire. */
+                portYIELD_WITHIN_API();
+            }
+            else {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+#if ( configUSE_TIMER_DIRECT_COMMANDS == 1 )
+            {
+                xTimerTaskWaiting = pdFALSE;
+            }
+#endif /* configUSE_TIMER_DIRECT_COMMANDS */
+        }
+    }
+}
+
+#else
+
 static void prvProcessTimerOrBlockTask(const TickType_t xNextExpireTime, BaseType_t xListWasEmpty)
 {
     TickType_t xTimeNow;
@@ -601,8 +894,49 @@ static void prvProcessTimerOrBlockTask(const TickType_t xNextExpireTime, BaseTyp
         }
     }
 }
+
+#endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_TIMER_WHEEL == 1 )
+
+static TickType_t prvGetNextExpireTime(BaseType_t *const pxListWasEmpty)
+{
+    TickType_t xTicksToSlot, xTicksToNextSlot = (TickType_t) 0U;
+    UBaseType_t uxLevel, uxShift, uxRotate;
+    uint32_t ulSlots;
+
+    /* On each level the first slot in use after the wheel's current one is
+    the next the wheel has to turn to.  On level 0 that is a timer's expiry
+    time, above it the start of the slot, when its timers move down. */
+    *pxListWasEmpty = pdTRUE;
+
+    for (uxLevel = 0U; uxLevel < tmrWHEEL_LEVELS; uxLevel++) {
+        ulSlots = ulTimerWheelSlotsInUse[ uxLevel ];
+
+        if (ulSlots != 0U) {
+            uxShift = uxLevel * tmrWHEEL_SLOT_BITS;
+
+            /* Rotate the slot after the current one to bit 0. */
+            uxRotate = (UBaseType_t)((xTimerWheelTime >> uxShift) + 1U) & tmrWHEEL_SLOT_MASK;
+            if (uxRotate != 0U) {
+                ulSlots = (ulSlots >> uxRotate) | (ulSlots << (tmrWHEEL_SLOTS - uxRotate));
+            }
+
+            xTicksToSlot = (TickType_t)(((xTimerWheelTime >> uxShift) + portLOWEST_BIT(ulSlots) + 1U) << uxShift) - xTimerWheelTime;
+
+            if ((*pxListWasEmpty != pdFALSE) || (xTicksToSlot < xTicksToNextSlot)) {
+                xTicksToNextSlot = xTicksToSlot;
+                *pxListWasEmpty = pdFALSE;
+            }
+        }
+    }
+
+    return xTimerWheelTime + xTicksToNextSlot;
+}
+
+#else
+
 static TickType_t prvGetNextExpireTime(BaseType_t *const pxListWasEmpty)
 {
     TickType_t xNextExpireTime;
@@ -625,29 +959,97 @@ static TickType_t prvGetNextExpireTime(BaseType_t *const pxListWasEmpty)
 
     return xNextExpireTime;
 }
+
+#endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
 static TickType_t prvSampleTimeNow(BaseType_t *const pxTimerListsWereSwitched)
 {
     TickType_t xTimeNow;
-    PRIVILEGED_DATA static TickType_t xLastTime = (TickType_t) 0U;   /*lint !e956 Variable is only accessible to one task. */
 
     xTimeNow = xTaskGetTickCount();
 
-    if (xTimeNow < xLastTime) {
-        prvSwitchTimerLists();
-        *pxTimerListsWereSwitched = pdTRUE;
-    }
-    else {
+#if ( configUSE_TIMER_WHEEL == 1 )
+    {
+        /* The wheel has no lists to switch. */
         *pxTimerListsWereSwitched = pdFALSE;
     }
+#else
+    {
+        PRIVILEGED_DATA static TickType_t xLastTime = (TickType_t) 0U;   /*lint !e956 Variable is only accessible to one task. */
 
-    xLastTime = xTimeNow;
+        if (xTimeNow < xLastTime) {
+            prvSwitchTimerLists();
+            *pxTimerListsWereSwitched = pdTRUE;
+        }
+        else {
+            *pxTimerListsWereSwitched = pdFALSE;
+        }
+
+        xLastTime = xTimeNow;
+    }
+#endif /* configUSE_TIMER_WHEEL */
 
     return xTimeNow;
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_TIMER_WHEEL == 1 )
+
+static BaseType_t prvInsertTimerInActiveList(Timer_t *const pxTimer, const TickType_t xNextExpiryTime, const TickType_t xTimeNow, const TickType_t xCommandTime)
+{
+    BaseType_t xProcessTimerNow = pdFALSE;
+
+    listSET_LIST_ITEM_VALUE(&(pxTimer->xTimerListItem), xNextExpiryTime);
+    listSET_LIST_ITEM_OWNER(&(pxTimer->xTimerListItem), pxTimer);
+
+    /* Has the expiry time elapsed between the command to start/reset a timer
+    was issued, and the time the command was processed?  Both are counted
+    from the command, which also covers a tick count overflow in between. */
+    if (((TickType_t)(xTimeNow - xCommandTime)) >= ((TickType_t)(xNextExpiryTime - xCommandTime))) {
+        xProcessTimerNow = pdTRUE;
+    }
+    else {
+        prvInsertTimerInWheel(pxTimer, xNextExpiryTime);
+    }
+
+    return xProcessTimerNow;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertTimerInWheel(Timer_t *const pxTimer, const TickType_t xExpiryTime)
+{
+    const TickType_t xTicksToExpiry = xExpiryTime - xTimerWheelTime;
+    UBaseType_t uxLevel = 0U, uxSlot;
+
+    while ((uxLevel < (tmrWHEEL_LEVELS - 1U)) && ((xTicksToExpiry >> ((uxLevel + 1U) * tmrWHEEL_SLOT_BITS)) != (TickType_t) 0U)) {
+        uxLevel++;
+    }
+
+    uxSlot = (UBaseType_t)(xExpiryTime >> (uxLevel * tmrWHEEL_SLOT_BITS)) & tmrWHEEL_SLOT_MASK;
+
+    listSET_LIST_ITEM_VALUE(&(pxTimer->xTimerListItem), xExpiryTime);
+    vListInsertEnd(&(xTimerWheel[ uxLevel ][ uxSlot ]), &(pxTimer->xTimerListItem));
+    ulTimerWheelSlotsInUse[ uxLevel ] |= (uint32_t) 1U << uxSlot;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveTimerFromActiveList(Timer_t *const pxTimer)
+{
+    const List_t *const pxSlot = (const List_t *) listLIST_ITEM_CONTAINER(&(pxTimer->xTimerListItem));
+    UBaseType_t uxSlot;
+
+    if (uxListRemove(&(pxTimer->xTimerListItem)) == (UBaseType_t) 0U) {
+        uxSlot = (UBaseType_t)(pxSlot - &(xTimerWheel[ 0 ][ 0 ]));
+        ulTimerWheelSlotsInUse[ uxSlot / tmrWHEEL_SLOTS ] &= ~((uint32_t) 1U << (uxSlot % tmrWHEEL_SLOTS));
+    }
+    else {
+        mtCOVERAGE_TEST_MARKER();
+    }
+}
+
+#else
+
 static BaseType_t prvInsertTimerInActiveList(Timer_t *const pxTimer, const TickType_t xNextExpiryTime, const TickType_t xTimeNow, const TickType_t xCommandTime)
 {
     BaseType_t xProcessTimerNow = pdFALSE;
@@ -683,12 +1085,17 @@ static BaseType_t prvInsertTimerInActiveList(Timer_t *const pxTimer, const TickT
 }
 /*-----------------------------------------------------------*/
 
+static void prvRemoveTimerFromActiveList(Timer_t *const pxTimer)
+{
+    (void) uxListRemove(&(pxTimer->xTimerListItem));
+}
+
+#endif /* configUSE_TIMER_WHEEL */
+/*-----------------------------------------------------------*/
+
 static void prvProcessReceivedCommands(void)
 {
     DaemonTaskMessage_t xMessage;
-    Timer_t *pxTimer;
-    BaseType_t xTimerListsWereSwitched, xResult;
-    TickType_t xTimeNow;
 
     while (xQueueReceive(xTimerQueue, &xMessage, tmrNO_DELAY) != pdFAIL) {  /*lint !e603 xMessage does not have to be initialised as it is passed out, not in, and it is not used unless xQueueReceive() returns pdTRUE. */
 #if ( INCLUDE_xTimerPendFunctionCall == 1 )
@@ -714,109 +1121,202 @@ static void prvProcessReceivedCommands(void)
         /* Commands that are positive are timer commands rather than pended
         function calls. */
         if (xMessage.xMessageID >= (BaseType_t) 0) {
-            /* The messages uses the xTimerParameters member to work on a
-            software timer. */
-            pxTimer = xMessage.u.xTimerParameters.pxTimer;
+            prvProcessTimerCommand(&xMessage);
+        }
+        else {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
 
-            if (listIS_CONTAINED_WITHIN(NULL, &(pxTimer->xTimerListItem)) == pdFALSE) {
-                /* The timer is in a list, remove it. */
-                (void) uxListRemove(&(pxTimer->xTimerListItem));
+static void prvProcessTimerCommand(const DaemonTaskMessage_t *const pxMessage)
+{
+    Timer_t *pxTimer;
+    BaseType_t xTimerListsWereSwitched, xResult;
+    TickType_t xTimeNow;
+
+    /* The messages uses the xTimerParameters member to work on a
+    software timer. */
+    pxTimer = pxMessage->u.xTimerParameters.pxTimer;
+
+    if (listIS_CONTAINED_WITHIN(NULL, &(pxTimer->xTimerListItem)) == pdFALSE) {
+        /* The timer is in a list, remove it. */
+        prvRemoveTimerFromActiveList(pxTimer);
+    }
+    else {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    traceTIMER_COMMAND_RECEIVED(pxTimer, pxMessage->xMessageID, pxMessage->u.xTimerParameters.xMessageValue);
+
+    /* In this case the xTimerListsWereSwitched parameter is not used, but
+    it must be present in the function call.  prvSampleTimeNow() must be
+    called after the message is received from xTimerQueue so there is no
+    possibility of a higher priority task adding a message to the message
+    queue with a time that is ahead of the timer daemon task (because it
+    pre-empted the timer daemon task after the xTimeNow value was set). */
+    xTimeNow = prvSampleTimeNow(&xTimerListsWereSwitched);
+
+    switch (pxMessage->xMessageID) {
+        case tmrCOMMAND_START :
+        case tmrCOMMAND_START_FROM_ISR :
+        case tmrCOMMAND_RESET :
+        case tmrCOMMAND_RESET_FROM_ISR :
+        case tmrCOMMAND_START_DONT_TRACE :
+            /* Start or restart a timer. */
+            if (prvInsertTimerInActiveList(pxTimer,  pxMessage->u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow, pxMessage->u.xTimerParameters.xMessageValue) != pdFALSE) {
+                /* The timer expired before it was added to the active
+                timer list.  Process it now. */
+                pxTimer->pxCallbackFunction((TimerHandle_t) pxTimer);
+                traceTIMER_EXPIRED(pxTimer);
+
+                if (pxTimer->uxAutoReload == (UBaseType_t) pdTRUE) {
+                    xResult = xTimerGenericCommand(pxTimer, tmrCOMMAND_START_DONT_TRACE, pxMessage->u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, NULL, tmrNO_DELAY);
+                    configASSERT(xResult);
+                    (void) xResult;
+                }
+                else {
+                    mtCOVERAGE_TEST_MARKER();
+                }
             }
             else {
                 mtCOVERAGE_TEST_MARKER();
             }
+            break;
+
+        case tmrCOMMAND_STOP :
+        case tmrCOMMAND_STOP_FROM_ISR :
+            /* The timer has already been removed from the active list.
+            There is nothing to do here. */
+            break;
+
+        case tmrCOMMAND_CHANGE_PERIOD :
+        case tmrCOMMAND_CHANGE_PERIOD_FROM_ISR :
+            pxTimer->xTimerPeriodInTicks = pxMessage->u.xTimerParameters.xMessageValue;
+            configASSERT((pxTimer->xTimerPeriodInTicks > 0));
+
+            /* The new period does not really have a reference, and can
+            be longer or shorter than the old one.  The command time is
+            therefore set to the current time, and as the period cannot
+            be zero the next expiry time can only be in the future,
+            meaning (unlike for the xTimerStart() case above) there is
+            no fail case that needs to be handled here. */
+            (void) prvInsertTimerInActiveList(pxTimer, (xTimeNow + pxTimer->xTimerPeriodInTicks), xTimeNow, xTimeNow);
+            break;
+
+        case tmrCOMMAND_DELETE :
+            /* The timer has already been removed from the active list,
+            just free up the memory if the memory was dynamically
+            allocated. */
+#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
+            {
+                /* The timer can only have been allocated dynamically -
+                free it again. */
+                vPortFree(pxTimer);
+            }
+#elif( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+            {
+                /* The timer could have been allocated statically or
+                dynamically, so check before attempting to free the
+                memory. */
+                if (pxTimer->ucStaticallyAllocated == (uint8_t) pdFALSE) {
+                    vPortFree(pxTimer);
+                }
+                else {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+            break;
+
+        default :
+            /* Don't expect to get here. */
+            break;
+    }
+}
+/*-----------------------------------------------------------*/
 
-            traceTIMER_COMMAND_RECEIVED(pxTimer, xMessage.xMessageID, xMessage.u.xTimerParameters.xMessageValue);
-
-            /* In this case the xTimerListsWereSwitched parameter is not used, but
-            it must be present in the function call.  prvSampleTimeNow() must be
-            called after the message is received from xTimerQueue so there is no
-            possibility of a higher priority task adding a message to the message
-            queue with a time that is ahead of the timer daemon task (because it
-            pre-empted the timer daemon task after the xTimeNow value was set). */
-            xTimeNow = prvSampleTimeNow(&xTimerListsWereSwitched);
-
-            switch (xMessage.xMessageID) {
-                case tmrCOMMAND_START :
-                case tmrCOMMAND_START_FROM_ISR :
-                case tmrCOMMAND_RESET :
-                case tmrCOMMAND_RESET_FROM_ISR :
-                case tmrCOMMAND_START_DONT_TRACE :
-                    /* Start or restart a timer. */
-                    if (prvInsertTimerInActiveList(pxTimer,  xMessage.u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow, xMessage.u.xTimerParameters.xMessageValue) != pdFALSE) {
-                        /* The timer expired before it was added to the active
-                        timer list.  Process it now. */
-                        pxTimer->pxCallbackFunction((TimerHandle_t) pxTimer);
-                        traceTIMER_EXPIRED(pxTimer);
-
-                        if (pxTimer->uxAutoReload == (UBaseType_t) pdTRUE) {
-                            xResult = xTimerGenericCommand(pxTimer, tmrCOMMAND_START_DONT_TRACE, xMessage.u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, NULL, tmrNO_DELAY);
-                            configASSERT(xResult);
-                            (void) xResult;
-                        }
-                        else {
-                            mtCOVERAGE_TEST_MARKER();
-                        }
+#if ( configUSE_TIMER_DIRECT_COMMANDS == 1 )
+
+static BaseType_t prvApplyCommandDirectly(const DaemonTaskMessage_t *const pxMessage)
+{
+    const Timer_t *const pxTimer = pxMessage->u.xTimerParameters.pxTimer;
+    BaseType_t xApplied = pdFALSE, xCallerIsTimerTask, xWheelWasEmpty;
+    TickType_t xNextTurnTime;
+
+    if ((pxMessage->xMessageID < tmrFIRST_FROM_ISR_COMMAND) && (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED)) {
+        /* With the scheduler suspended the timer service task cannot start
+        using the wheel while the command is applied. */
+        vTaskSuspendAll();
+        {
+            xCallerIsTimerTask = (xTaskGetCurrentTaskHandle() == xTimerTaskHandle) ? pdTRUE : pdFALSE;
+
+            /* Commands already queued go first, so the caller's commands are
+            still carried out in order.  A task other than the timer service
+            task only gets to use the wheel while the service task waits. */
+            if ((uxQueueMessagesWaiting(xTimerQueue) == (UBaseType_t) 0) &&
+                ((xCallerIsTimerTask != pdFALSE) || ((xTimerTaskWaiting != pdFALSE) && (eTaskGetState(xTimerTaskHandle) == eBlocked)))) {
+                xApplied = pdTRUE;
+
+                /* A start or reset that is already due has its callback
+                called, which only the timer service task may do, so it
+                goes through the queue. */
+                if ((pxMessage->xMessageID == tmrCOMMAND_START) || (pxMessage->xMessageID == tmrCOMMAND_RESET) || (pxMessage->xMessageID == tmrCOMMAND_START_DONT_TRACE)) {
+                    if (((TickType_t)(xTaskGetTickCount() - pxMessage->u.xTimerParameters.xMessageValue)) >= pxTimer->xTimerPeriodInTicks) {
+                        xApplied = pdFALSE;
                     }
                     else {
                         mtCOVERAGE_TEST_MARKER();
                     }
-                    break;
-
-                case tmrCOMMAND_STOP :
-                case tmrCOMMAND_STOP_FROM_ISR :
-                    /* The timer has already been removed from the active list.
-                    There is nothing to do here. */
-                    break;
-
-                case tmrCOMMAND_CHANGE_PERIOD :
-                case tmrCOMMAND_CHANGE_PERIOD_FROM_ISR :
-                    pxTimer->xTimerPeriodInTicks = xMessage.u.xTimerParameters.xMessageValue;
-                    configASSERT((pxTimer->xTimerPeriodInTicks > 0));
-
-                    /* The new period does not really have a reference, and can
-                    be longer or shorter than the old one.  The command time is
-                    therefore set to the current time, and as the period cannot
-                    be zero the next expiry time can only be in the future,
-                    meaning (unlike for the xTimerStart() case above) there is
-                    no fail case that needs to be handled here. */
-                    (void) prvInsertTimerInActiveList(pxTimer, (xTimeNow + pxTimer->xTimerPeriodInTicks), xTimeNow, xTimeNow);
-                    break;
-
-                case tmrCOMMAND_DELETE :
-                    /* The timer has already been removed from the active list,
-                    just free up the memory if the memory was dynamically
-                    allocated. */
-#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
-                    {
-                        /* The timer can only have been allocated dynamically -
-                        free it again. */
-                        vPortFree(pxTimer);
+                }
+                else {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            if (xApplied != pdFALSE) {
+                prvProcessTimerCommand(pxMessage);
+
+                /* Wake the waiting timer service task if the wheel now has
+                to be turned before it would wake up. */
+                if (xCallerIsTimerTask == pdFALSE) {
+                    xNextTurnTime = prvGetNextExpireTime(&xWheelWasEmpty);
+
+                    if ((xWheelWasEmpty == pdFALSE) &&
+                        ((xTimerWaitsIndefinitely != pdFALSE) || ((TickType_t)(xNextTurnTime - xTimerWheelTime) < (TickType_t)(xTimerWakeTime - xTimerWheelTime)))) {
+                        xTimerTaskWaiting = pdFALSE;
+                        (void) xTaskAbortDelay(xTimerTaskHandle);
                     }
-#elif( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
-                    {
-                        /* The timer could have been allocated statically or
-                        dynamically, so check before attempting to free the
-                        memory. */
-                        if (pxTimer->ucStaticallyAllocated == (uint8_t) pdFALSE) {
-                            vPortFree(pxTimer);
-                        }
-                        else {
-                            mtCOVERAGE_TEST_MARKER();
-                        }
+                    else {
+                        mtCOVERAGE_TEST_MARKER();
                     }
-#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
-                    break;
-
-                default :
-                    /* Don't expect to get here. */
-                    break;
+                }
+                else {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else {
+                mtCOVERAGE_TEST_MARKER();
             }
         }
+        (void) xTaskResumeAll();
+    }
+    else {
+        mtCOVERAGE_TEST_MARKER();
     }
+
+    return xApplied;
 }
+
+#endif /* configUSE_TIMER_DIRECT_COMMANDS */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_TIMER_WHEEL == 0 )
+
 static void prvSwitchTimerLists(void)
 {
     TickType_t xNextExpireTime, xReloadTime;
@@ -869,6 +1369,8 @@ static void prvSwitchTimerLists(void)
     pxCurrentTimerList = pxOverflowTimerList;
     pxOverflowTimerList = pxTemp;
 }
+
+#endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
 static void prvCheckForValidListAndQueue(void)
@@ -879,10 +1381,26 @@ static void prvCheckForValidListAndQueue(void)
     taskENTER_CRITICAL();
     {
         if (xTimerQueue == NULL) {
-            vListInitialise(&xActiveTimerList1);
-            vListInitialise(&xActiveTimerList2);
-            pxCurrentTimerList = &xActiveTimerList1;
-            pxOverflowTimerList = &xActiveTimerList2;
+#if ( configUSE_TIMER_WHEEL == 1 )
+            {
+                UBaseType_t uxLevel, uxSlot;
+
+                for (uxLevel = 0U; uxLevel < tmrWHEEL_LEVELS; uxLevel++) {
+                    for (uxSlot = 0U; uxSlot < tmrWHEEL_SLOTS; uxSlot++) {
+                        vListInitialise(&(xTimerWheel[ uxLevel ][ uxSlot ]));
+                    }
+                    ulTimerWheelSlotsInUse[ uxLevel ] = 0U;
+                }
+                xTimerWheelTime = xTaskGetTickCount();
+            }
+#else
+            {
+                vListInitialise(&xActiveTimerList1);
+                vListInitialise(&xActiveTimerList2);
+                pxCurrentTimerList = &xActiveTimerList1;
+                pxOverflowTimerList = &xActiveTimerList2;
+            }
+#endif /* configUSE_TIMER_WHEEL */
 
 #if( configSUPPORT_STATIC_ALLOCATION == 1 )
             {
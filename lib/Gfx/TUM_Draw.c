@@ -23,6 +23,7 @@
  */
 #include <limits.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #include <SDL2/SDL.h>
@@ -31,6 +32,8 @@
 
 #include <pthread.h>
 
+#include "FreeRTOS.h"
+
 #include "TUM_Draw.h"
 #include "TUM_Font.h"
 #include "TUM_Utils.h"
@@ -290,10 +293,23 @@ void setErrorMessage(char *msg)
     PRINT_ERROR("[SDL Error] %s\n" #msg, (char *)SDL_GetError(),           \
                 ##__VA_ARGS__)
 
+/* Draw jobs come and go with every draw call, the FreeRTOS heap serves them
+ * from its size classes */
+static void *allocDrawJobMemory(size_t size)
+{
+    void *ret = pvPortMalloc(size);
+
+    if (ret) {
+        memset(ret, 0, size);
+    }
+
+    return ret;
+}
+
 static draw_job_t *pushDrawJob(void)
 {
     draw_job_t *iterator;
-    draw_job_t *job = calloc(1, sizeof(draw_job_t));
+    draw_job_t *job = allocDrawJobMemory(sizeof(draw_job_t));
     if (job == NULL) {
         return NULL;
     }
@@ -900,7 +916,7 @@ static int vHandleDrawJob(draw_job_t *job)
         default:
             break;
     }
-    free(job->data);
+    vPortFree(job->data);
 
     return ret;
 }
@@ -909,7 +925,7 @@ static int vHandleDrawJob(draw_job_t *job)
     draw_job_t *JOB = pushDrawJob();                                       \
     if (!JOB)                                                              \
         return -1;                                                     \
-    union data_u *data = calloc(1, sizeof(union data_u));                  \
+    union data_u *data = allocDrawJobMemory(sizeof(union data_u));         \
     if (data == NULL)                                                      \
         logCriticalError("job->data alloc");                           \
     JOB->data = data;                                                      \
@@ -982,7 +998,7 @@ int tumDrawUpdateScreen(void)
         if (vHandleDrawJob(tmp_job) == -1) {
             goto draw_error;
         }
-        free(tmp_job);
+        vPortFree(tmp_job);
     }
 
     SDL_RenderPresent(renderer);
@@ -990,7 +1006,7 @@ int tumDrawUpdateScreen(void)
     return 0;
 
 draw_error:
-    free(tmp_job);
+    vPortFree(tmp_job);
 err:
     return -1;
 }
@@ -1256,7 +1272,7 @@ int tumDrawClear(unsigned int colour)
 {
     /** INIT_JOB(job, DRAW_CLEAR); */
     draw_job_t *job = pushDrawJob();
-    union data_u *data = calloc(1, sizeof(union data_u));
+    union data_u *data = allocDrawJobMemory(sizeof(union data_u));
     if (data == NULL) {
         logCriticalError("job->data alloc");
     }
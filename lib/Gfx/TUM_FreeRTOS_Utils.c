@@ -50,7 +50,7 @@ void tumFUtilPrintTaskStateList(void)
     vPortFree(print_buf);
 }
 
-#define UTIL_LIST_HEADER ("NAME              RUN TIME  \%\n")
+#define UTIL_LIST_HEADER ("NAME                     RUN TIME  \%\n")
 
 void tumFUtilPrintTaskUtils(void)
 {
@@ -61,7 +61,7 @@ void tumFUtilPrintTaskUtils(void)
 
     char *buff_head = buff;
     volatile UBaseType_t num_tasks = uxTaskGetNumberOfTasks(), x;
-    unsigned int ulTotalRunTime;
+    configRUN_TIME_COUNTER_TYPE ulTotalRunTime;
     float ulStatsAsPercentage;
 
     TaskStatus_t *status_list = (TaskStatus_t *)pvPortMalloc(
@@ -86,15 +86,15 @@ void tumFUtilPrintTaskUtils(void)
                                   (float)ulTotalRunTime * 100.0;
 
             if (ulStatsAsPercentage > 0UL) {
-                sprintf(buff, "%-20s %5u  %.2f\n",
+                sprintf(buff, "%-20s %12llu  %.2f\n",
                         status_list[x].pcTaskName,
-                        status_list[x].ulRunTimeCounter,
+                        (unsigned long long)status_list[x].ulRunTimeCounter,
                         ulStatsAsPercentage);
             }
             else {
-                sprintf(buff, "%-20s %5u\n",
+                sprintf(buff, "%-20s %12llu\n",
                         status_list[x].pcTaskName,
-                        status_list[x].ulRunTimeCounter);
+                        (unsigned long long)status_list[x].ulRunTimeCounter);
             }
 
             buff += strlen((char *)buff);
@@ -109,3 +109,47 @@ err_inval_status_num:
 
     return;
 }
+
+/* heap_3.c does not provide it */
+extern void vPortGetHeapStats(HeapStats_t *pxHeapStats) __attribute__((weak));
+
+void tumFUtilPrintHeapStats(void)
+{
+    HeapStats_t stats;
+    unsigned int bucket;
+
+    if (vPortGetHeapStats == NULL) {
+        printf("Heap statistics not supported by this heap\n");
+        return;
+    }
+
+    vPortGetHeapStats(&stats);
+
+    printf("HEAP  free %zu B  minimum ever %zu B  largest block %zu B\n",
+           stats.xAvailableHeapSpaceInBytes,
+           stats.xMinimumEverFreeBytesRemaining,
+           stats.xSizeOfLargestFreeBlockInBytes);
+    printf("      %zu allocations  %zu frees  %zu free blocks\n",
+           stats.xNumberOfSuccessfulAllocations,
+           stats.xNumberOfSuccessfulFrees, stats.xNumberOfFreeBlocks);
+
+    if (!stats.xNumberOfFreeBlocks) {
+        return;
+    }
+
+    printf("FREE BLOCK SIZE      COUNT\n");
+    for (bucket = 0; bucket < portHEAP_HISTOGRAM_BUCKETS; bucket++) {
+        if (!stats.xFreeBlockHistogram[bucket]) {
+            continue;
+        }
+        if (bucket == portHEAP_HISTOGRAM_BUCKETS - 1) {
+            printf(">= %-15zu  %zu\n", (size_t)16 << bucket,
+                   stats.xFreeBlockHistogram[bucket]);
+        }
+        else {
+            printf("<  %-15zu  %zu\n", (size_t)32 << bucket,
+                   stats.xFreeBlockHistogram[bucket]);
+        }
+    }
+    printf("\n");
+}
@@ -0,0 +1,329 @@
+/**
+ * @file TUM_Draw.c
+ * @brief Headless TUM Draw, accepts every draw call and renders nothing so that applications run unchanged without a display
+ *
+ * @verbatim
+ ----------------------------------------------------------------------
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ----------------------------------------------------------------------
+ @endverbatim
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "TUM_Draw.h"
+#include "TUM_Font.h"
+#include "TUM_Utils.h"
+
+typedef struct loaded_image {
+    float scale;
+} loaded_image_t;
+
+/* Spritesheets, animations and sequences are never dereferenced */
+static char headless_handle;
+
+static char error_message[] = "Drawing is not available in headless builds";
+
+static int global_x_offset = 0;
+static int global_y_offset = 0;
+
+char *tumGetErrorMessage(void)
+{
+    return error_message;
+}
+
+int tumDrawInit(char *path)
+{
+    if (tumFontInit(path)) {
+        PRINT_ERROR("TUM Font init failed");
+        return -1;
+    }
+
+    tumDrawBindThread();
+
+    return 0;
+}
+
+int tumDrawBindThread(void)
+{
+    tumUtilSetGLThread();
+
+    return 0;
+}
+
+void tumDrawExit(void)
+{
+    tumFontExit();
+
+    exit(EXIT_SUCCESS);
+}
+
+int tumDrawUpdateScreen(void)
+{
+    return 0;
+}
+
+int tumDrawClear(unsigned int colour)
+{
+    return 0;
+}
+
+void tumDrawDuplicateBuffer(void)
+{
+}
+
+int tumDrawEllipse(signed short x, signed short y, signed short rx,
+                   signed short ry, unsigned int colour)
+{
+    return 0;
+}
+
+int tumDrawArc(signed short x, signed short y, signed short radius,
+               signed short start, signed short end, unsigned int colour)
+{
+    return 0;
+}
+
+int tumDrawText(char *str, signed short x, signed short y, unsigned int colour)
+{
+    return 0;
+}
+
+/* Approximated from the font size, as if every glyph were half as wide as high */
+int tumGetTextSize(char *str, int *width, int *height)
+{
+    ssize_t size = tumFontGetCurFontSize();
+
+    if (str == NULL) {
+        return -1;
+    }
+
+    if (width) {
+        *width = strlen(str) * size / 2;
+    }
+    if (height) {
+        *height = size;
+    }
+
+    return 0;
+}
+
+int tumDrawBox(signed short x, signed short y, signed short w, signed short h,
+               unsigned int colour)
+{
+    return 0;
+}
+
+int tumDrawFilledBox(signed short x, signed short y, signed short w,
+                     signed short h, unsigned int colour)
+{
+    return 0;
+}
+
+int tumDrawCircle(signed short x, signed short y, signed short radius,
+                  unsigned int colour)
+{
+    return 0;
+}
+
+int tumDrawLine(signed short x1, signed short y1, signed short x2,
+                signed short y2, unsigned char thickness, unsigned int colour)
+{
+    return 0;
+}
+
+int tumDrawPoly(coord_t *points, int n, unsigned int colour)
+{
+    return 0;
+}
+
+int tumDrawTriangle(coord_t *points, unsigned int colour)
+{
+    return 0;
+}
+
+image_handle_t tumDrawLoadScaledImage(char *filename, float scale)
+{
+    loaded_image_t *img = calloc(1, sizeof(loaded_image_t));
+
+    if (img == NULL) {
+        PRINT_ERROR("Failed to allocate image '%s'", filename);
+        return NULL;
+    }
+
+    img->scale = scale;
+
+    return img;
+}
+
+image_handle_t tumDrawLoadImage(char *filename)
+{
+    return tumDrawLoadScaledImage(filename, 1);
+}
+
+int tumDrawFreeLoadedImage(image_handle_t *img)
+{
+    if (img == NULL) {
+        return -1;
+    }
+
+    free(*img);
+    *img = NULL;
+
+    return 0;
+}
+
+int tumDrawLoadedImage(image_handle_t img, signed short x, signed short y)
+{
+    return img ? 0 : -1;
+}
+
+int tumDrawSetLoadedImageScale(image_handle_t img, float scale)
+{
+    if (img == NULL) {
+        return -1;
+    }
+
+    ((loaded_image_t *)img)->scale = scale;
+
+    return 0;
+}
+
+float tumDrawGetLoadedImageScale(image_handle_t img)
+{
+    return img ? ((loaded_image_t *)img)->scale : -1;
+}
+
+int tumDrawGetLoadedImageWidth(image_handle_t img)
+{
+    return img ? 0 : -1;
+}
+
+int tumDrawGetLoadedImageHeight(image_handle_t img)
+{
+    return img ? 0 : -1;
+}
+
+int tumDrawGetLoadedImageSize(image_handle_t img, int *w, int *h)
+{
+    if (img == NULL || w == NULL || h == NULL) {
+        return -1;
+    }
+
+    *w = 0;
+    *h = 0;
+
+    return 0;
+}
+
+int tumDrawImage(char *filename, signed short x, signed short y)
+{
+    return 0;
+}
+
+spritesheet_handle_t tumDrawLoadSpritesheet(image_handle_t img,
+        unsigned sprite_cols,
+        unsigned sprite_rows)
+{
+    return img ? &headless_handle : NULL;
+}
+
+int tumDrawSprite(spritesheet_handle_t spritesheet, char column, char row,
+                  signed short x, signed short y)
+{
+    return spritesheet ? 0 : -1;
+}
+
+int tumGetImageSize(char *filename, int *w, int *h)
+{
+    if (w == NULL || h == NULL) {
+        return -1;
+    }
+
+    *w = 0;
+    *h = 0;
+
+    return 0;
+}
+
+int tumDrawScaledImage(char *filename, signed short x, signed short y,
+                       float scale)
+{
+    return 0;
+}
+
+int tumDrawArrow(signed short x1, signed short y1, signed short x2,
+                 signed short y2, signed short head_length,
+                 unsigned char thickness, unsigned int colour)
+{
+    return 0;
+}
+
+animation_handle_t tumDrawAnimationCreate(spritesheet_handle_t spritesheet)
+{
+    return spritesheet ? &headless_handle : NULL;
+}
+
+int tumDrawAnimationAddSequence(animation_handle_t animation, char *name,
+                                unsigned start_row, unsigned start_col,
+                                enum sprite_sequence_direction sprite_step_direction,
+                                unsigned frames)
+{
+    return animation && name ? 0 : -1;
+}
+
+sequence_handle_t
+tumDrawAnimationSequenceInstantiate(animation_handle_t animation,
+                                    char *sequence_name,
+                                    unsigned frame_period_ms)
+{
+    return animation && sequence_name ? &headless_handle : NULL;
+}
+
+int tumDrawAnimationDrawFrame(sequence_handle_t sequence, unsigned ms_timestep,
+                              int x, int y)
+{
+    return sequence ? 0 : -1;
+}
+
+int tumDrawSetGlobalXOffset(int offset)
+{
+    global_x_offset = offset;
+    return 0;
+}
+
+int tumDrawSetGlobalYOffset(int offset)
+{
+    global_y_offset = offset;
+    return 0;
+}
+
+int tumDrawGetGlobalXOffset(int *offset)
+{
+    if (offset == NULL) {
+        return -1;
+    }
+
+    *offset = global_x_offset;
+    return 0;
+}
+
+int tumDrawGetGlobalYOffset(int *offset)
+{
+    if (offset == NULL) {
+        return -1;
+    }
+
+    *offset = global_y_offset;
+    return 0;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file TUM_Event.c
+ * @brief Headless TUM Event, there is no input device so the button table and the mouse stay at rest
+ *
+ * @verbatim
+ ----------------------------------------------------------------------
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ----------------------------------------------------------------------
+ @endverbatim
+ */
+
+#include "TUM_Event.h"
+
+#include "TUM_Utils.h"
+
+QueueHandle_t buttonInputQueue = NULL;
+
+int tumEventFetchEvents(int flags)
+{
+    if (!(flags & FETCH_EVENT_NO_GL_CHECK) && tumUtilIsCurGLThread()) {
+        PRINT_ERROR("Fetching events from task that does not hold GL context");
+        return -1;
+    }
+
+    return 0;
+}
+
+signed short tumEventGetMouseX(void)
+{
+    return 0;
+}
+
+signed short tumEventGetMouseY(void)
+{
+    return 0;
+}
+
+signed char tumEventGetMouseLeft(void)
+{
+    return 0;
+}
+
+signed char tumEventGetMouseRight(void)
+{
+    return 0;
+}
+
+signed char tumEventGetMouseMiddle(void)
+{
+    return 0;
+}
+
+int tumEventInit(void)
+{
+    buttonInputQueue =
+        xQueueCreate(1, sizeof(unsigned char) * SDL_NUM_SCANCODES);
+
+    if (!buttonInputQueue) {
+        PRINT_ERROR("Creating button queue failed");
+        return -1;
+    }
+
+    return 0;
+}
+
+void tumEventExit(void)
+{
+    vQueueDelete(buttonInputQueue);
+}
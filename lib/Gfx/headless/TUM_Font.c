@@ -0,0 +1,170 @@
+/**
+ * @file TUM_Font.c
+ * @brief Headless TUM Font, keeps the name and size bookkeeping without loading any TTF files
+ *
+ * @verbatim
+ ----------------------------------------------------------------------
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ----------------------------------------------------------------------
+ @endverbatim
+ */
+
+#include <pthread.h>
+#include <string.h>
+
+#include "TUM_Font.h"
+
+#define MAX_FONTS 16
+
+typedef struct tum_font {
+    char name[MAX_FONT_NAME_LENGTH];
+    ssize_t size;
+} tum_font_t;
+
+static pthread_mutex_t list_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct tum_font font_list[MAX_FONTS];
+static unsigned int font_count = 0;
+static struct tum_font *cur_default_font = NULL;
+
+static struct tum_font *tumFontAppendFont(char *font_name, ssize_t size)
+{
+    struct tum_font *font;
+
+    if (font_count == MAX_FONTS) {
+        return NULL;
+    }
+
+    font = &font_list[font_count++];
+    strncpy(font->name, font_name, sizeof(font->name) - 1);
+    font->size = size;
+
+    return font;
+}
+
+int tumFontInit(char *path)
+{
+    pthread_mutex_lock(&list_lock);
+    cur_default_font = tumFontAppendFont(DEFAULT_FONT, DEFAULT_FONT_SIZE);
+    pthread_mutex_unlock(&list_lock);
+
+    return 0;
+}
+
+void tumFontExit(void)
+{
+    pthread_mutex_lock(&list_lock);
+    font_count = 0;
+    cur_default_font = NULL;
+    pthread_mutex_unlock(&list_lock);
+}
+
+void tumFontPutFontHandle(font_handle_t font)
+{
+}
+
+void tumFontPutFont(TTF_Font *font)
+{
+}
+
+TTF_Font *tumFontGetCurFont(void)
+{
+    return NULL;
+}
+
+ssize_t tumFontGetCurFontSize(void)
+{
+    pthread_mutex_lock(&list_lock);
+    ssize_t ret = cur_default_font ? cur_default_font->size : 0;
+    pthread_mutex_unlock(&list_lock);
+    return ret;
+}
+
+char *tumFontGetCurFontName(void)
+{
+    pthread_mutex_lock(&list_lock);
+    char *ret = cur_default_font ? strdup(cur_default_font->name) : NULL;
+    pthread_mutex_unlock(&list_lock);
+    return ret;
+}
+
+font_handle_t tumFontGetCurFontHandle(void)
+{
+    pthread_mutex_lock(&list_lock);
+    font_handle_t ret = cur_default_font;
+    pthread_mutex_unlock(&list_lock);
+    return ret;
+}
+
+int tumFontLoadFont(char *font_name, ssize_t size)
+{
+    int ret = 0;
+
+    pthread_mutex_lock(&list_lock);
+
+    if (tumFontAppendFont(font_name, (size) ? size : DEFAULT_FONT_SIZE) ==
+        NULL) {
+        ret = -1;
+    }
+
+    pthread_mutex_unlock(&list_lock);
+
+    return ret;
+}
+
+int tumFontSelectFontFromName(char *font_name)
+{
+    unsigned int i;
+
+    pthread_mutex_lock(&list_lock);
+
+    for (i = 0; i < font_count; i++)
+        if (!strcmp(font_list[i].name, font_name)) {
+            cur_default_font = &font_list[i];
+            pthread_mutex_unlock(&list_lock);
+            return 0;
+        }
+
+    pthread_mutex_unlock(&list_lock);
+
+    return -1;
+}
+
+int tumFontSelectFontFromHandle(font_handle_t font_handle)
+{
+    unsigned int i;
+
+    pthread_mutex_lock(&list_lock);
+
+    for (i = 0; i < font_count; i++)
+        if (&font_list[i] == font_handle) {
+            cur_default_font = &font_list[i];
+            pthread_mutex_unlock(&list_lock);
+            return 0;
+        }
+
+    pthread_mutex_unlock(&list_lock);
+
+    return -1;
+}
+
+int tumFontSetSize(ssize_t font_size)
+{
+    if (cur_default_font == NULL) {
+        return -1;
+    }
+
+    pthread_mutex_lock(&list_lock);
+    cur_default_font->size = font_size;
+    pthread_mutex_unlock(&list_lock);
+
+    return 0;
+}
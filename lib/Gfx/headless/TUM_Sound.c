@@ -0,0 +1,44 @@
+/**
+ * @file TUM_Sound.c
+ * @brief Headless TUM Sound, there is no audio device so samples are dropped
+ *
+ * @verbatim
+ ----------------------------------------------------------------------
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ----------------------------------------------------------------------
+ @endverbatim
+ */
+
+#include "TUM_Sound.h"
+
+int tumSoundInit(char *bin_dir_str)
+{
+    return 0;
+}
+
+void tumSoundExit(void)
+{
+}
+
+void tumSoundPlaySample(unsigned char index)
+{
+}
+
+int tumSoundLoadUserSample(const char *filepath)
+{
+    return -1;
+}
+
+int tumSoundPlayUserSample(const char *filename)
+{
+    return -1;
+}
@@ -27,6 +27,32 @@
 #include "FreeRTOS.h"
 #include "queue.h"
 
+#ifdef HEADLESS
+/* The subset of SDL_scancode.h used as button table indices, with the same
+ * (USB HID usage) values so that the table layout does not change */
+#define SDL_NUM_SCANCODES 512
+
+typedef enum {
+    SDL_SCANCODE_UNKNOWN = 0,
+    SDL_SCANCODE_A = 4, SDL_SCANCODE_B, SDL_SCANCODE_C, SDL_SCANCODE_D,
+    SDL_SCANCODE_E, SDL_SCANCODE_F, SDL_SCANCODE_G, SDL_SCANCODE_H,
+    SDL_SCANCODE_I, SDL_SCANCODE_J, SDL_SCANCODE_K, SDL_SCANCODE_L,
+    SDL_SCANCODE_M, SDL_SCANCODE_N, SDL_SCANCODE_O, SDL_SCANCODE_P,
+    SDL_SCANCODE_Q, SDL_SCANCODE_R, SDL_SCANCODE_S, SDL_SCANCODE_T,
+    SDL_SCANCODE_U, SDL_SCANCODE_V, SDL_SCANCODE_W, SDL_SCANCODE_X,
+    SDL_SCANCODE_Y, SDL_SCANCODE_Z,
+    SDL_SCANCODE_1, SDL_SCANCODE_2, SDL_SCANCODE_3, SDL_SCANCODE_4,
+    SDL_SCANCODE_5, SDL_SCANCODE_6, SDL_SCANCODE_7, SDL_SCANCODE_8,
+    SDL_SCANCODE_9, SDL_SCANCODE_0,
+    SDL_SCANCODE_RETURN, SDL_SCANCODE_ESCAPE, SDL_SCANCODE_BACKSPACE,
+    SDL_SCANCODE_TAB, SDL_SCANCODE_SPACE,
+    SDL_SCANCODE_RIGHT = 79, SDL_SCANCODE_LEFT, SDL_SCANCODE_DOWN,
+    SDL_SCANCODE_UP,
+} SDL_Scancode;
+#else
+#include <SDL2/SDL_scancode.h>
+#endif //HEADLESS
+
 /**
  * @defgroup tum_event TUM Event API
  *
@@ -25,7 +25,14 @@
 #ifndef __TUM_FONT_H__
 #define __TUM_FONT_H__
 
+#ifdef HEADLESS
+#include <sys/types.h>
+
+/* Only ever handled by reference, the headless build has no SDL2 TTF */
+typedef struct _TTF_Font TTF_Font;
+#else
 #include <SDL2/SDL_ttf.h>
+#endif //HEADLESS
 
 #include "EmulatorConfig.h"
 
@@ -47,5 +47,15 @@ void tumFUtilPrintTaskStateList(void);
  */
 void tumFUtilPrintTaskUtils(void);
 
+/**
+ * @brief Prints the state of the FreeRTOS heap and a histogram of its free
+ * blocks by size
+ *
+ * The histogram shows how fragmented the heap is, the largest free block is
+ * the largest allocation that can still succeed. Needs a heap implementing
+ * vPortGetHeapStats(), see FREERTOS_HEAP.
+ */
+void tumFUtilPrintHeapStats(void);
+
 /** @} */
 #endif // __TUM__FREERTOS_UTILS_H__
@@ -61,7 +61,8 @@
 #define SAFE_PRINT_MAX_MSG_LEN 256
 #endif // SAFE_PRINT_QUEUE_LEN
 #ifndef SAFE_PRINT_STACK_SIZE
-#define SAFE_PRINT_STACK_SIZE (SAFE_PRINT_MAX_MSG_LEN * 2)
+// Printing to an unbuffered stream puts a BUFSIZ sized buffer on the stack
+#define SAFE_PRINT_STACK_SIZE (configMINIMAL_STACK_SIZE * 2 + SAFE_PRINT_MAX_MSG_LEN)
 #endif // SAFE_PRINT_STACK_SIZE
 #ifndef SAFE_PRINT_PRIORITY
 #define SAFE_PRINT_PRIORITY tskIDLE_PRIORITY
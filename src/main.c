@@ -1,8 +1,7 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
-
-#include <SDL2/SDL_scancode.h>
+#include <string.h>
 
 #include "FreeRTOS.h"
 #include "queue.h"
@@ -21,7 +20,7 @@
 #include "AsyncIO.h"
 
 #define mainGENERIC_PRIORITY (tskIDLE_PRIORITY)
-#define mainGENERIC_STACK_SIZE ((unsigned short)2560)
+#define mainGENERIC_STACK_SIZE ((unsigned short)8192)
 
 #define STATE_QUEUE_LENGTH 1
 
@@ -730,17 +729,20 @@ int main(int argc, char *argv[])
         PRINT_ERROR("Failed to create buttons lock");
         goto err_buttons_lock;
     }
+    vQueueAddToRegistry(buttons.lock, "ButtonsLock");
 
     DrawSignal = xSemaphoreCreateBinary(); // Screen buffer locking
     if (!DrawSignal) {
         PRINT_ERROR("Failed to create draw signal");
         goto err_draw_signal;
     }
+    vQueueAddToRegistry(DrawSignal, "DrawSignal");
     ScreenLock = xSemaphoreCreateMutex();
     if (!ScreenLock) {
         PRINT_ERROR("Failed to create screen lock");
         goto err_screen_lock;
     }
+    vQueueAddToRegistry(ScreenLock, "ScreenLock");
 
     // Message sending
     StateQueue = xQueueCreate(STATE_QUEUE_LENGTH, sizeof(unsigned char));
@@ -748,6 +750,7 @@ int main(int argc, char *argv[])
         PRINT_ERROR("Could not open state queue");
         goto err_state_queue;
     }
+    vQueueAddToRegistry(StateQueue, "StateQueue");
 
     if (xTaskCreate(basicSequentialStateMachine, "StateMachine",
                     mainGENERIC_STACK_SIZE * 2, NULL,
@@ -821,12 +824,6 @@ err_init_safe_print:
     return EXIT_FAILURE;
 }
 
-// cppcheck-suppress unusedFunction
-__attribute__((unused)) void vMainQueueSendPassed(void)
-{
-    /* This is just an example implementation of the "queue send" trace hook. */
-}
-
 // cppcheck-suppress unusedFunction
 __attribute__((unused)) void vApplicationIdleHook(void)
 {
@@ -838,3 +835,11 @@ __attribute__((unused)) void vApplicationIdleHook(void)
     nanosleep(&xTimeToSleep, &xTimeSlept);
 #endif
 }
+
+// cppcheck-suppress unusedFunction
+__attribute__((unused)) void vApplicationStackOverflowHook(TaskHandle_t xTask,
+        char *pcTaskName)
+{
+    fprintf(stderr, "[ERROR] Task %s overflowed its stack\n", pcTaskName);
+    exit(EXIT_FAILURE);
+}